@@ -0,0 +1,105 @@
+// Band interleave / deinterleave throughput: the per-sample memcpy loop
+// interleave_bands used before vs the dispatched transpose kernels in
+// src/raster/band_interleave.cpp. Also checks both give identical bytes.
+//
+// Build and run from the repository root:
+//   c++ -O2 -std=c++17 -Isrc/include benchmark/interleave_bench.cpp
+//       src/raster/band_interleave.cpp -o interleave_bench && ./interleave_bench
+//
+// GB/s counts the BIP bytes produced (interleave) or read (deinterleave of
+// every band) per second.
+
+#include "band_interleave.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using duckdb::raquet::deinterleave_planes;
+using duckdb::raquet::interleave_kernel_isa;
+using duckdb::raquet::interleave_planes;
+
+static void ReferenceInterleave(const uint8_t *const *planes, size_t num_bands, size_t num_pixels,
+                                size_t elem_size, uint8_t *dst) {
+    for (size_t pixel = 0; pixel < num_pixels; pixel++) {
+        for (size_t band = 0; band < num_bands; band++) {
+            std::memcpy(dst + (pixel * num_bands + band) * elem_size, planes[band] + pixel * elem_size, elem_size);
+        }
+    }
+}
+
+static void ReferenceDeinterleave(const uint8_t *src, size_t num_bands, size_t num_pixels, size_t elem_size,
+                                  uint8_t *const *planes) {
+    for (size_t band = 0; band < num_bands; band++) {
+        for (size_t pixel = 0; pixel < num_pixels; pixel++) {
+            std::memcpy(planes[band] + pixel * elem_size, src + (pixel * num_bands + band) * elem_size, elem_size);
+        }
+    }
+}
+
+template <typename F>
+static double GigabytesPerSecond(size_t bytes, F &&run) {
+    run();  // warm-up
+    int iterations = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed = 0.0;
+    do {
+        run();
+        iterations++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < 0.3);
+    return static_cast<double>(bytes) * iterations / elapsed / 1e9;
+}
+
+int main() {
+    // One 256x256 tile (plus an odd tail) per call, as in ingestion
+    const size_t num_pixels = 256 * 256 + 7;
+    std::mt19937 rng(42);
+    bool all_match = true;
+
+    printf("kernel: %s\n", interleave_kernel_isa());
+    printf("%-6s %-5s %14s %14s %16s %16s\n", "bands", "elem", "ref interleave", "interleave", "ref deinterleave",
+           "deinterleave");
+
+    for (size_t elem_size : {1, 2, 4}) {
+        for (size_t num_bands : {2, 3, 4}) {
+            std::vector<std::vector<uint8_t>> planes(num_bands, std::vector<uint8_t>(num_pixels * elem_size));
+            std::vector<const uint8_t *> plane_ptrs;
+            for (auto &plane : planes) {
+                for (auto &byte : plane) byte = static_cast<uint8_t>(rng());
+                plane_ptrs.push_back(plane.data());
+            }
+            size_t bytes = num_bands * num_pixels * elem_size;
+            std::vector<uint8_t> expected(bytes), actual(bytes);
+
+            ReferenceInterleave(plane_ptrs.data(), num_bands, num_pixels, elem_size, expected.data());
+            interleave_planes(plane_ptrs.data(), num_bands, num_pixels, elem_size, actual.data());
+            bool match = expected == actual;
+
+            std::vector<std::vector<uint8_t>> out(num_bands, std::vector<uint8_t>(num_pixels * elem_size));
+            std::vector<uint8_t *> out_ptrs;
+            for (auto &plane : out) out_ptrs.push_back(plane.data());
+            deinterleave_planes(expected.data(), num_bands, num_pixels, elem_size, out_ptrs.data());
+            match = match && out == planes;
+            all_match = all_match && match;
+
+            double ref_in = GigabytesPerSecond(bytes, [&] {
+                ReferenceInterleave(plane_ptrs.data(), num_bands, num_pixels, elem_size, actual.data());
+            });
+            double fast_in = GigabytesPerSecond(bytes, [&] {
+                interleave_planes(plane_ptrs.data(), num_bands, num_pixels, elem_size, actual.data());
+            });
+            double ref_out = GigabytesPerSecond(bytes, [&] {
+                ReferenceDeinterleave(expected.data(), num_bands, num_pixels, elem_size, out_ptrs.data());
+            });
+            double fast_out = GigabytesPerSecond(bytes, [&] {
+                deinterleave_planes(expected.data(), num_bands, num_pixels, elem_size, out_ptrs.data());
+            });
+            printf("%-6zu %-5zu %10.2f GB/s %10.2f GB/s %12.2f GB/s %12.2f GB/s%s\n", num_bands, elem_size, ref_in,
+                   fast_in, ref_out, fast_out, match ? "" : "  MISMATCH");
+        }
+    }
+    return all_match ? 0 : 1;
+}
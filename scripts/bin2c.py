@@ -1,20 +1,31 @@
 #!/usr/bin/env python3
-"""Convert a binary file to a C array (replacement for xxd -i)."""
+"""Convert a binary file to a C array (replacement for xxd -i).
+
+With --deflate the array holds the zlib-compressed bytes and an extra
+<name>_raw_len gives the inflated size.
+"""
 import sys
 import os
+import zlib
 
 def main():
-    if len(sys.argv) != 3:
-        print(f"Usage: {sys.argv[0]} <input_file> <output_file>", file=sys.stderr)
+    args = sys.argv[1:]
+    deflate = '--deflate' in args
+    args = [a for a in args if a != '--deflate']
+    if len(args) != 2:
+        print(f"Usage: {sys.argv[0]} [--deflate] <input_file> <output_file>", file=sys.stderr)
         sys.exit(1)
 
-    input_file = sys.argv[1]
-    output_file = sys.argv[2]
+    input_file = args[0]
+    output_file = args[1]
 
     var_name = os.path.basename(input_file).replace('.', '_')
 
     with open(input_file, 'rb') as f:
         data = f.read()
+    raw_len = len(data)
+    if deflate:
+        data = zlib.compress(data, 9)
 
     with open(output_file, 'w') as f:
         f.write(f'unsigned char {var_name}[] = {{\n')
@@ -26,8 +37,13 @@ def main():
             f.write(f'  {line}\n')
         f.write('};\n')
         f.write(f'unsigned int {var_name}_len = {len(data)};\n')
+        if deflate:
+            f.write(f'unsigned int {var_name}_raw_len = {raw_len};\n')
 
-    print(f"Generated {output_file} ({len(data)} bytes)")
+    if deflate:
+        print(f"Generated {output_file} ({raw_len} bytes, {len(data)} deflated)")
+    else:
+        print(f"Generated {output_file} ({len(data)} bytes)")
 
 if __name__ == '__main__':
     main()
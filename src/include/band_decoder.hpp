@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <cstring>
@@ -23,7 +24,12 @@ enum class BandDataType {
     INT64,
     FLOAT16,  // new in v0.3.0 for ML/inference use cases
     FLOAT32,
-    FLOAT64
+    FLOAT64,
+    // Bit-packed in storage (masks, flags); decoders expand them to one byte
+    // per pixel, so everything past decode_band_bytes sees them as uint8.
+    UINT1,
+    UINT2,
+    UINT4
 };
 
 // Parse data type from string
@@ -39,14 +45,20 @@ inline BandDataType parse_dtype(const std::string &dtype) {
     if (dtype == "float16") return BandDataType::FLOAT16;
     if (dtype == "float32") return BandDataType::FLOAT32;
     if (dtype == "float64") return BandDataType::FLOAT64;
+    if (dtype == "uint1") return BandDataType::UINT1;
+    if (dtype == "uint2") return BandDataType::UINT2;
+    if (dtype == "uint4") return BandDataType::UINT4;
     throw std::invalid_argument("Unknown data type: " + dtype);
 }
 
-// Get byte size for data type
+// Get byte size for data type (of the decoded pixel: 1 for bit-packed types)
 inline size_t dtype_size(BandDataType dtype) {
     switch (dtype) {
         case BandDataType::UINT8:
         case BandDataType::INT8:
+        case BandDataType::UINT1:
+        case BandDataType::UINT2:
+        case BandDataType::UINT4:
             return 1;
         case BandDataType::UINT16:
         case BandDataType::INT16:
@@ -64,6 +76,21 @@ inline size_t dtype_size(BandDataType dtype) {
     return 0;
 }
 
+// Bits per pixel of a bit-packed type name ("uint1", "uint2", "uint4"), 0 for
+// any other type
+inline int packed_bits_of(const std::string &dtype) {
+    if (dtype == "uint1") return 1;
+    if (dtype == "uint2") return 2;
+    if (dtype == "uint4") return 4;
+    return 0;
+}
+
+// Bytes per row of `width` pixels packed `bits` wide. Rows start on a byte
+// boundary and fill each byte from its most significant bit, as TIFF NBITS.
+inline size_t packed_row_bytes(int width, int bits) {
+    return (static_cast<size_t>(width) * bits + 7) / 8;
+}
+
 // Convert IEEE 754 half-precision (float16) to double
 // Format: 1 sign bit, 5 exponent bits (bias 15), 10 mantissa bits
 inline double float16_to_double(uint16_t h) {
@@ -96,8 +123,263 @@ inline double float16_to_double(uint16_t h) {
     }
 }
 
-// Decompress gzip data
-std::vector<uint8_t> decompress_gzip(const uint8_t *data, size_t size);
+// Decompress gzip data. Streams written with a preset dictionary (read_raster
+// dictionary_size) need the same bytes passed as `dictionary`.
+std::vector<uint8_t> decompress_gzip(const uint8_t *data, size_t size,
+                                     const std::vector<uint8_t> *dictionary = nullptr);
+
+// Decompress a Zstandard frame (requires RAQUET_HAS_ZSTD). Frames declaring
+// more than `max_size` bytes (the expected tile size) are rejected before
+// anything is allocated.
+std::vector<uint8_t> decompress_zstd(const uint8_t *data, size_t size, size_t max_size);
+
+// Decompress an LZ4 frame (requires RAQUET_HAS_LZ4), rejecting frames that
+// declare or inflate to more than `max_size` bytes.
+std::vector<uint8_t> decompress_lz4(const uint8_t *data, size_t size, size_t max_size);
+
+// How a non-image band blob was encoded: the byte codec ("gzip", "zstd",
+// "lz4" or "none") plus the TIFF-style predictor applied before it
+// (1 = none, 2 = horizontal differencing, 3 = floating point). Built once per
+// tile from metadata and passed to every decode site so new codecs only need
+// wiring here.
+struct BandCodec {
+    std::string compression = "none";
+    int predictor = 1;
+
+    BandCodec() = default;
+    BandCodec(const std::string &compression_p, int predictor_p = 1)
+        : compression(compression_p.empty() ? "none" : compression_p), predictor(predictor_p) {}
+
+    // Pre-codec call sites only knew "gzip or raw"
+    static BandCodec from_flag(bool compressed) {
+        return BandCodec(compressed ? "gzip" : "none");
+    }
+
+    // Error-bounded quantization (read_raster max_error): the blob stores
+    // unsigned integer codes of `quant_type`; pixel = code * scale + offset,
+    // and `quant_nodata_code` decodes to `quant_nodata`. Empty = not quantized.
+    std::string quant_type;
+    double quant_scale = 1.0;
+    double quant_offset = 0.0;
+    uint64_t quant_nodata_code = 0;
+    double quant_nodata = 0.0;
+
+    bool is_quantized() const {
+        return !quant_type.empty();
+    }
+
+    // Preset deflate dictionary for gzip tiles, shared with the cached
+    // metadata so building a codec per row does not copy it.
+    std::shared_ptr<const std::vector<uint8_t>> dictionary;
+
+    // Original blobs behind this band's tile references (read_raster
+    // dedup), indexed by the reference's dictionary slot.
+    std::shared_ptr<const std::vector<std::vector<uint8_t>>> tile_dictionary;
+
+    // Bit-packed band (uint1/uint2/uint4): rows of `packed_bits`-wide fields,
+    // unpacked to one byte per pixel after the codec and predictor (which
+    // ran on the packed rows) unless `keep_packed` asks for the packed bytes.
+    int packed_bits = 0;
+    bool keep_packed = false;
+
+    // The raster declares constant tiles ("constant_tiles": true); without
+    // it a blob that happens to start with the marker is ordinary data.
+    bool constant_tiles = false;
+
+    // The band is flagged "validity_mask": true, so its blobs may start
+    // with a validity mask (VALIDITY_MASK_MAGIC) to split off first.
+    bool validity_mask = false;
+
+    bool is_raw() const {
+        return compression == "none" && predictor == 1 && !is_quantized() && (packed_bits == 0 || keep_packed);
+    }
+};
+
+// compression='auto': read_raster picks codec, level and predictor per tile.
+// Every band blob other than a constant tile or tile reference then starts
+// with one codec byte, the byte codec (AUTO_CODEC_*) in the low nibble and the
+// predictor (1-3) in the high nibble. Levels need no record to decode.
+constexpr uint8_t AUTO_CODEC_NONE = 0;
+constexpr uint8_t AUTO_CODEC_GZIP = 1;
+constexpr uint8_t AUTO_CODEC_ZSTD = 2;
+constexpr uint8_t AUTO_CODEC_LZ4 = 3;
+
+inline uint8_t auto_codec_byte(const std::string &compression, int predictor) {
+    uint8_t codec;
+    if (compression == "gzip") {
+        codec = AUTO_CODEC_GZIP;
+    } else if (compression == "zstd") {
+        codec = AUTO_CODEC_ZSTD;
+    } else if (compression == "lz4") {
+        codec = AUTO_CODEC_LZ4;
+    } else if (compression == "none") {
+        codec = AUTO_CODEC_NONE;
+    } else {
+        throw std::invalid_argument("No per-tile codec byte for compression: " + compression);
+    }
+    return static_cast<uint8_t>(codec | (predictor << 4));
+}
+
+// The codec of one compression='auto' blob: `base` (quantization and
+// dictionaries of the band) with the byte codec and predictor of its codec byte.
+inline BandCodec auto_tile_codec(uint8_t codec_byte, const BandCodec &base) {
+    static const char *const NAMES[] = {"none", "gzip", "zstd", "lz4"};
+    uint8_t codec = codec_byte & 0x0F;
+    int predictor = codec_byte >> 4;
+    if (codec > AUTO_CODEC_LZ4 || predictor < 1 || predictor > 3) {
+        throw std::invalid_argument("Invalid per-tile codec byte: " + std::to_string(codec_byte));
+    }
+    BandCodec tile_codec = base;
+    tile_codec.compression = NAMES[codec];
+    tile_codec.predictor = predictor;
+    return tile_codec;
+}
+
+// Undo horizontal differencing (predictor=2) in place. Each row of `width`
+// pixels with `samples_per_pixel` interleaved samples of `elem_size` bytes
+// is prefix-summed per sample with wrap-around integer arithmetic.
+void undo_horizontal_predictor(uint8_t *data, size_t size, size_t elem_size,
+                               int width, int samples_per_pixel);
+
+// Undo the floating-point predictor (predictor=3) in place. Each row was
+// stored as byte planes (most significant byte first) with byte-wise
+// horizontal differencing; this re-accumulates the bytes and unshuffles the
+// planes back into little-endian floats (SSE2/NEON where available).
+void undo_float_predictor(uint8_t *data, size_t size, size_t elem_size,
+                          int width, int samples_per_pixel);
+
+// Constant tiles: a band whose pixels all hold one value is written as this
+// 4-byte marker followed by the value in the band's logical type, whatever
+// the raster's compression. None of the codecs' own headers start with it,
+// but raw tiles can, so the marker is only honoured when the metadata
+// declares constant tiles (BandCodec::constant_tiles).
+constexpr uint8_t CONSTANT_TILE_MAGIC[4] = {'R', 'Q', 'C', 0x01};
+constexpr size_t CONSTANT_TILE_HEADER = sizeof(CONSTANT_TILE_MAGIC);
+
+inline bool is_constant_tile(const uint8_t *data, size_t size, size_t elem_size, const BandCodec &codec) {
+    return codec.constant_tiles && data != nullptr && size == CONSTANT_TILE_HEADER + elem_size &&
+           std::memcmp(data, CONSTANT_TILE_MAGIC, CONSTANT_TILE_HEADER) == 0;
+}
+
+// The value bytes of a constant tile (elem_size bytes)
+inline const uint8_t *constant_tile_value(const uint8_t *data) {
+    return data + CONSTANT_TILE_HEADER;
+}
+
+// Expand `height` bit-packed rows to one byte per pixel in `out` (width *
+// height bytes). 1-bit rows unpack 16 pixels per SSE2/NEON step, 2- and 4-bit
+// rows through per-byte lookup tables.
+void unpack_bits(const uint8_t *packed, size_t packed_size, int bits, int width, int height, uint8_t *out);
+
+// Set pixels of a bit-packed 1-bit tile, counted a 64-bit word at a time
+// (row padding bits are not counted)
+uint64_t count_set_bits(const uint8_t *packed, size_t packed_size, int width, int height);
+
+// Tile references: read_raster(dedup := true) replaces a band blob that an
+// earlier tile already produced with this marker followed by a little-endian
+// uint32 slot in the band's tile_dictionary, which holds the original bytes.
+constexpr uint8_t TILE_REF_MAGIC[4] = {'R', 'Q', 'R', 0x01};
+constexpr size_t TILE_REF_SIZE = sizeof(TILE_REF_MAGIC) + sizeof(uint32_t);
+
+inline bool is_tile_ref(const uint8_t *data, size_t size) {
+    return data != nullptr && size == TILE_REF_SIZE &&
+           std::memcmp(data, TILE_REF_MAGIC, sizeof(TILE_REF_MAGIC)) == 0;
+}
+
+inline uint32_t tile_ref_index(const uint8_t *data) {
+    const uint8_t *p = data + sizeof(TILE_REF_MAGIC);
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+// Point `data`/`size` at the original blob when they hold a tile reference;
+// any other blob is left as is. Only bands with a tile_dictionary hold
+// references: elsewhere an 8-byte blob that starts with the marker is data.
+inline void resolve_tile_ref(const uint8_t *&data, size_t &size, const BandCodec &codec) {
+    if (!codec.tile_dictionary || !is_tile_ref(data, size)) {
+        return;
+    }
+    uint32_t index = tile_ref_index(data);
+    if (index >= codec.tile_dictionary->size()) {
+        throw std::runtime_error("Tile reference " + std::to_string(index) +
+                                 " is not in the band's tile_dictionary");
+    }
+    const auto &original = (*codec.tile_dictionary)[index];
+    data = original.data();
+    size = original.size();
+}
+
+// Validity masks: read_raster(validity_mask := true) prefixes the blob of a
+// band tile that mixes valid and nodata pixels with this marker, the
+// little-endian uint32 size of the encoded mask, the float64 nodata the mask
+// was built against, and the mask: one bit per pixel (1 = valid) in uint1
+// rows, encoded with the band's codec and no predictor. The band blob follows.
+// Such bands are flagged "validity_mask": true, and only their blobs are split
+// (BandCodec::validity_mask): a reader unaware of the flag would decode the
+// header as band data.
+constexpr uint8_t VALIDITY_MASK_MAGIC[4] = {'R', 'Q', 'M', 0x01};
+constexpr size_t VALIDITY_MASK_HEADER = sizeof(VALIDITY_MASK_MAGIC) + sizeof(uint32_t) + sizeof(double);
+
+struct ValidityMask {
+    const uint8_t *data = nullptr;  // encoded mask bytes
+    size_t size = 0;
+    double nodata = 0.0;
+};
+
+inline bool has_validity_mask(const uint8_t *data, size_t size, const BandCodec &codec) {
+    return codec.validity_mask && data != nullptr && size >= VALIDITY_MASK_HEADER &&
+           std::memcmp(data, VALIDITY_MASK_MAGIC, sizeof(VALIDITY_MASK_MAGIC)) == 0;
+}
+
+// Split a masked blob: `mask` gets the encoded mask and `data`/`size` move
+// past it to the band blob. Returns false, leaving everything as is, for
+// blobs without a mask and for every blob of a band not flagged for masks.
+inline bool split_validity_mask(const uint8_t *&data, size_t &size, const BandCodec &codec, ValidityMask &mask) {
+    if (!has_validity_mask(data, size, codec)) {
+        return false;
+    }
+    const uint8_t *p = data + sizeof(VALIDITY_MASK_MAGIC);
+    size_t mask_size = static_cast<size_t>(p[0]) | (static_cast<size_t>(p[1]) << 8) |
+                       (static_cast<size_t>(p[2]) << 16) | (static_cast<size_t>(p[3]) << 24);
+    if (mask_size > size - VALIDITY_MASK_HEADER) {
+        throw std::out_of_range("Validity mask of " + std::to_string(mask_size) + " bytes overruns a " +
+                                std::to_string(size) + "-byte blob");
+    }
+    std::memcpy(&mask.nodata, p + sizeof(uint32_t), sizeof(double));
+    mask.data = data + VALIDITY_MASK_HEADER;
+    mask.size = mask_size;
+    data += VALIDITY_MASK_HEADER + mask_size;
+    size -= VALIDITY_MASK_HEADER + mask_size;
+    return true;
+}
+
+// A mask only stands in for the nodata test it was built for
+inline bool validity_mask_applies(const ValidityMask &mask, bool has_nodata, double nodata) {
+    return has_nodata && (mask.nodata == nodata || (std::isnan(mask.nodata) && std::isnan(nodata)));
+}
+
+// Decode a split-off validity mask to packed 1-bit rows (packed_row_bytes(width, 1)
+// bytes each). Returns `mask.data` itself when stored raw, otherwise a pointer
+// into `scratch`.
+const uint8_t *decode_validity_mask(const ValidityMask &mask, const BandCodec &codec, int width, int height,
+                                    std::vector<uint8_t> &scratch, size_t &size_out);
+
+// True when `data` carries a validity mask for this nodata without a single
+// valid pixel: callers can drop the tile without decoding the band.
+bool tile_all_nodata(const uint8_t *data, size_t size, const BandCodec &codec, int width, int height,
+                     bool has_nodata, double nodata);
+
+// Decode a band blob to raw row-major pixel bytes. Returns `data` itself for
+// raw blobs, otherwise a pointer into `scratch`. Quantized blobs are expanded
+// back to `elem_size`-byte floats (single-sample bands only) and constant
+// tiles to `width` x `height` copies of their value (`height` is only read
+// for those). Tile references are resolved through codec.tile_dictionary
+// first, validity masks are skipped, and compression "auto" reads the tile's
+// codec byte. Image codecs (jpeg/webp) are not handled here; they decode
+// through decompress_jpeg/decompress_webp.
+const uint8_t *decode_band_bytes(const uint8_t *data, size_t size, const BandCodec &codec,
+                                 size_t elem_size, int width, int height, int samples_per_pixel,
+                                 std::vector<uint8_t> &scratch, size_t &size_out);
 
 // v0.4.0: Decompress JPEG image to raw RGB bytes
 // Returns decoded image data in RGB format (3 bytes per pixel, row-major)
@@ -122,6 +404,9 @@ inline double get_pixel_value(const uint8_t *data, size_t data_size, size_t offs
     }
     switch (dtype) {
         case BandDataType::UINT8:
+        case BandDataType::UINT1:
+        case BandDataType::UINT2:
+        case BandDataType::UINT4:
             return static_cast<double>(data[offset]);
         case BandDataType::INT8:
             return static_cast<double>(reinterpret_cast<const int8_t*>(data)[offset]);
@@ -178,13 +463,29 @@ inline double get_pixel_value(const uint8_t *data, size_t data_size, size_t offs
 double decode_pixel(const uint8_t *band_data, size_t band_size,
                     const std::string &dtype_str,
                     int pixel_x, int pixel_y, int width,
-                    bool compressed);
+                    const BandCodec &codec);
+
+inline double decode_pixel(const uint8_t *band_data, size_t band_size,
+                           const std::string &dtype_str,
+                           int pixel_x, int pixel_y, int width,
+                           bool compressed) {
+    return decode_pixel(band_data, band_size, dtype_str, pixel_x, pixel_y, width,
+                        BandCodec::from_flag(compressed));
+}
 
 // Decode entire band to vector of doubles
 std::vector<double> decode_band(const uint8_t *band_data, size_t band_size,
                                  const std::string &dtype_str,
                                  int width, int height,
-                                 bool compressed);
+                                 const BandCodec &codec);
+
+inline std::vector<double> decode_band(const uint8_t *band_data, size_t band_size,
+                                        const std::string &dtype_str,
+                                        int width, int height,
+                                        bool compressed) {
+    return decode_band(band_data, band_size, dtype_str, width, height,
+                       BandCodec::from_flag(compressed));
+}
 
 // v0.4.0: Decode pixel from interleaved (BIP) layout
 // For interleaved data, all bands are stored in a single 'pixels' column
@@ -193,14 +494,14 @@ double decode_pixel_interleaved(const uint8_t *pixels_data, size_t pixels_size,
                                  const std::string &dtype_str,
                                  int pixel_x, int pixel_y, int width,
                                  int band_index, int num_bands,
-                                 const std::string &compression);
+                                 const BandCodec &codec);
 
 // v0.4.0: Decode entire band from interleaved layout
 std::vector<double> decode_band_interleaved(const uint8_t *pixels_data, size_t pixels_size,
                                              const std::string &dtype_str,
                                              int width, int height,
                                              int band_index, int num_bands,
-                                             const std::string &compression);
+                                             const BandCodec &codec);
 
 // Statistics result structure
 struct BandStats {
@@ -212,14 +513,28 @@ struct BandStats {
     double stddev = 0.0;
 };
 
+// Closed-form stats of a tile whose `pixel_count` pixels all equal `value`
+// (constant tiles): no pixel loop.
+BandStats constant_band_stats(double value, size_t pixel_count, bool has_nodata, double nodata);
+
 // Compute statistics directly from band data without allocating full pixel array
 // This is more memory efficient for large tiles
 BandStats compute_band_stats(const uint8_t *band_data, size_t band_size,
                               const std::string &dtype_str,
                               int width, int height,
-                              bool compressed,
+                              const BandCodec &codec,
                               bool has_nodata = false,
                               double nodata = 0.0);
 
+inline BandStats compute_band_stats(const uint8_t *band_data, size_t band_size,
+                                     const std::string &dtype_str,
+                                     int width, int height,
+                                     bool compressed,
+                                     bool has_nodata = false,
+                                     double nodata = 0.0) {
+    return compute_band_stats(band_data, band_size, dtype_str, width, height,
+                              BandCodec::from_flag(compressed), has_nodata, nodata);
+}
+
 } // namespace raquet
 } // namespace duckdb
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "band_decoder.hpp"
+
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -7,8 +9,121 @@
 namespace duckdb {
 namespace raquet {
 
-// Compress raw data with gzip
-std::vector<uint8_t> compress_gzip(const uint8_t *data, size_t size);
+// Compress raw data with gzip. A non-empty `dictionary` primes the deflate
+// window (zlib FDICT stream); decoders must pass the same bytes back.
+// `level` is zlib's 1-9, -1 for its default (6).
+std::vector<uint8_t> compress_gzip(const uint8_t *data, size_t size,
+                                   const std::vector<uint8_t> *dictionary = nullptr, int level = -1);
+
+// If all `size / elem_size` elements of `data` are bitwise identical, return
+// the constant-tile blob for them (see CONSTANT_TILE_MAGIC in
+// band_decoder.hpp); otherwise an empty vector.
+std::vector<uint8_t> encode_constant_tile(const uint8_t *data, size_t size, size_t elem_size);
+
+// The reference blob pointing at `slot` of a band's tile_dictionary (see
+// TILE_REF_MAGIC in band_decoder.hpp).
+std::vector<uint8_t> encode_tile_ref(uint32_t slot);
+
+// Build a preset deflate dictionary of at most `dict_size` bytes from sample
+// tiles (raw bytes as they reach the codec, i.e. after any predictor). Keeps
+// the 8-byte sequences shared by the most samples, most common last so their
+// matches are the shortest back-references. Empty when the samples share
+// nothing worth priming.
+std::vector<uint8_t> train_deflate_dictionary(const std::vector<std::vector<uint8_t>> &samples,
+                                              size_t dict_size);
+
+// Compress raw data as a Zstandard frame with the content size recorded
+// (requires RAQUET_HAS_ZSTD)
+std::vector<uint8_t> compress_zstd(const uint8_t *data, size_t size, int level = 3);
+
+// Compress raw data as an LZ4 frame with the content size recorded
+// (requires RAQUET_HAS_LZ4)
+std::vector<uint8_t> compress_lz4(const uint8_t *data, size_t size);
+
+// Apply horizontal differencing (TIFF predictor=2) in place: each sample is
+// replaced by its difference from the same sample of the previous pixel in
+// the row, with wrap-around integer arithmetic. Inverse of
+// undo_horizontal_predictor in band_decoder.hpp.
+void apply_horizontal_predictor(uint8_t *data, size_t size, size_t elem_size,
+                                int width, int samples_per_pixel);
+
+// Apply the floating-point predictor (TIFF predictor=3) in place: each row is
+// split into byte planes, most significant byte first, then differenced byte
+// by byte. Sign/exponent bytes of neighbouring pixels line up and deflate or
+// zstd can find the runs. Inverse of undo_float_predictor in band_decoder.hpp.
+void apply_float_predictor(uint8_t *data, size_t size, size_t elem_size,
+                           int width, int samples_per_pixel);
+
+// Codec, level and predictor picked for one tile under compression='auto'
+struct AutoCodecChoice {
+    std::string compression = "none";
+    int level = 0;
+    int predictor = 1;
+};
+
+// Choose a tile's encoding from up to 32 sampled rows: their order-0 byte
+// entropy as stored and after the predictor that suits the type (2 for
+// integers, 3 for floats), and how many bytes repeat their left neighbour.
+// Near-random tiles (>= 7.5 bits/byte) stay raw. `objective` then sets the
+// codec: "size" zstd 19 (deflate 9 without zstd); "balanced" zstd 3, or
+// deflate 6 for run-heavy tiles; "speed" lz4 (zstd 1, deflate 1) and raw
+// above 6 bits/byte. Only "size" keeps the predictor whenever it lowers the
+// entropy, the others weigh the extra decode pass. Constant tiles are caught
+// earlier by encode_constant_tile.
+AutoCodecChoice choose_tile_codec(const uint8_t *data, size_t size, size_t elem_size, int width,
+                                  int samples_per_pixel, bool is_float, const std::string &objective);
+
+// Encode one tile for compression='auto': the choose_tile_codec predictor
+// runs in place on `data`, then the codec, and the codec byte (see
+// AUTO_CODEC_NONE in band_decoder.hpp) is prepended. Output that would not
+// be smaller than the input is stored uncompressed instead.
+std::vector<uint8_t> encode_auto_tile(uint8_t *data, size_t size, size_t elem_size, int width,
+                                      int samples_per_pixel, bool is_float, const std::string &objective);
+
+// Run a byte codec (gzip / zstd / lz4 / auto / none) over one band plane or
+// an interleaved pixel buffer. The predictor is applied in place, so `data`
+// must be caller-owned scratch that is not read again afterwards.
+std::vector<uint8_t> compress_band_bytes(uint8_t *data, size_t size, const std::string &compression,
+                                         const std::string &auto_objective, int predictor, size_t elem_size,
+                                         bool is_float, int width, int samples_per_pixel,
+                                         const std::vector<uint8_t> *dictionary = nullptr);
+
+// Plan error-bounded quantization of a float band whose valid pixels span
+// [min, max]: codes are round((v - offset) / scale) with scale chosen so the
+// decoded value (after rounding back to `float_size`-byte floats) is within
+// `max_error` of the original. Picks the narrowest of uint8/uint16/uint32 that
+// holds every code plus one spare nodata code; returns false if none does.
+bool plan_quantization(double min, double max, double max_error, size_t float_size,
+                       std::string &stored_type, double &scale, double &offset,
+                       uint64_t &nodata_code);
+
+// Quantize `count` little-endian floats of `float_size` bytes in place into
+// `stored_type` codes (packed at the front of `data`). NaN and nodata pixels
+// get `nodata_code`; anything outside the planned range is clamped.
+void quantize_band(uint8_t *data, size_t count, size_t float_size,
+                   const std::string &stored_type, double scale, double offset,
+                   uint64_t nodata_code, bool has_nodata, double nodata);
+
+// Pack a `width` x `height` plane of one-byte pixels in place into `bits`-wide
+// fields (1, 2 or 4), MSB first with each row padded to a byte (see
+// packed_row_bytes in band_decoder.hpp). Returns the packed size. Throws
+// std::out_of_range if a pixel does not fit in `bits`.
+size_t pack_bits(uint8_t *data, int width, int height, int bits);
+
+// Write `value` as one decoded pixel of `dtype` (packed types are one byte):
+// integers are rounded and clamped, float16 rounds to nearest even. Inverse
+// of get_pixel_value in band_decoder.hpp.
+void store_pixel_value(uint8_t *dst, BandDataType dtype, double value);
+
+// Validity bits of a `width` x `height` plane for `nodata` (NaN matches NaN),
+// packed as uint1 rows like pack_bits. `valid_count` gets the number of set bits.
+std::vector<uint8_t> build_validity_mask(const uint8_t *data, const std::string &dtype_str, int width, int height,
+                                         double nodata, size_t &valid_count);
+
+// Prefix `band_blob` with an encoded validity mask built for `nodata` (see
+// VALIDITY_MASK_MAGIC in band_decoder.hpp).
+std::vector<uint8_t> wrap_validity_mask(const std::vector<uint8_t> &encoded_mask, double nodata,
+                                        const std::vector<uint8_t> &band_blob);
 
 // Encode raw RGB/grayscale pixels as JPEG
 // Input: row-major pixel data, width * height * channels bytes
@@ -22,11 +137,23 @@ std::vector<uint8_t> encode_jpeg(const uint8_t *data, int width, int height,
 std::vector<uint8_t> encode_webp(const uint8_t *data, int width, int height,
                                   int channels, int quality = 85);
 
+// Encode raw gray / gray+alpha / RGB / RGBA pixels (1-4 channels) as PNG
+// Input: row-major pixel data, width * height * channels bytes
+// Returns PNG bytes (zlib only, "up" row filter). `level` is zlib's 1-9,
+// -1 for its default.
+std::vector<uint8_t> encode_png(const uint8_t *data, int width, int height,
+                                 int channels, int level = -1);
+
 // Interleave sequential band data into BIP (Band Interleaved by Pixel) format
 // Input: vector of per-band raw byte buffers (all same size = width * height * dtype_size)
 // Output: interleaved bytes [R0,G0,B0,R1,G1,B1,...] where each element is dtype_size bytes
 std::vector<uint8_t> interleave_bands(const std::vector<std::vector<uint8_t>> &bands,
                                        int width, int height, size_t dtype_size);
 
+// Same, for band planes that live in caller-owned memory (e.g. a
+// buffer-managed scratch block in read_raster)
+std::vector<uint8_t> interleave_bands(const std::vector<const uint8_t *> &bands,
+                                       int width, int height, size_t dtype_size);
+
 } // namespace raquet
 } // namespace duckdb
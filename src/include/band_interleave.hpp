@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace duckdb {
+namespace raquet {
+
+// Band interleave / deinterleave (BSQ planes <-> BIP pixels) for
+// `num_pixels` pixels of `elem_size`-byte samples.
+//
+// 2-4 bands of 1-, 2-, 4- and 8-byte samples run byte-shuffle transpose
+// kernels (AVX2 or SSSE3, picked at runtime on x86-64 builds with GCC or
+// Clang); everything else, and other CPUs, use a scalar loop.
+
+// planes[b] -> dst[(pixel * num_bands + b) * elem_size]
+void interleave_planes(const uint8_t *const *planes, size_t num_bands, size_t num_pixels, size_t elem_size,
+                       uint8_t *dst);
+
+// One band out of BIP `src` into the contiguous plane `dst`
+void deinterleave_band(const uint8_t *src, size_t num_bands, size_t band_index, size_t num_pixels,
+                       size_t elem_size, uint8_t *dst);
+
+// Every band out of BIP `src` into planes[b]
+void deinterleave_planes(const uint8_t *src, size_t num_bands, size_t num_pixels, size_t elem_size,
+                         uint8_t *const *planes);
+
+// Kernel picked for this CPU: "avx2", "ssse3" or "scalar"
+const char *interleave_kernel_isa();
+
+} // namespace raquet
+} // namespace duckdb
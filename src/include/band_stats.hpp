@@ -3,6 +3,7 @@
 #ifdef RAQUET_HAS_GDAL
 
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -24,10 +25,11 @@ namespace raquet {
 // v0.5.0 output even though the raquet spec defines neither.
 //
 // In `approx` mode, quantiles/top_values come from a 1000-pixel
-// random sample. In exact mode, they're derived from a streaming
-// histogram of the full band — exact for fixed-bucket integer dtypes
-// (uint8/int8/uint16/int16), and exact-up-to-bin-width for wider
-// integer / float dtypes.
+// random sample, drawn from a few randomly chosen internal blocks per
+// round so each block is decoded once. In exact mode, they're derived
+// from a streaming histogram of the full band — exact for fixed-bucket
+// integer dtypes (uint8/int8/uint16/int16), and exact-up-to-bin-width
+// for wider integer / float dtypes.
 struct BandStatsResult {
     int64_t count = 0;
     double  min = 0.0;
@@ -57,6 +59,32 @@ BandStatsResult compute_band_stats(
     GDALDataType dtype,
     bool approx);
 
+// Runs work(0) .. work(workers - 1) concurrently and returns once all of
+// them have finished. Supplied by the caller so the workers run on its
+// scheduler (read_raster uses DuckDB's TaskExecutor).
+using ParallelRunner = std::function<void(int workers, const std::function<void(int)> &work)>;
+
+// Exact (approx=false) stats for several bands in one parallel pass.
+// The source is split into block-row stripes; each of at most `threads`
+// workers started through `run_workers` opens its own dataset through
+// `open_dataset` and folds its stripes into mergeable accumulators
+// (Chan-merged moments, dense histograms). Fields match
+// compute_band_stats(..., approx=false): exact count/min/max/mean/stddev,
+// histogram-derived quantiles/top_values. Pixels masked out by the band's
+// mask (alpha or per-dataset mask) are skipped, as in
+// GDALComputeRasterStatistics; a failed block read throws. Wide-int and
+// float dtypes read the source twice (min/max are needed to place
+// histogram bins); fixed-bucket ints read it once. `band_indices` are
+// 1-based; `nodatas`/`has_nodatas` are parallel to it.
+std::vector<BandStatsResult> compute_band_stats_exact_parallel(
+    const std::function<GDALDatasetH()> &open_dataset,
+    const std::vector<int> &band_indices,
+    int raster_width, int raster_height,
+    const std::vector<double> &nodatas, const std::vector<bool> &has_nodatas,
+    GDALDataType dtype,
+    int threads,
+    const ParallelRunner &run_workers);
+
 }  // namespace raquet
 }  // namespace duckdb
 
@@ -5,7 +5,7 @@
 namespace duckdb {
 namespace raquet {
 
-// Initialize the embedded PROJ database.
+// Initialize the embedded PROJ database, inflating it on the first call.
 // Must be called before any GDAL/PROJ coordinate transformations.
 // Safe to call multiple times (uses std::once_flag internally).
 void InitEmbeddedProj();
@@ -2,16 +2,66 @@
 
 #include <array>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include <stdexcept>
 #include <cmath>
 #include <limits>
 
+#include "band_decoder.hpp"
+#include "raquet_metrics.hpp"
+
 namespace duckdb {
 namespace raquet {
 
+// Standard base64 (RFC 4648, padded) for binary payloads embedded in the
+// metadata JSON, such as preset compression dictionaries.
+inline std::string base64_encode(const std::vector<uint8_t> &data) {
+    static const char *alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((data.size() + 2) / 3 * 4);
+    for (size_t i = 0; i < data.size(); i += 3) {
+        uint32_t n = static_cast<uint32_t>(data[i]) << 16;
+        if (i + 1 < data.size()) n |= static_cast<uint32_t>(data[i + 1]) << 8;
+        if (i + 2 < data.size()) n |= data[i + 2];
+        out += alphabet[(n >> 18) & 63];
+        out += alphabet[(n >> 12) & 63];
+        out += i + 1 < data.size() ? alphabet[(n >> 6) & 63] : '=';
+        out += i + 2 < data.size() ? alphabet[n & 63] : '=';
+    }
+    return out;
+}
+
+// Inverse of base64_encode; stops at padding and skips any other character.
+inline std::vector<uint8_t> base64_decode(const std::string &text) {
+    std::vector<uint8_t> out;
+    out.reserve(text.size() / 4 * 3);
+    uint32_t acc = 0;
+    int bits = 0;
+    for (char c : text) {
+        int v;
+        if (c >= 'A' && c <= 'Z') v = c - 'A';
+        else if (c >= 'a' && c <= 'z') v = c - 'a' + 26;
+        else if (c >= '0' && c <= '9') v = c - '0' + 52;
+        else if (c == '+') v = 62;
+        else if (c == '/') v = 63;
+        else if (c == '=') break;
+        else continue;
+        acc = (acc << 6) | static_cast<uint32_t>(v);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out.push_back(static_cast<uint8_t>((acc >> bits) & 0xFF));
+        }
+    }
+    return out;
+}
+
 // Band info structure (v0.3.0+ format)
 struct BandInfo {
     std::string name;
@@ -60,6 +110,35 @@ struct BandInfo {
         std::map<double, int64_t> top_values;             // up to 10 entries
     } stats;
 
+    // Error-bounded quantization (read_raster max_error). When stored_type is
+    // set the band blob holds unsigned integer codes of that type, decoded as
+    // code * scale + offset; nodata_code marks nodata/NaN pixels. The band's
+    // logical `type` stays float32/float64.
+    struct Quantization {
+        std::string stored_type;
+        double scale = 1.0;
+        double offset = 0.0;
+        double max_error = 0.0;
+        uint64_t nodata_code = 0;
+    } quantization;
+
+    bool is_quantized() const {
+        return !quantization.stored_type.empty();
+    }
+
+    // Preset deflate dictionary shared by every gzip tile of this band
+    // (read_raster dictionary_size). Stored base64 in the band object and
+    // decoded once per parse, so the metadata cache hands it to all rows.
+    std::shared_ptr<const std::vector<uint8_t>> compression_dictionary;
+
+    // Band blobs shared by several tiles (read_raster dedup). Tiles hold a
+    // TILE_REF_MAGIC reference to a slot; stored as a base64 array.
+    std::shared_ptr<const std::vector<std::vector<uint8_t>>> tile_dictionary;
+
+    // Tiles mixing valid and nodata pixels may carry a VALIDITY_MASK_MAGIC
+    // bitmask ahead of the band blob (read_raster validity_mask).
+    bool validity_mask = false;
+
     BandInfo() : nodata(0), has_nodata(false), scale(1.0), offset(0.0),
                  has_scale(false), has_offset(false) {}
     BandInfo(const std::string &n, const std::string &t)
@@ -75,7 +154,9 @@ struct RaquetMetadata {
     std::string file_format;  // new in v0.3.0: should be "raquet"
     std::string compression;
     int compression_quality;  // new in v0.4.0: JPEG/WebP quality (1-100), 0 if not specified
+    int compression_predictor = 1;  // TIFF-style predictor before gzip/zstd/lz4 (1 = none, 2 = horizontal, 3 = float)
     std::string band_layout;  // new in v0.4.0: "sequential" (default) or "interleaved"
+    bool constant_tiles = false;  // band blobs may be constant tiles (read_raster constant_tiles)
     int block_width;
     int block_height;
     int min_zoom;       // was minresolution
@@ -156,6 +237,30 @@ struct RaquetMetadata {
         return tile_statistics;
     }
 
+    // Codec for decoding non-image band blobs of this raster. Passing the
+    // band index picks up that band's quantization, if any.
+    BandCodec band_codec(int band_index = 0) const {
+        BandCodec codec(compression, compression_predictor);
+        if (band_index >= 0 && band_index < static_cast<int>(band_info.size())) {
+            const auto &bi = band_info[band_index];
+            if (bi.is_quantized()) {
+                codec.quant_type = bi.quantization.stored_type;
+                codec.quant_scale = bi.quantization.scale;
+                codec.quant_offset = bi.quantization.offset;
+                codec.quant_nodata_code = bi.quantization.nodata_code;
+                codec.quant_nodata = bi.has_nodata ? bi.nodata : std::numeric_limits<double>::quiet_NaN();
+            }
+            codec.dictionary = bi.compression_dictionary;
+            codec.tile_dictionary = bi.tile_dictionary;
+            codec.validity_mask = bi.validity_mask;
+        }
+        codec.constant_tiles = constant_tiles;
+        if (band_index >= 0 && band_index < static_cast<int>(bands.size())) {
+            codec.packed_bits = packed_bits_of(bands[band_index].second);
+        }
+        return codec;
+    }
+
     // v0.4.0: Check if compression is lossy (JPEG/WebP)
     bool is_lossy_compression() const {
         return compression == "jpeg" || compression == "webp";
@@ -264,6 +369,41 @@ struct RaquetMetadata {
         return out;
     }
 
+    // Render a band's quantization parameters, or "" when not quantized.
+    // Scale/offset use round-trip precision: std::to_string's six decimals
+    // would shift every decoded pixel.
+    static std::string quantization_to_json(const BandInfo &bi) {
+        if (!bi.is_quantized()) return "";
+        auto exact = [](double v) {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%.17g", v);
+            return std::string(buf);
+        };
+        const auto &q = bi.quantization;
+        return ",\"quantization\":{\"stored_type\":\"" + q.stored_type + "\""
+            + ",\"scale\":" + exact(q.scale)
+            + ",\"offset\":" + exact(q.offset)
+            + ",\"max_error\":" + exact(q.max_error)
+            + ",\"nodata_code\":" + std::to_string(q.nodata_code) + "}";
+    }
+
+    // Render a band's preset dictionary, or "" when it has none.
+    static std::string dictionary_to_json(const BandInfo &bi) {
+        if (!bi.compression_dictionary || bi.compression_dictionary->empty()) return "";
+        return ",\"compression_dictionary\":\"" + base64_encode(*bi.compression_dictionary) + "\"";
+    }
+
+    // Render a band's deduplicated tile blobs, or "" when it has none.
+    static std::string tile_dictionary_to_json(const BandInfo &bi) {
+        if (!bi.tile_dictionary || bi.tile_dictionary->empty()) return "";
+        std::string json = ",\"tile_dictionary\":[";
+        for (size_t i = 0; i < bi.tile_dictionary->size(); i++) {
+            if (i > 0) json += ",";
+            json += "\"" + base64_encode((*bi.tile_dictionary)[i]) + "\"";
+        }
+        return json + "]";
+    }
+
     // Render the v0.1.0 stats object for a single band. When stats are missing
     // the band still gets a stats key but valued null, so consumers can rely on
     // the field being present. quantiles, top_values, and version are emitted
@@ -305,6 +445,12 @@ struct RaquetMetadata {
         } else {
             json += ",\"compression\":\"" + compression + "\"";
         }
+        if (compression_predictor > 1) {
+            json += ",\"compression_predictor\":" + std::to_string(compression_predictor);
+        }
+        if (constant_tiles) {
+            json += ",\"constant_tiles\":true";
+        }
 
         // Flat tiling fields (v0 names)
         json += ",\"block_width\":" + std::to_string(block_width);
@@ -375,6 +521,12 @@ struct RaquetMetadata {
                 json += "\"" + bi.colorinterp + "\"";
             }
             json += ",\"colortable\":" + colortable_to_json(bi);
+            json += quantization_to_json(bi);
+            json += dictionary_to_json(bi);
+            json += tile_dictionary_to_json(bi);
+            if (bi.validity_mask) {
+                json += ",\"validity_mask\":true";
+            }
             json += ",\"stats\":" + stats_to_json_v0(bi);
             json += "}";
         }
@@ -409,6 +561,12 @@ struct RaquetMetadata {
         } else {
             json += ",\"compression\":\"" + compression + "\"";
         }
+        if (compression_predictor > 1) {
+            json += ",\"compression_predictor\":" + std::to_string(compression_predictor);
+        }
+        if (constant_tiles) {
+            json += ",\"constant_tiles\":true";
+        }
         if (compression_quality > 0) {
             json += ",\"compression_quality\":" + std::to_string(compression_quality);
         }
@@ -473,6 +631,12 @@ struct RaquetMetadata {
             if (bi.has_colortable && !bi.colortable.empty()) {
                 json += ",\"colortable\":" + colortable_to_json(bi);
             }
+            json += quantization_to_json(bi);
+            json += dictionary_to_json(bi);
+            json += tile_dictionary_to_json(bi);
+            if (bi.validity_mask) {
+                json += ",\"validity_mask\":true";
+            }
             if (bi.stats.has_stats) {
                 const auto &s = bi.stats;
                 json += ",\"STATISTICS_MINIMUM\":" + std::to_string(s.min);
@@ -739,6 +903,44 @@ inline std::vector<std::array<int, 4>> parse_colortable(const std::string &band_
     return out;
 }
 
+// Parse a v0.1.0 quantiles object: {"3":[c1,c2],"4":[c1,c2,c3],...}, each
+// key N holding the N-1 cut points of N equal-count classes.
+inline std::map<int, std::vector<double>> parse_quantiles(const std::string &stats_json) {
+    std::map<int, std::vector<double>> out;
+    std::string obj = extract_json_object(stats_json, "quantiles");
+    if (obj.empty()) return out;
+
+    size_t pos = 0;
+    while (pos < obj.size()) {
+        size_t key_start = obj.find('"', pos);
+        if (key_start == std::string::npos) break;
+        size_t key_end = obj.find('"', key_start + 1);
+        if (key_end == std::string::npos) break;
+        size_t lb = obj.find('[', key_end);
+        if (lb == std::string::npos) break;
+        size_t rb = obj.find(']', lb);
+        if (rb == std::string::npos) break;
+
+        int key = std::atoi(obj.substr(key_start + 1, key_end - key_start - 1).c_str());
+        std::vector<double> cuts;
+        const char *p = obj.c_str() + lb + 1;
+        const char *end = obj.c_str() + rb;
+        while (p < end) {
+            char *next = nullptr;
+            double v = std::strtod(p, &next);
+            if (next == p) {
+                p++;
+                continue;
+            }
+            cuts.push_back(v);
+            p = next;
+        }
+        if (key > 1) out[key] = std::move(cuts);
+        pos = rb + 1;
+    }
+    return out;
+}
+
 // Parse a v0.1.0 stats object: {"count":...,"min":...,"max":...,...}.
 inline BandInfo::Stats parse_stats_v0(const std::string &band_json) {
     BandInfo::Stats s;
@@ -754,6 +956,7 @@ inline BandInfo::Stats parse_stats_v0(const std::string &band_json) {
     s.sum_squares = extract_json_double(obj, "sum_squares", 0);
     std::string approx = extract_json_string(obj, "approximated_stats");
     s.approximated = (approx == "true" || approx == "1");
+    s.quantiles = parse_quantiles(obj);
     s.has_stats = true;
     return s;
 }
@@ -767,6 +970,7 @@ inline BandInfo::Stats parse_stats_v05(const std::string &band_json) {
     s.mean         = extract_json_double(band_json, "STATISTICS_MEAN", 0);
     s.stddev       = extract_json_double(band_json, "STATISTICS_STDDEV", 0);
     s.valid_percent = extract_json_double(band_json, "STATISTICS_VALID_PERCENT", 0);
+    s.quantiles    = parse_quantiles(band_json);
     s.has_stats    = true;
     return s;
 }
@@ -896,6 +1100,32 @@ inline void parse_bands_full(const std::string &json,
                 info.colortable = parse_colortable(band_obj);
                 info.has_colortable = !info.colortable.empty();
 
+                std::string quant_obj = extract_json_object(band_obj, "quantization");
+                if (!quant_obj.empty()) {
+                    info.quantization.stored_type = extract_json_string(quant_obj, "stored_type");
+                    info.quantization.scale = extract_json_double(quant_obj, "scale", 1.0);
+                    info.quantization.offset = extract_json_double(quant_obj, "offset", 0.0);
+                    info.quantization.max_error = extract_json_double(quant_obj, "max_error", 0.0);
+                    info.quantization.nodata_code =
+                        static_cast<uint64_t>(extract_json_double(quant_obj, "nodata_code", 0.0));
+                }
+
+                std::string dictionary_b64 = extract_json_string(band_obj, "compression_dictionary");
+                if (!dictionary_b64.empty()) {
+                    info.compression_dictionary =
+                        std::make_shared<const std::vector<uint8_t>>(base64_decode(dictionary_b64));
+                }
+
+                auto tile_blobs_b64 = extract_json_string_array(band_obj, "tile_dictionary");
+                if (!tile_blobs_b64.empty()) {
+                    auto tile_blobs = std::make_shared<std::vector<std::vector<uint8_t>>>();
+                    for (auto &blob_b64 : tile_blobs_b64) {
+                        tile_blobs->push_back(base64_decode(blob_b64));
+                    }
+                    info.tile_dictionary = std::move(tile_blobs);
+                }
+                info.validity_mask = extract_json_string(band_obj, "validity_mask") == "true";
+
                 // Stats — try v0.1.0 nested object first, fall back to v0.5.0 flat keys.
                 BandInfo::Stats s = parse_stats_v0(band_obj);
                 if (!s.has_stats) {
@@ -921,6 +1151,7 @@ inline std::vector<std::pair<std::string, std::string>> parse_bands(const std::s
 
 // Parse metadata JSON string (v0.4.0 format)
 inline RaquetMetadata parse_metadata(const std::string &json) {
+    metric_add(Metric::METADATA_PARSES, 1);
     RaquetMetadata meta;
 
     // New in v0.3.0: file_format identifier
@@ -932,10 +1163,16 @@ inline RaquetMetadata parse_metadata(const std::string &json) {
     // New in v0.4.0: compression quality for JPEG/WebP
     meta.compression_quality = extract_json_int(json, "compression_quality", 0);
 
+    // Predictor applied before the byte codec (absent = 1, none)
+    meta.compression_predictor = extract_json_int(json, "compression_predictor", 1);
+
     // New in v0.4.0: band layout (sequential or interleaved)
     meta.band_layout = extract_json_string(json, "band_layout");
     if (meta.band_layout.empty()) meta.band_layout = "sequential";
 
+    // Band blobs may be constant tiles only when the writer says so
+    meta.constant_tiles = extract_json_string(json, "constant_tiles") == "true";
+
     meta.crs = extract_json_string(json, "crs");
 
     // Detect version: v0 has no "version" field, v0.5.0+ has it
@@ -990,5 +1227,35 @@ inline RaquetMetadata parse_metadata(const std::string &json) {
     return meta;
 }
 
+// Thread-local single-entry cache in front of parse_metadata(). Scalar
+// functions over read_raquet() see the same metadata string on every row,
+// and comparing the string is far cheaper than re-parsing it. Callers pass
+// the row's bytes in place (no per-row copy); a length mismatch rejects
+// without touching them. The returned reference stays valid until the next
+// call on the same thread, so callers must not hold it across rows.
+inline const RaquetMetadata &parse_metadata_cached(const char *json, size_t size) {
+    struct CacheEntry {
+        std::string json;
+        RaquetMetadata meta;
+        bool valid = false;
+    };
+    static thread_local CacheEntry entry;
+    if (entry.valid && entry.json.size() == size && std::memcmp(entry.json.data(), json, size) == 0) {
+        metric_add(Metric::METADATA_CACHE_HITS, 1);
+        return entry.meta;
+    }
+    // Invalidate first: if parse_metadata throws, the stale entry must not
+    // be served for the new string.
+    entry.valid = false;
+    entry.json.assign(json, size);
+    entry.meta = parse_metadata(entry.json);
+    entry.valid = true;
+    return entry.meta;
+}
+
+inline const RaquetMetadata &parse_metadata_cached(const std::string &json) {
+    return parse_metadata_cached(json.data(), json.size());
+}
+
 } // namespace raquet
 } // namespace duckdb
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace duckdb {
+namespace raquet {
+
+// ─────────────────────────────────────────────
+// Execution counters for raquet kernels.
+//
+// Every thread owns one ThreadMetrics block (thread_local, registered with a
+// process-wide registry on first use). Increments are a relaxed load+store
+// on the owning thread's slot — no lock prefix, no shared cache line — so the
+// counters are cheap enough to stay on in production. Readers
+// (raquet_metrics(), read_raster's EXPLAIN ANALYZE output) sum all live
+// blocks plus the totals folded in from threads that already exited.
+//
+// Counters are process-wide and monotonic. "Resetting" moves a baseline
+// instead of zeroing slots, so a reset never races with a writer.
+// ─────────────────────────────────────────────
+enum class Metric : uint8_t {
+    TILES_DECODED = 0,      // band blobs run through a decompressor
+    COMPRESSED_BYTES,       // bytes fed into decompressors
+    DECOMPRESSED_BYTES,     // bytes produced by decompressors
+    DECODE_NS,              // wall time spent decompressing
+    METADATA_PARSES,        // full parse_metadata() runs
+    METADATA_CACHE_HITS,    // parse_metadata_cached() served from cache
+    PIP_TESTS,              // point-in-polygon tests (region stats, clip)
+    TILES_SKIPPED_SPARSE,   // read_raster tiles dropped as empty/outside
+    WARP_NS,                // wall time in GDAL warp (read_raster)
+    COMPRESS_NS,            // wall time in band encoders
+    INIT_NS,                // one-time GDAL driver registration and proj.db inflate
+};
+
+static constexpr size_t METRIC_COUNT = static_cast<size_t>(Metric::INIT_NS) + 1;
+
+// Stable SQL-facing name ("tiles_decoded", ...) and unit ("count", "bytes", "ns").
+const char *metric_name(Metric m);
+const char *metric_unit(Metric m);
+
+struct ThreadMetrics {
+    std::atomic<uint64_t> values[METRIC_COUNT];
+
+    ThreadMetrics();
+    ~ThreadMetrics();
+    ThreadMetrics(const ThreadMetrics &) = delete;
+    ThreadMetrics &operator=(const ThreadMetrics &) = delete;
+};
+
+// The calling thread's counter block.
+ThreadMetrics &thread_metrics();
+
+inline void metric_add(Metric m, uint64_t delta) {
+    auto &slot = thread_metrics().values[static_cast<size_t>(m)];
+    // Single writer per slot: a plain load+store is enough; atomics only make
+    // concurrent snapshot reads well-defined.
+    slot.store(slot.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+// Totals since the last metrics_reset(), indexed by Metric.
+std::vector<uint64_t> metrics_snapshot();
+
+// Move the baseline to the current totals.
+void metrics_reset();
+
+// RAII wall-clock timer that adds elapsed nanoseconds to a *_NS metric.
+class ScopedMetricTimer {
+public:
+    explicit ScopedMetricTimer(Metric m)
+        : metric_(m), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedMetricTimer() {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start_).count();
+        metric_add(metric_, static_cast<uint64_t>(ns));
+    }
+    ScopedMetricTimer(const ScopedMetricTimer &) = delete;
+    ScopedMetricTimer &operator=(const ScopedMetricTimer &) = delete;
+
+private:
+    Metric metric_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace raquet
+} // namespace duckdb
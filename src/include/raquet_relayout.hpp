@@ -0,0 +1,19 @@
+#pragma once
+
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+// Registers the `raquet_relayout(raster, [band_layout := ...],
+// [compression := ...], [quality := ...], [predictor := ...])` table
+// function.
+//
+// Re-encodes a raquet file without its source raster: switches between
+// sequential band_1..band_N columns and one interleaved `pixels` column,
+// and/or changes codec (gzip/zstd/lz4/auto/none, jpeg/webp for interleaved
+// uint8). Tiles are streamed, decoded once, interleaved or deinterleaved
+// with the SIMD kernels and re-encoded in parallel. Returns the new file's
+// rows (metadata row at block=0 first) for COPY ... TO.
+void RegisterRelayoutFunction(ExtensionLoader &loader);
+
+}  // namespace duckdb
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+// Registers the `raquet_tile(raster, z, x, y, [bands := [...]],
+// [resampling := 'nearest'])` table function.
+//
+// One XYZ tile at any zoom: the stored tile when the pyramid has it,
+// otherwise the 2x2 children one level down reduced in memory, or a crop of
+// the nearest ancestor scaled up (overzoom past max_zoom included). Band
+// blobs come back encoded like the file's own tiles, so the row works with
+// the ST_* functions and the file's metadata. Parsed metadata is cached per
+// file (revalidated by modification time), so a warm request reads one tile.
+void RegisterTileFunction(ExtensionLoader &loader);
+
+}  // namespace duckdb
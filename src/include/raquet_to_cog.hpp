@@ -0,0 +1,19 @@
+#pragma once
+
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+// Registers the `raquet_to_cog(raster, output, [bands := [...]],
+// [compression := 'deflate'], [predictor := file's], [bigtiff := auto])`
+// table function.
+//
+// Writes a Cloud-Optimized GeoTIFF (EPSG:3857) whose internal tiles are the
+// raquet blocks and whose overviews are the raquet pyramid levels, one to
+// one: no warp and no full-raster buffer. Tiles are decoded and
+// recompressed in parallel, deflate tiles whose encoding already matches are
+// copied byte for byte, and missing or all-nodata tiles stay sparse.
+// Returns one summary row.
+void RegisterToCogFunction(ExtensionLoader &loader);
+
+}  // namespace duckdb
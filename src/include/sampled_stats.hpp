@@ -0,0 +1,18 @@
+#pragma once
+
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+// Registers the `ST_RasterStatsSampled(raster, band, fraction, [seed := 0],
+// [quantiles := [...]], [confidence := 0.95], [resolution := max_zoom])`
+// table function.
+//
+// Approximate band statistics from a stratified random sample of tiles:
+// only the block column is scanned to list the tiles of one pyramid level,
+// one tile is drawn from each run of consecutive blocks (Morton order, so
+// runs are spatial strata), and only the drawn tiles' band column is read.
+// Returns mean, stddev and quantiles with confidence intervals.
+void RegisterSampledStatsFunction(ExtensionLoader &loader);
+
+}  // namespace duckdb
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+namespace raquet {
+
+// Minimal little-endian tiled (Big)TIFF directory writer for Cloud-Optimized
+// GeoTIFF export. The caller lays the file out as: header and every IFD up
+// front (serialize_tiff_directories), then tile data. IFD sizes do not depend
+// on the tile offsets, so the directory block can be sized first, the tiles
+// streamed after it, and the directories written last with the real offsets.
+
+// TIFF tag values used by the exporter
+constexpr uint16_t TIFF_COMPRESSION_NONE = 1;
+constexpr uint16_t TIFF_COMPRESSION_DEFLATE = 8;
+constexpr uint16_t TIFF_PHOTOMETRIC_MINISBLACK = 1;
+constexpr uint16_t TIFF_PHOTOMETRIC_RGB = 2;
+constexpr uint16_t TIFF_PLANAR_CONTIG = 1;
+constexpr uint16_t TIFF_PLANAR_SEPARATE = 2;
+constexpr uint16_t TIFF_SAMPLE_UINT = 1;
+constexpr uint16_t TIFF_SAMPLE_INT = 2;
+constexpr uint16_t TIFF_SAMPLE_FLOAT = 3;
+
+// One tiled image: the full-resolution raster or one overview
+struct TiffImage {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t tile_width = 0;
+    uint32_t tile_height = 0;
+    uint16_t samples_per_pixel = 1;
+    uint16_t bits_per_sample = 8;
+    uint16_t sample_format = TIFF_SAMPLE_UINT;
+    uint16_t planar_config = TIFF_PLANAR_SEPARATE;
+    uint16_t photometric = TIFF_PHOTOMETRIC_MINISBLACK;
+    std::vector<uint16_t> extra_samples;  // one per sample beyond the photometric ones
+    uint16_t compression = TIFF_COMPRESSION_DEFLATE;
+    uint16_t predictor = 1;
+    bool overview = false;  // NewSubfileType = 1 (reduced resolution)
+
+    // Row-major tiles, all planes of the first sample before the next when
+    // planar_config is separate. Offset and byte count 0 mark a sparse tile.
+    std::vector<uint64_t> tile_offsets;
+    std::vector<uint64_t> tile_byte_counts;
+
+    // GeoTIFF georeferencing and GDAL nodata; set on the full-resolution image
+    std::vector<double> model_pixel_scale;  // ModelPixelScaleTag
+    std::vector<double> model_tiepoint;     // ModelTiepointTag
+    std::vector<uint16_t> geo_key_directory;
+    std::string gdal_nodata;                // empty for none
+
+    uint64_t TilesAcross() const {
+        return (static_cast<uint64_t>(width) + tile_width - 1) / tile_width;
+    }
+    uint64_t TilesDown() const {
+        return (static_cast<uint64_t>(height) + tile_height - 1) / tile_height;
+    }
+    uint64_t TileCount() const {
+        uint64_t planes = planar_config == TIFF_PLANAR_SEPARATE ? samples_per_pixel : 1;
+        return TilesAcross() * TilesDown() * planes;
+    }
+};
+
+// File header followed by the chained IFDs of `images` (in order, the first
+// being the full-resolution image) and their out-of-line tag data. The size
+// depends only on the images' shapes and tags, not on the offset values.
+std::vector<uint8_t> serialize_tiff_directories(const std::vector<TiffImage> &images, bool bigtiff);
+
+} // namespace raquet
+} // namespace duckdb
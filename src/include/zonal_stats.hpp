@@ -0,0 +1,18 @@
+#pragma once
+
+#include "duckdb/main/extension/extension_loader.hpp"
+
+namespace duckdb {
+
+// Registers the `raquet_zonal_stats(raster, polygons_table, id_col,
+// geom_col, [bands := [...]], [stats := [...]])` table function.
+//
+// Zonal statistics of many polygons over one raquet file in a single
+// pass: polygons are parsed once and filed under a compact quadbin cover
+// (coarse cells inside, max_zoom cells only along edges), each tile is
+// read and decoded once for all of the polygons over it, and each polygon is scanline-rasterized once per tile
+// (pixel centres, same inside test as ST_RegionStats). Tiles are
+// folded by DuckDB's worker threads. Returns one row per (polygon, band).
+void RegisterZonalStatsFunction(ExtensionLoader &loader);
+
+}  // namespace duckdb
@@ -54,11 +54,17 @@ static void RaquetValidateMetadataFunction(DataChunk &args, ExpressionState &sta
             }
 
             // Validate compression
-            if (meta.compression != "gzip" && meta.compression != "jpeg" &&
+            if (meta.compression != "gzip" && meta.compression != "zstd" &&
+                meta.compression != "lz4" && meta.compression != "jpeg" &&
                 meta.compression != "webp" && meta.compression != "none" &&
+                meta.compression != "auto" &&
                 !meta.compression.empty()) {
                 warnings.push_back("Unknown compression: " + meta.compression);
             }
+            if (meta.compression_predictor < 1 || meta.compression_predictor > 3) {
+                warnings.push_back("Unknown compression_predictor: " +
+                                   std::to_string(meta.compression_predictor));
+            }
 
             // Validate tiling
             if (meta.scheme != "quadbin" && !meta.scheme.empty()) {
@@ -101,6 +107,13 @@ static void RaquetValidateMetadataFunction(DataChunk &args, ExpressionState &sta
                 }
             }
 
+            for (auto &bi : meta.band_info) {
+                if (bi.compression_dictionary && meta.compression != "gzip") {
+                    warnings.push_back("Band '" + bi.name + "' has a compression_dictionary but compression is '" +
+                                       meta.compression + "' (dictionaries apply to gzip only)");
+                }
+            }
+
             // Validate band_layout
             if (meta.band_layout != "sequential" && meta.band_layout != "interleaved") {
                 warnings.push_back("Unknown band_layout: " + meta.band_layout);
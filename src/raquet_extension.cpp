@@ -25,9 +25,16 @@ void RegisterRasterStatsFunctions(ExtensionLoader &loader);
 void RegisterRegionStatsFunctions(ExtensionLoader &loader);
 void RegisterClipFunctions(ExtensionLoader &loader);
 void RegisterBandMathFunctions(ExtensionLoader &loader);
+void RegisterAsImageFunctions(ExtensionLoader &loader);
 void RegisterMetadataFunctions(ExtensionLoader &loader);
 void RegisterRaquetTableFunctions(ExtensionLoader &loader);
 void RegisterMergeBandsFunction(ExtensionLoader &loader);
+void RegisterZonalStatsFunction(ExtensionLoader &loader);
+void RegisterSampledStatsFunction(ExtensionLoader &loader);
+void RegisterTileFunction(ExtensionLoader &loader);
+void RegisterToCogFunction(ExtensionLoader &loader);
+void RegisterRelayoutFunction(ExtensionLoader &loader);
+void RegisterMetricsFunctions(ExtensionLoader &loader);
 
 // Table macro definitions for read_raquet with spatial filtering overloads
 // v0.3.0 format: metadata is in a row where block=0, data rows have block!=0
@@ -43,12 +50,14 @@ static const DefaultTableMacro RAQUET_TABLE_MACROS[] = {
         WHERE block != 0
      )"},
 
-    // 2-arg: Spatial filter with auto-detected max resolution from metadata
-    // Reads max_zoom from block=0 metadata (fast) instead of scanning all block values
-    {DEFAULT_SCHEMA, "read_raquet", {"file", "geometry", nullptr}, {{nullptr, nullptr}},
+    // 2-arg: Spatial filter with the pyramid level picked from block=0 metadata (fast)
+    // instead of scanning all block values. Defaults to max_zoom; max_tiles and
+    // target_pixel_size select a coarser level (see raquet_pick_resolution)
+    {DEFAULT_SCHEMA, "read_raquet", {"file", "geometry", nullptr},
+     {{"max_tiles", "NULL"}, {"target_pixel_size", "NULL"}, {nullptr, nullptr}},
      R"(
         WITH file_resolution AS (
-            SELECT (raquet_parse_metadata(metadata)).max_zoom AS res
+            SELECT raquet_pick_resolution(metadata, geometry, max_tiles, target_pixel_size) AS res
             FROM read_parquet(file)
             WHERE block = 0
             LIMIT 1
@@ -114,12 +123,13 @@ static const DefaultTableMacro RAQUET_FROM_TABLE_MACROS[] = {
         WHERE block != 0
      )"},
 
-    // 2-arg: Spatial filter with auto-detected max resolution
-    {DEFAULT_SCHEMA, "ST_Raster", {"tbl", "geometry", nullptr}, {{nullptr, nullptr}},
+    // 2-arg: Spatial filter with the pyramid level picked from metadata (max_zoom by default)
+    {DEFAULT_SCHEMA, "ST_Raster", {"tbl", "geometry", nullptr},
+     {{"max_tiles", "NULL"}, {"target_pixel_size", "NULL"}, {nullptr, nullptr}},
      R"(
         WITH src AS (SELECT * FROM query_table(tbl)),
         table_resolution AS (
-            SELECT (raquet_parse_metadata(metadata)).max_zoom AS res
+            SELECT raquet_pick_resolution(metadata, geometry, max_tiles, target_pixel_size) AS res
             FROM src
             WHERE block = 0
             LIMIT 1
@@ -276,6 +286,16 @@ static unique_ptr<MacroFunction> CreateTableMacroFunction(const DefaultTableMacr
         function->parameters.push_back(make_uniq<ColumnRefExpression>(default_macro.parameters[param_idx]));
     }
 
+    // Add named parameters with their default values
+    for (idx_t named_idx = 0; default_macro.named_parameters[named_idx].name != nullptr; named_idx++) {
+        auto expr_list = Parser::ParseExpressionList(default_macro.named_parameters[named_idx].default_value);
+        if (expr_list.size() != 1) {
+            throw InternalException("Expected a single expression for a table macro default value");
+        }
+        function->default_parameters.insert(
+            make_pair(default_macro.named_parameters[named_idx].name, std::move(expr_list[0])));
+    }
+
     return function;
 }
 
@@ -362,9 +382,16 @@ static void LoadInternal(ExtensionLoader &loader) {
     RegisterRegionStatsFunctions(loader);
     RegisterClipFunctions(loader);
     RegisterBandMathFunctions(loader);
+    RegisterAsImageFunctions(loader);
     RegisterMetadataFunctions(loader);
     RegisterRaquetTableFunctions(loader);
     RegisterMergeBandsFunction(loader);
+    RegisterZonalStatsFunction(loader);
+    RegisterSampledStatsFunction(loader);
+    RegisterTileFunction(loader);
+    RegisterToCogFunction(loader);
+    RegisterRelayoutFunction(loader);
+    RegisterMetricsFunctions(loader);
 
     // Register read_raquet table macro with all overloads
     auto macro_info = CreateReadRaquetMacroInfo();
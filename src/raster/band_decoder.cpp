@@ -1,5 +1,8 @@
 #include "band_decoder.hpp"
+#include "band_interleave.hpp"
+#include "raquet_metrics.hpp"
 #include <zlib.h>
+#include <algorithm>
 #include <stdexcept>
 #include <cstring>
 #include <vector>
@@ -17,10 +20,31 @@
 #include <webp/decode.h>
 #endif
 
+// Optional Zstandard support
+#ifdef RAQUET_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+// Optional LZ4 support (frame format)
+#ifdef RAQUET_HAS_LZ4
+#include <lz4frame.h>
+#endif
+
+// Byte-plane unshuffle for the floating-point predictor. SSE2 and NEON are
+// baseline on x86-64 and AArch64, so no runtime dispatch is needed.
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define RAQUET_SIMD_SSE2 1
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define RAQUET_SIMD_NEON 1
+#endif
+
 namespace duckdb {
 namespace raquet {
 
-std::vector<uint8_t> decompress_gzip(const uint8_t *data, size_t size) {
+std::vector<uint8_t> decompress_gzip(const uint8_t *data, size_t size,
+                                     const std::vector<uint8_t> *dictionary) {
     if (size == 0) {
         return {};
     }
@@ -29,6 +53,8 @@ std::vector<uint8_t> decompress_gzip(const uint8_t *data, size_t size) {
         throw std::runtime_error("Null data pointer for decompression");
     }
 
+    ScopedMetricTimer timer(Metric::DECODE_NS);
+
     // For gzip: estimate decompressed size
     // A 256x256 tile with uint16 = 131072 bytes, float64 = 524288 bytes
     // Start with a larger initial estimate to avoid resizes
@@ -68,6 +94,20 @@ std::vector<uint8_t> decompress_gzip(const uint8_t *data, size_t size) {
             continue;
         }
 
+        if (ret == Z_NEED_DICT) {
+            // zlib stream with FDICT set: written with a preset dictionary
+            if (!dictionary || dictionary->empty()) {
+                inflateEnd(&strm);
+                throw std::runtime_error("gzip tile needs a preset dictionary the metadata does not provide");
+            }
+            ret = inflateSetDictionary(&strm, dictionary->data(), static_cast<uInt>(dictionary->size()));
+            if (ret != Z_OK) {
+                inflateEnd(&strm);
+                throw std::runtime_error("gzip tile was written with a different preset dictionary");
+            }
+            continue;
+        }
+
         if (ret != Z_OK && ret != Z_STREAM_END) {
             inflateEnd(&strm);
             throw std::runtime_error("inflate failed: " + std::to_string(ret));
@@ -78,13 +118,564 @@ std::vector<uint8_t> decompress_gzip(const uint8_t *data, size_t size) {
     inflateEnd(&strm);
 
     result.resize(decompressed_size);
+
+    metric_add(Metric::TILES_DECODED, 1);
+    metric_add(Metric::COMPRESSED_BYTES, size);
+    metric_add(Metric::DECOMPRESSED_BYTES, decompressed_size);
+    return result;
+}
+
+std::vector<uint8_t> decompress_zstd(const uint8_t *data, size_t size, size_t max_size) {
+#ifdef RAQUET_HAS_ZSTD
+    if (size == 0) {
+        return {};
+    }
+    if (data == nullptr) {
+        throw std::runtime_error("Null data pointer for decompression");
+    }
+
+    ScopedMetricTimer timer(Metric::DECODE_NS);
+
+    // The encoder always writes the content size into the frame header
+    unsigned long long content_size = ZSTD_getFrameContentSize(data, size);
+    if (content_size == ZSTD_CONTENTSIZE_ERROR) {
+        throw std::runtime_error("Invalid zstd frame");
+    }
+    if (content_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+        throw std::runtime_error("zstd frame is missing its content size");
+    }
+    // The header is untrusted: never allocate more than a tile can hold
+    if (content_size > max_size) {
+        throw std::runtime_error("zstd frame declares " + std::to_string(content_size) +
+                                 " bytes, more than the " + std::to_string(max_size) + "-byte tile");
+    }
+
+    std::vector<uint8_t> result(static_cast<size_t>(content_size));
+    size_t ret = ZSTD_decompress(result.data(), result.size(), data, size);
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error(std::string("zstd decompression failed: ") + ZSTD_getErrorName(ret));
+    }
+    result.resize(ret);
+
+    metric_add(Metric::TILES_DECODED, 1);
+    metric_add(Metric::COMPRESSED_BYTES, size);
+    metric_add(Metric::DECOMPRESSED_BYTES, ret);
+    return result;
+#else
+    (void)data; (void)size; (void)max_size;
+    throw std::runtime_error("zstd decompression not available: compile with RAQUET_HAS_ZSTD");
+#endif
+}
+
+std::vector<uint8_t> decompress_lz4(const uint8_t *data, size_t size, size_t max_size) {
+#ifdef RAQUET_HAS_LZ4
+    if (size == 0) {
+        return {};
+    }
+    if (data == nullptr) {
+        throw std::runtime_error("Null data pointer for decompression");
+    }
+
+    ScopedMetricTimer timer(Metric::DECODE_NS);
+
+    LZ4F_dctx *dctx = nullptr;
+    if (LZ4F_isError(LZ4F_createDecompressionContext(&dctx, LZ4F_VERSION))) {
+        throw std::runtime_error("LZ4F_createDecompressionContext failed");
+    }
+
+    LZ4F_frameInfo_t info;
+    memset(&info, 0, sizeof(info));
+    size_t consumed = size;
+    size_t hint = LZ4F_getFrameInfo(dctx, &info, data, &consumed);
+    if (LZ4F_isError(hint)) {
+        LZ4F_freeDecompressionContext(dctx);
+        throw std::runtime_error(std::string("Invalid LZ4 frame: ") + LZ4F_getErrorName(hint));
+    }
+
+    // The header is untrusted: never allocate more than a tile can hold.
+    // Same fallback estimate as gzip when the frame omits its content size.
+    if (info.contentSize > max_size) {
+        LZ4F_freeDecompressionContext(dctx);
+        throw std::runtime_error("LZ4 frame declares " + std::to_string(info.contentSize) +
+                                 " bytes, more than the " + std::to_string(max_size) + "-byte tile");
+    }
+    size_t capacity = info.contentSize > 0 ? static_cast<size_t>(info.contentSize)
+                                           : std::min<size_t>(256 * 256 * 8, std::max<size_t>(max_size, 1));
+    std::vector<uint8_t> result(capacity);
+    size_t in_pos = consumed;
+    size_t out_pos = 0;
+
+    while (hint != 0) {
+        if (out_pos == result.size()) {
+            if (result.size() >= max_size) {
+                LZ4F_freeDecompressionContext(dctx);
+                throw std::runtime_error("LZ4 frame inflates past the " + std::to_string(max_size) + "-byte tile");
+            }
+            result.resize(std::min(result.size() * 2, max_size));
+        }
+        size_t dst_size = result.size() - out_pos;
+        size_t src_size = size - in_pos;
+        hint = LZ4F_decompress(dctx, result.data() + out_pos, &dst_size,
+                               data + in_pos, &src_size, nullptr);
+        if (LZ4F_isError(hint)) {
+            LZ4F_freeDecompressionContext(dctx);
+            throw std::runtime_error(std::string("LZ4 decompression failed: ") + LZ4F_getErrorName(hint));
+        }
+        in_pos += src_size;
+        out_pos += dst_size;
+        if (hint != 0 && in_pos >= size && dst_size == 0) {
+            LZ4F_freeDecompressionContext(dctx);
+            throw std::runtime_error("Truncated LZ4 frame");
+        }
+    }
+    LZ4F_freeDecompressionContext(dctx);
+    result.resize(out_pos);
+
+    metric_add(Metric::TILES_DECODED, 1);
+    metric_add(Metric::COMPRESSED_BYTES, size);
+    metric_add(Metric::DECOMPRESSED_BYTES, out_pos);
     return result;
+#else
+    (void)data; (void)size; (void)max_size;
+    throw std::runtime_error("LZ4 decompression not available: compile with RAQUET_HAS_LZ4");
+#endif
+}
+
+template <typename T>
+static void undo_predictor_rows(uint8_t *data, size_t size, int width, int samples) {
+    size_t row_elems = static_cast<size_t>(width) * samples;
+    size_t row_bytes = row_elems * sizeof(T);
+    if (row_elems == 0) {
+        return;
+    }
+    for (size_t row = 0; row + row_bytes <= size; row += row_bytes) {
+        uint8_t *p = data + row;
+        for (size_t i = samples; i < row_elems; i++) {
+            T prev, cur;
+            memcpy(&prev, p + (i - samples) * sizeof(T), sizeof(T));
+            memcpy(&cur, p + i * sizeof(T), sizeof(T));
+            cur = static_cast<T>(cur + prev);
+            memcpy(p + i * sizeof(T), &cur, sizeof(T));
+        }
+    }
+}
+
+void undo_horizontal_predictor(uint8_t *data, size_t size, size_t elem_size,
+                               int width, int samples_per_pixel) {
+    if (width <= 0 || samples_per_pixel <= 0) {
+        throw std::invalid_argument("Invalid predictor row geometry");
+    }
+    switch (elem_size) {
+        case 1: undo_predictor_rows<uint8_t>(data, size, width, samples_per_pixel); break;
+        case 2: undo_predictor_rows<uint16_t>(data, size, width, samples_per_pixel); break;
+        case 4: undo_predictor_rows<uint32_t>(data, size, width, samples_per_pixel); break;
+        case 8: undo_predictor_rows<uint64_t>(data, size, width, samples_per_pixel); break;
+        default:
+            throw std::invalid_argument("Unsupported element size for predictor: " + std::to_string(elem_size));
+    }
+}
+
+// Interleave `count` elements from byte planes (plane 0 = most significant
+// byte) back into little-endian elements of `elem_size` bytes.
+static void unshuffle_byte_planes(const uint8_t *planes, size_t count, size_t elem_size, uint8_t *out) {
+    size_t i = 0;
+#if defined(RAQUET_SIMD_SSE2)
+    if (elem_size == 4) {
+        const uint8_t *b0 = planes + 3 * count;  // least significant byte
+        const uint8_t *b1 = planes + 2 * count;
+        const uint8_t *b2 = planes + count;
+        const uint8_t *b3 = planes;
+        for (; i + 16 <= count; i += 16) {
+            __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b0 + i));
+            __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b1 + i));
+            __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b2 + i));
+            __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b3 + i));
+            __m128i lo01 = _mm_unpacklo_epi8(v0, v1);
+            __m128i hi01 = _mm_unpackhi_epi8(v0, v1);
+            __m128i lo23 = _mm_unpacklo_epi8(v2, v3);
+            __m128i hi23 = _mm_unpackhi_epi8(v2, v3);
+            __m128i *o = reinterpret_cast<__m128i *>(out + i * 4);
+            _mm_storeu_si128(o + 0, _mm_unpacklo_epi16(lo01, lo23));
+            _mm_storeu_si128(o + 1, _mm_unpackhi_epi16(lo01, lo23));
+            _mm_storeu_si128(o + 2, _mm_unpacklo_epi16(hi01, hi23));
+            _mm_storeu_si128(o + 3, _mm_unpackhi_epi16(hi01, hi23));
+        }
+    } else if (elem_size == 8) {
+        const uint8_t *b[8];
+        for (int j = 0; j < 8; j++) {
+            b[j] = planes + (7 - j) * count;
+        }
+        for (; i + 16 <= count; i += 16) {
+            __m128i v[8];
+            for (int j = 0; j < 8; j++) {
+                v[j] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b[j] + i));
+            }
+            __m128i *o = reinterpret_cast<__m128i *>(out + i * 8);
+            for (int half = 0; half < 2; half++) {
+                // Byte pairs for 8 elements, then 4-byte quads, then 8-byte elements
+                __m128i p01 = half ? _mm_unpackhi_epi8(v[0], v[1]) : _mm_unpacklo_epi8(v[0], v[1]);
+                __m128i p23 = half ? _mm_unpackhi_epi8(v[2], v[3]) : _mm_unpacklo_epi8(v[2], v[3]);
+                __m128i p45 = half ? _mm_unpackhi_epi8(v[4], v[5]) : _mm_unpacklo_epi8(v[4], v[5]);
+                __m128i p67 = half ? _mm_unpackhi_epi8(v[6], v[7]) : _mm_unpacklo_epi8(v[6], v[7]);
+                __m128i q_lo_0123 = _mm_unpacklo_epi16(p01, p23);
+                __m128i q_hi_0123 = _mm_unpackhi_epi16(p01, p23);
+                __m128i q_lo_4567 = _mm_unpacklo_epi16(p45, p67);
+                __m128i q_hi_4567 = _mm_unpackhi_epi16(p45, p67);
+                _mm_storeu_si128(o + half * 4 + 0, _mm_unpacklo_epi32(q_lo_0123, q_lo_4567));
+                _mm_storeu_si128(o + half * 4 + 1, _mm_unpackhi_epi32(q_lo_0123, q_lo_4567));
+                _mm_storeu_si128(o + half * 4 + 2, _mm_unpacklo_epi32(q_hi_0123, q_hi_4567));
+                _mm_storeu_si128(o + half * 4 + 3, _mm_unpackhi_epi32(q_hi_0123, q_hi_4567));
+            }
+        }
+    }
+#elif defined(RAQUET_SIMD_NEON)
+    if (elem_size == 4) {
+        for (; i + 16 <= count; i += 16) {
+            uint8x16x4_t v;
+            v.val[0] = vld1q_u8(planes + 3 * count + i);
+            v.val[1] = vld1q_u8(planes + 2 * count + i);
+            v.val[2] = vld1q_u8(planes + count + i);
+            v.val[3] = vld1q_u8(planes + i);
+            vst4q_u8(out + i * 4, v);
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        for (size_t j = 0; j < elem_size; j++) {
+            out[i * elem_size + j] = planes[(elem_size - 1 - j) * count + i];
+        }
+    }
+}
+
+void undo_float_predictor(uint8_t *data, size_t size, size_t elem_size,
+                          int width, int samples_per_pixel) {
+    if (width <= 0 || samples_per_pixel <= 0) {
+        throw std::invalid_argument("Invalid predictor row geometry");
+    }
+    if (elem_size != 2 && elem_size != 4 && elem_size != 8) {
+        throw std::invalid_argument("Floating-point predictor needs a 2, 4 or 8 byte type, got " +
+                                    std::to_string(elem_size));
+    }
+    size_t row_elems = static_cast<size_t>(width) * samples_per_pixel;
+    size_t row_bytes = row_elems * elem_size;
+    size_t stride = static_cast<size_t>(samples_per_pixel);
+    std::vector<uint8_t> planes(row_bytes);
+
+    for (size_t row = 0; row + row_bytes <= size; row += row_bytes) {
+        uint8_t *p = data + row;
+        for (size_t i = stride; i < row_bytes; i++) {
+            p[i] = static_cast<uint8_t>(p[i] + p[i - stride]);
+        }
+        memcpy(planes.data(), p, row_bytes);
+        unshuffle_byte_planes(planes.data(), row_elems, elem_size, p);
+    }
+}
+
+// Expand unsigned integer codes in `buf` to little-endian floats in place
+// (back to front, since the float elements are at least as wide).
+template <typename CodeT, typename FloatT>
+static void DequantizeInto(std::vector<uint8_t> &buf, size_t count, const BandCodec &codec) {
+    buf.resize(count * sizeof(FloatT));
+    const FloatT nodata = static_cast<FloatT>(codec.quant_nodata);
+    for (size_t i = count; i-- > 0;) {
+        CodeT q;
+        std::memcpy(&q, buf.data() + i * sizeof(CodeT), sizeof(CodeT));
+        FloatT v = static_cast<uint64_t>(q) == codec.quant_nodata_code
+                       ? nodata
+                       : static_cast<FloatT>(q * codec.quant_scale + codec.quant_offset);
+        std::memcpy(buf.data() + i * sizeof(FloatT), &v, sizeof(FloatT));
+    }
+}
+
+template <typename CodeT>
+static void DequantizeCodes(std::vector<uint8_t> &buf, size_t count, size_t elem_size,
+                            const BandCodec &codec) {
+    if (elem_size == 4) {
+        DequantizeInto<CodeT, float>(buf, count, codec);
+    } else {
+        DequantizeInto<CodeT, double>(buf, count, codec);
+    }
+}
+
+static void dequantize_band(std::vector<uint8_t> &buf, size_t stored_size, size_t elem_size,
+                            int samples_per_pixel, const BandCodec &codec) {
+    if (samples_per_pixel != 1) {
+        throw std::invalid_argument("Quantized bands require sequential band layout");
+    }
+    if (elem_size != 4 && elem_size != 8) {
+        throw std::invalid_argument("Quantized bands must decode to float32 or float64");
+    }
+    size_t count = buf.size() / stored_size;
+    switch (stored_size) {
+        case 1: DequantizeCodes<uint8_t>(buf, count, elem_size, codec); break;
+        case 2: DequantizeCodes<uint16_t>(buf, count, elem_size, codec); break;
+        case 4: DequantizeCodes<uint32_t>(buf, count, elem_size, codec); break;
+        default:
+            throw std::invalid_argument("Unsupported quantized type: " + codec.quant_type);
+    }
+}
+
+// ─────────────────────────────────────────────
+// Bit-packed bands (uint1/uint2/uint4)
+// ─────────────────────────────────────────────
+
+// Byte -> its 8 one-bit, 4 two-bit or 2 four-bit fields as bytes, MSB first
+struct UnpackTables {
+    uint8_t bits1[256][8];
+    uint8_t bits2[256][4];
+    uint8_t bits4[256][2];
+
+    UnpackTables() {
+        for (int b = 0; b < 256; b++) {
+            for (int i = 0; i < 8; i++) bits1[b][i] = static_cast<uint8_t>((b >> (7 - i)) & 0x1);
+            for (int i = 0; i < 4; i++) bits2[b][i] = static_cast<uint8_t>((b >> (6 - 2 * i)) & 0x3);
+            for (int i = 0; i < 2; i++) bits4[b][i] = static_cast<uint8_t>((b >> (4 - 4 * i)) & 0xF);
+        }
+    }
+};
+
+static const UnpackTables &GetUnpackTables() {
+    static const UnpackTables tables;
+    return tables;
+}
+
+// One 1-bit row: 16 pixels (two packed bytes) per vector step
+static void unpack_row_bits1(const uint8_t *src, int width, uint8_t *dst, const UnpackTables &tables) {
+    int x = 0;
+#if defined(RAQUET_SIMD_SSE2)
+    const __m128i select = _mm_setr_epi8(static_cast<char>(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                                         static_cast<char>(0x80), 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01);
+    const __m128i one = _mm_set1_epi8(1);
+    for (; x + 16 <= width; x += 16) {
+        __m128i v = _mm_unpacklo_epi64(_mm_set1_epi8(static_cast<char>(src[x / 8])),
+                                       _mm_set1_epi8(static_cast<char>(src[x / 8 + 1])));
+        __m128i bitset = _mm_cmpeq_epi8(_mm_and_si128(v, select), select);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x), _mm_and_si128(bitset, one));
+    }
+#elif defined(RAQUET_SIMD_NEON)
+    static const uint8_t select_bytes[16] = {0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01,
+                                             0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x01};
+    const uint8x16_t select = vld1q_u8(select_bytes);
+    const uint8x16_t one = vdupq_n_u8(1);
+    for (; x + 16 <= width; x += 16) {
+        uint8x16_t v = vcombine_u8(vdup_n_u8(src[x / 8]), vdup_n_u8(src[x / 8 + 1]));
+        vst1q_u8(dst + x, vandq_u8(vtstq_u8(v, select), one));
+    }
+#endif
+    for (; x + 8 <= width; x += 8) {
+        memcpy(dst + x, tables.bits1[src[x / 8]], 8);
+    }
+    for (; x < width; x++) {
+        dst[x] = tables.bits1[src[x / 8]][x % 8];
+    }
+}
+
+void unpack_bits(const uint8_t *packed, size_t packed_size, int bits, int width, int height, uint8_t *out) {
+    if (bits != 1 && bits != 2 && bits != 4) {
+        throw std::invalid_argument("Unsupported packed pixel width: " + std::to_string(bits) + " bits");
+    }
+    size_t row_bytes = packed_row_bytes(width, bits);
+    if (packed_size < row_bytes * height) {
+        throw std::out_of_range("Packed band data (" + std::to_string(packed_size) + " bytes) too small for " +
+                                std::to_string(width) + "x" + std::to_string(height) + " uint" +
+                                std::to_string(bits) + " tile");
+    }
+    const auto &tables = GetUnpackTables();
+    int per_byte = 8 / bits;
+    for (int y = 0; y < height; y++) {
+        const uint8_t *src = packed + static_cast<size_t>(y) * row_bytes;
+        uint8_t *dst = out + static_cast<size_t>(y) * width;
+        if (bits == 1) {
+            unpack_row_bits1(src, width, dst, tables);
+            continue;
+        }
+        int full = width / per_byte;
+        for (int i = 0; i < full; i++) {
+            memcpy(dst + i * per_byte, bits == 2 ? tables.bits2[src[i]] : tables.bits4[src[i]], per_byte);
+        }
+        for (int x = full * per_byte; x < width; x++) {
+            dst[x] = bits == 2 ? tables.bits2[src[x / 4]][x % 4] : tables.bits4[src[x / 2]][x % 2];
+        }
+    }
+}
+
+static inline uint64_t popcount64(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint64_t>(__builtin_popcountll(v));
+#else
+    v = v - ((v >> 1) & 0x5555555555555555ULL);
+    v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (v * 0x0101010101010101ULL) >> 56;
+#endif
+}
+
+static inline int leading_zeros64(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(v);
+#else
+    int n = 0;
+    while (!(v & 0x8000000000000000ULL)) {
+        v <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+uint64_t count_set_bits(const uint8_t *packed, size_t packed_size, int width, int height) {
+    size_t row_bytes = packed_row_bytes(width, 1);
+    if (packed_size < row_bytes * height) {
+        throw std::out_of_range("Packed band data too small for declared dimensions");
+    }
+    size_t full_bytes = static_cast<size_t>(width) / 8;
+    int tail_bits = width % 8;
+    uint64_t total = 0;
+    for (int y = 0; y < height; y++) {
+        const uint8_t *row = packed + static_cast<size_t>(y) * row_bytes;
+        size_t i = 0;
+        for (; i + 8 <= full_bytes; i += 8) {
+            uint64_t word;
+            memcpy(&word, row + i, 8);
+            total += popcount64(word);
+        }
+        for (; i < full_bytes; i++) {
+            total += popcount64(row[i]);
+        }
+        if (tail_bits) {
+            // Fields fill from the MSB; the low bits of the last byte are padding
+            total += popcount64(row[full_bytes] >> (8 - tail_bits));
+        }
+    }
+    return total;
+}
+
+// decode_band_bytes once markers and the codec byte are out of the way
+static const uint8_t *decode_band_payload(const uint8_t *data, size_t size, const BandCodec &codec,
+                                          size_t elem_size, int width, int height, int samples_per_pixel,
+                                          std::vector<uint8_t> &scratch, size_t &size_out) {
+    if (codec.is_raw()) {
+        size_out = size;
+        return data;
+    }
+
+    // Quantized blobs hold narrower integer codes; the predictor ran on those.
+    // Bit-packed rows are predicted as rows of bytes.
+    size_t stored_size = elem_size;
+    int stored_width = width;
+    if (codec.is_quantized()) {
+        stored_size = dtype_size(parse_dtype(codec.quant_type));
+    } else if (codec.packed_bits > 0) {
+        stored_size = 1;
+        stored_width = static_cast<int>(packed_row_bytes(width, codec.packed_bits));
+    }
+
+    // Codecs whose frames declare their own size are held to one tile of
+    // stored elements. Pixel lookups don't know the height; raquet tiles are
+    // square, so they bound by width.
+    const size_t rows = static_cast<size_t>(height > 0 ? height : width);
+    const size_t max_size = width > 0 ? static_cast<size_t>(stored_width) * rows * stored_size * samples_per_pixel
+                                      : std::numeric_limits<size_t>::max();
+
+    if (codec.compression == "gzip") {
+        scratch = decompress_gzip(data, size, codec.dictionary.get());
+    } else if (codec.compression == "zstd") {
+        scratch = decompress_zstd(data, size, max_size);
+    } else if (codec.compression == "lz4") {
+        scratch = decompress_lz4(data, size, max_size);
+    } else if (codec.compression == "none") {
+        scratch.assign(data, data + size);
+    } else {
+        throw std::invalid_argument("Unknown compression: " + codec.compression);
+    }
+
+    if (codec.predictor == 2) {
+        undo_horizontal_predictor(scratch.data(), scratch.size(), stored_size, stored_width, samples_per_pixel);
+    } else if (codec.predictor == 3) {
+        undo_float_predictor(scratch.data(), scratch.size(), stored_size, stored_width, samples_per_pixel);
+    } else if (codec.predictor != 1) {
+        throw std::invalid_argument("Unsupported predictor: " + std::to_string(codec.predictor));
+    }
+
+    if (codec.is_quantized()) {
+        dequantize_band(scratch, stored_size, elem_size, samples_per_pixel, codec);
+    } else if (codec.packed_bits > 0 && !codec.keep_packed) {
+        if (samples_per_pixel != 1) {
+            throw std::invalid_argument("Bit-packed bands need the sequential band layout");
+        }
+        size_t row_bytes = packed_row_bytes(width, codec.packed_bits);
+        int rows = row_bytes ? static_cast<int>(scratch.size() / row_bytes) : 0;
+        std::vector<uint8_t> unpacked(static_cast<size_t>(width) * rows);
+        unpack_bits(scratch.data(), scratch.size(), codec.packed_bits, width, rows, unpacked.data());
+        scratch.swap(unpacked);
+    }
+
+    size_out = scratch.size();
+    return scratch.data();
+}
+
+const uint8_t *decode_band_bytes(const uint8_t *data, size_t size, const BandCodec &codec,
+                                 size_t elem_size, int width, int height, int samples_per_pixel,
+                                 std::vector<uint8_t> &scratch, size_t &size_out) {
+    resolve_tile_ref(data, size, codec);
+    ValidityMask mask;
+    split_validity_mask(data, size, codec, mask);
+    if (is_constant_tile(data, size, elem_size, codec)) {
+        if (width <= 0 || height <= 0 || samples_per_pixel != 1) {
+            throw std::invalid_argument("Constant tile needs tile dimensions and a single-band blob");
+        }
+        size_t count = static_cast<size_t>(width) * height;
+        const uint8_t *value = constant_tile_value(data);
+        scratch.resize(count * elem_size);
+        for (size_t i = 0; i < count; i++) {
+            memcpy(scratch.data() + i * elem_size, value, elem_size);
+        }
+        size_out = scratch.size();
+        return scratch.data();
+    }
+
+    if (codec.compression == "auto") {
+        if (size == 0) {
+            throw std::invalid_argument("Empty blob has no per-tile codec byte");
+        }
+        BandCodec tile_codec = auto_tile_codec(data[0], codec);
+        return decode_band_payload(data + 1, size - 1, tile_codec, elem_size, width, height,
+                                   samples_per_pixel, scratch, size_out);
+    }
+    return decode_band_payload(data, size, codec, elem_size, width, height, samples_per_pixel, scratch, size_out);
+}
+
+const uint8_t *decode_validity_mask(const ValidityMask &mask, const BandCodec &codec, int width, int height,
+                                    std::vector<uint8_t> &scratch, size_t &size_out) {
+    BandCodec mask_codec(codec.compression);
+    mask_codec.packed_bits = 1;
+    mask_codec.keep_packed = true;
+    const uint8_t *bits = decode_band_bytes(mask.data, mask.size, mask_codec, 1, width, height, 1,
+                                            scratch, size_out);
+    if (size_out < packed_row_bytes(width, 1) * height) {
+        throw std::out_of_range("Validity mask too small for declared dimensions");
+    }
+    return bits;
+}
+
+bool tile_all_nodata(const uint8_t *data, size_t size, const BandCodec &codec, int width, int height,
+                     bool has_nodata, double nodata) {
+    resolve_tile_ref(data, size, codec);
+    ValidityMask mask;
+    if (!split_validity_mask(data, size, codec, mask) || !validity_mask_applies(mask, has_nodata, nodata)) {
+        return false;
+    }
+    std::vector<uint8_t> scratch;
+    size_t mask_bytes;
+    const uint8_t *bits = decode_validity_mask(mask, codec, width, height, scratch, mask_bytes);
+    return count_set_bits(bits, mask_bytes, width, height) == 0;
 }
 
 // v0.4.0: JPEG decompression
 std::vector<uint8_t> decompress_jpeg(const uint8_t *data, size_t size,
                                       int &width_out, int &height_out, int &channels_out) {
 #ifdef RAQUET_HAS_JPEG
+    ScopedMetricTimer timer(Metric::DECODE_NS);
     struct jpeg_decompress_struct cinfo;
     struct jpeg_error_mgr jerr;
 
@@ -117,6 +708,9 @@ std::vector<uint8_t> decompress_jpeg(const uint8_t *data, size_t size,
     jpeg_finish_decompress(&cinfo);
     jpeg_destroy_decompress(&cinfo);
 
+    metric_add(Metric::TILES_DECODED, 1);
+    metric_add(Metric::COMPRESSED_BYTES, size);
+    metric_add(Metric::DECOMPRESSED_BYTES, result.size());
     return result;
 #else
     (void)data; (void)size;
@@ -129,6 +723,7 @@ std::vector<uint8_t> decompress_jpeg(const uint8_t *data, size_t size,
 std::vector<uint8_t> decompress_webp(const uint8_t *data, size_t size,
                                       int &width_out, int &height_out, int &channels_out) {
 #ifdef RAQUET_HAS_WEBP
+    ScopedMetricTimer timer(Metric::DECODE_NS);
     // Get image info first
     if (!WebPGetInfo(data, size, &width_out, &height_out)) {
         throw std::runtime_error("Invalid WebP image");
@@ -145,6 +740,9 @@ std::vector<uint8_t> decompress_webp(const uint8_t *data, size_t size,
     }
 
     channels_out = 4;  // RGBA
+    metric_add(Metric::TILES_DECODED, 1);
+    metric_add(Metric::COMPRESSED_BYTES, size);
+    metric_add(Metric::DECOMPRESSED_BYTES, result.size());
     return result;
 #else
     (void)data; (void)size;
@@ -153,28 +751,45 @@ std::vector<uint8_t> decompress_webp(const uint8_t *data, size_t size,
 #endif
 }
 
+// Callers that only pass a dtype still get bit-packed bands unpacked
+static const BandCodec &with_packed_bits(const BandCodec &codec, const std::string &dtype_str,
+                                         BandCodec &storage) {
+    int bits = packed_bits_of(dtype_str);
+    if (bits == 0 || codec.packed_bits == bits) {
+        return codec;
+    }
+    storage = codec;
+    storage.packed_bits = bits;
+    return storage;
+}
+
 double decode_pixel(const uint8_t *band_data, size_t band_size,
                     const std::string &dtype_str,
                     int pixel_x, int pixel_y, int width,
-                    bool compressed) {
+                    const BandCodec &codec) {
     BandDataType dtype = parse_dtype(dtype_str);
 
     if (pixel_x < 0 || pixel_y < 0 || width <= 0) {
         throw std::out_of_range("Invalid pixel coordinates or width");
     }
 
-    const uint8_t *data;
+    resolve_tile_ref(band_data, band_size, codec);
+    // The band blob behind a mask is not split again
+    ValidityMask mask;
+    BandCodec band_codec = codec;
+    if (split_validity_mask(band_data, band_size, codec, mask)) {
+        band_codec.validity_mask = false;
+    }
+    if (is_constant_tile(band_data, band_size, dtype_size(dtype), codec)) {
+        return get_pixel_value(constant_tile_value(band_data), dtype_size(dtype), 0, dtype);
+    }
+
+    // Height is not needed: constant tiles, the only blobs that use it, returned above
+    BandCodec packed_codec;
     size_t data_size;
     std::vector<uint8_t> decompressed;
-
-    if (compressed) {
-        decompressed = decompress_gzip(band_data, band_size);
-        data = decompressed.data();
-        data_size = decompressed.size();
-    } else {
-        data = band_data;
-        data_size = band_size;
-    }
+    const uint8_t *data = decode_band_bytes(band_data, band_size, with_packed_bits(band_codec, dtype_str, packed_codec),
+                                            dtype_size(dtype), width, 0, 1, decompressed, data_size);
 
     // Row-major order: offset = y * width + x
     size_t offset = static_cast<size_t>(pixel_y) * width + pixel_x;
@@ -185,27 +800,26 @@ double decode_pixel(const uint8_t *band_data, size_t band_size,
 std::vector<double> decode_band(const uint8_t *band_data, size_t band_size,
                                  const std::string &dtype_str,
                                  int width, int height,
-                                 bool compressed) {
+                                 const BandCodec &codec) {
     BandDataType dtype = parse_dtype(dtype_str);
 
     if (width <= 0 || height <= 0) {
         throw std::invalid_argument("Invalid band dimensions");
     }
 
-    const uint8_t *data;
+    size_t pixel_count = static_cast<size_t>(width) * height;
+    resolve_tile_ref(band_data, band_size, codec);
+    if (is_constant_tile(band_data, band_size, dtype_size(dtype), codec)) {
+        double value = get_pixel_value(constant_tile_value(band_data), dtype_size(dtype), 0, dtype);
+        return std::vector<double>(pixel_count, value);
+    }
+
+    BandCodec packed_codec;
     size_t data_size;
     std::vector<uint8_t> decompressed;
+    const uint8_t *data = decode_band_bytes(band_data, band_size, with_packed_bits(codec, dtype_str, packed_codec),
+                                            dtype_size(dtype), width, height, 1, decompressed, data_size);
 
-    if (compressed) {
-        decompressed = decompress_gzip(band_data, band_size);
-        data = decompressed.data();
-        data_size = decompressed.size();
-    } else {
-        data = band_data;
-        data_size = band_size;
-    }
-
-    size_t pixel_count = static_cast<size_t>(width) * height;
     size_t expected_size = pixel_count * dtype_size(dtype);
     if (expected_size > data_size) {
         throw std::out_of_range("Band data (" + std::to_string(data_size) +
@@ -223,10 +837,123 @@ std::vector<double> decode_band(const uint8_t *band_data, size_t band_size,
     return result;
 }
 
+BandStats constant_band_stats(double value, size_t pixel_count, bool has_nodata, double nodata) {
+    BandStats stats;
+    if (has_nodata && (value == nodata || (std::isnan(value) && std::isnan(nodata)))) {
+        return stats;
+    }
+    stats.count = static_cast<int64_t>(pixel_count);
+    stats.sum = value * static_cast<double>(pixel_count);
+    stats.mean = value;
+    stats.min = value;
+    stats.max = value;
+    return stats;
+}
+
+// 1-bit masks: every statistic follows from the number of set bits, so the
+// tile is counted with popcount while still packed instead of being unpacked
+static BandStats bitmask_band_stats(const uint8_t *band_data, size_t band_size, int width, int height,
+                                    const BandCodec &codec, bool has_nodata, double nodata) {
+    BandCodec packed = codec;
+    packed.keep_packed = true;
+    size_t data_size;
+    std::vector<uint8_t> decompressed;
+    const uint8_t *data = decode_band_bytes(band_data, band_size, packed, 1, width, height, 1,
+                                            decompressed, data_size);
+
+    double n = static_cast<double>(width) * height;
+    double ones = static_cast<double>(count_set_bits(data, data_size, width, height));
+
+    BandStats stats;
+    if (has_nodata && (nodata == 0 || nodata == 1)) {
+        // Only the non-nodata value is counted; a tile made entirely of
+        // nodata has no statistics at all
+        double value = nodata == 0 ? 1 : 0;
+        double valid = nodata == 0 ? ones : n - ones;
+        if (valid == 0) {
+            return stats;
+        }
+        return constant_band_stats(value, static_cast<size_t>(valid), false, 0);
+    }
+    stats.count = static_cast<int64_t>(n);
+    stats.sum = ones;
+    stats.mean = ones / n;
+    stats.min = ones < n ? 0 : 1;
+    stats.max = ones > 0 ? 1 : 0;
+    if (n > 1) {
+        stats.stddev = std::sqrt(ones * (n - ones) / (n * (n - 1)));
+    }
+    return stats;
+}
+
+// Tiles with a validity mask: only the mask's set bits are read, 64 pixels
+// of mask at a time, so sparse tiles skip their nodata runs wholesale and
+// need no per-pixel nodata test. An empty mask returns before the band is
+// decoded at all.
+static BandStats masked_band_stats(const ValidityMask &mask, const uint8_t *band_data, size_t band_size,
+                                   BandDataType dtype, int width, int height, const BandCodec &codec) {
+    std::vector<uint8_t> mask_scratch;
+    size_t mask_bytes;
+    const uint8_t *bits = decode_validity_mask(mask, codec, width, height, mask_scratch, mask_bytes);
+
+    BandStats stats;
+    if (count_set_bits(bits, mask_bytes, width, height) == 0) {
+        return stats;
+    }
+
+    size_t data_size;
+    std::vector<uint8_t> decompressed;
+    const uint8_t *data = decode_band_bytes(band_data, band_size, codec, dtype_size(dtype),
+                                            width, height, 1, decompressed, data_size);
+    if (static_cast<size_t>(width) * height * dtype_size(dtype) > data_size) {
+        throw std::out_of_range("Band data too small for declared dimensions");
+    }
+
+    stats.min = std::numeric_limits<double>::max();
+    stats.max = std::numeric_limits<double>::lowest();
+    double m2 = 0.0;
+
+    size_t row_bytes = packed_row_bytes(width, 1);
+    for (int y = 0; y < height; y++) {
+        const uint8_t *row = bits + static_cast<size_t>(y) * row_bytes;
+        size_t row_offset = static_cast<size_t>(y) * width;
+        for (size_t i = 0; i < row_bytes; i += 8) {
+            // Big-endian load: bit 63 is the word's first pixel
+            uint64_t word = 0;
+            size_t n = std::min<size_t>(8, row_bytes - i);
+            for (size_t k = 0; k < n; k++) {
+                word |= static_cast<uint64_t>(row[i + k]) << (56 - 8 * k);
+            }
+            while (word) {
+                int lead = leading_zeros64(word);
+                word &= ~(0x8000000000000000ULL >> lead);
+                size_t x = i * 8 + lead;
+                if (x >= static_cast<size_t>(width)) {
+                    break;
+                }
+                double val = get_pixel_value(data, data_size, row_offset + x, dtype);
+                stats.count++;
+                stats.sum += val;
+                if (val < stats.min) stats.min = val;
+                if (val > stats.max) stats.max = val;
+                double delta = val - stats.mean;
+                stats.mean += delta / stats.count;
+                m2 += delta * (val - stats.mean);
+            }
+        }
+    }
+
+    stats.mean = stats.sum / stats.count;
+    if (stats.count > 1) {
+        stats.stddev = std::sqrt(m2 / (stats.count - 1));
+    }
+    return stats;
+}
+
 BandStats compute_band_stats(const uint8_t *band_data, size_t band_size,
                               const std::string &dtype_str,
                               int width, int height,
-                              bool compressed,
+                              const BandCodec &codec,
                               bool has_nodata,
                               double nodata) {
     BandDataType dtype = parse_dtype(dtype_str);
@@ -235,20 +962,34 @@ BandStats compute_band_stats(const uint8_t *band_data, size_t band_size,
         throw std::invalid_argument("Invalid band dimensions");
     }
 
-    const uint8_t *data;
-    size_t data_size;
-    std::vector<uint8_t> decompressed;
+    size_t pixel_count = static_cast<size_t>(width) * height;
+    resolve_tile_ref(band_data, band_size, codec);
+    if (is_constant_tile(band_data, band_size, dtype_size(dtype), codec)) {
+        return constant_band_stats(get_pixel_value(constant_tile_value(band_data), dtype_size(dtype), 0, dtype),
+                                   pixel_count, has_nodata, nodata);
+    }
 
-    if (compressed) {
-        decompressed = decompress_gzip(band_data, band_size);
-        data = decompressed.data();
-        data_size = decompressed.size();
-    } else {
-        data = band_data;
-        data_size = band_size;
+    BandCodec packed_codec;
+    const BandCodec &band_codec = with_packed_bits(codec, dtype_str, packed_codec);
+    ValidityMask mask;
+    const uint8_t *masked_data = band_data;
+    size_t masked_size = band_size;
+    if (split_validity_mask(masked_data, masked_size, band_codec, mask) &&
+        validity_mask_applies(mask, has_nodata, nodata)) {
+        // The band blob behind the mask is not split again
+        BandCodec unmasked_codec = band_codec;
+        unmasked_codec.validity_mask = false;
+        return masked_band_stats(mask, masked_data, masked_size, dtype, width, height, unmasked_codec);
+    }
+    if (dtype == BandDataType::UINT1) {
+        return bitmask_band_stats(band_data, band_size, width, height, band_codec, has_nodata, nodata);
     }
 
-    size_t pixel_count = static_cast<size_t>(width) * height;
+    size_t data_size;
+    std::vector<uint8_t> decompressed;
+    const uint8_t *data = decode_band_bytes(band_data, band_size, band_codec, dtype_size(dtype),
+                                            width, height, 1, decompressed, data_size);
+
     size_t expected_size = pixel_count * dtype_size(dtype);
     if (expected_size > data_size) {
         throw std::out_of_range("Band data too small for declared dimensions");
@@ -301,7 +1042,7 @@ double decode_pixel_interleaved(const uint8_t *pixels_data, size_t pixels_size,
                                  const std::string &dtype_str,
                                  int pixel_x, int pixel_y, int width,
                                  int band_index, int num_bands,
-                                 const std::string &compression) {
+                                 const BandCodec &codec) {
     if (pixel_x < 0 || pixel_y < 0 || width <= 0 || band_index < 0 || num_bands <= 0) {
         throw std::out_of_range("Invalid pixel coordinates, width, or band index");
     }
@@ -313,12 +1054,9 @@ double decode_pixel_interleaved(const uint8_t *pixels_data, size_t pixels_size,
     int decoded_height = 0;
     int decoded_channels = 0;
 
-    if (compression == "gzip") {
-        // Gzip compression: decompress to raw interleaved bytes
-        decompressed = decompress_gzip(pixels_data, pixels_size);
-        data = decompressed.data();
-        data_size = decompressed.size();
-    } else if (compression == "jpeg") {
+    const std::string &compression = codec.compression;
+
+    if (compression == "jpeg") {
         // JPEG: decode to RGB image, then extract channel
         decompressed = decompress_jpeg(pixels_data, pixels_size,
                                         decoded_width, decoded_height, decoded_channels);
@@ -352,18 +1090,15 @@ double decode_pixel_interleaved(const uint8_t *pixels_data, size_t pixels_size,
             throw std::out_of_range("WebP pixel offset out of bounds");
         }
         return static_cast<double>(data[offset]);
-    } else if (compression == "none" || compression.empty()) {
-        // No compression: use raw data directly
-        data = pixels_data;
-        data_size = pixels_size;
-    } else {
-        throw std::invalid_argument("Unknown compression: " + compression);
     }
 
-    // For gzip or no compression: interleaved (BIP) layout
+    // Byte codecs (gzip/zstd/lz4/none): interleaved (BIP) layout
     // Data layout: [B0_P0, B1_P0, B2_P0, B0_P1, B1_P1, B2_P1, ...]
     // where B=band, P=pixel
     BandDataType dtype = parse_dtype(dtype_str);
+    // (constant tiles are only written for sequential bands, so no height needed)
+    data = decode_band_bytes(pixels_data, pixels_size, codec, dtype_size(dtype),
+                             width, 0, num_bands, decompressed, data_size);
 
     // Interleaved offset: (pixel_index * num_bands + band_index)
     size_t pixel_index = static_cast<size_t>(pixel_y) * width + pixel_x;
@@ -377,7 +1112,7 @@ std::vector<double> decode_band_interleaved(const uint8_t *pixels_data, size_t p
                                              const std::string &dtype_str,
                                              int width, int height,
                                              int band_index, int num_bands,
-                                             const std::string &compression) {
+                                             const BandCodec &codec) {
     if (width <= 0 || height <= 0 || band_index < 0 || num_bands <= 0) {
         throw std::invalid_argument("Invalid dimensions or band index");
     }
@@ -389,11 +1124,9 @@ std::vector<double> decode_band_interleaved(const uint8_t *pixels_data, size_t p
     int decoded_height = height;
     int decoded_channels = 0;
 
-    if (compression == "gzip") {
-        decompressed = decompress_gzip(pixels_data, pixels_size);
-        data = decompressed.data();
-        data_size = decompressed.size();
-    } else if (compression == "jpeg") {
+    const std::string &compression = codec.compression;
+
+    if (compression == "jpeg") {
         decompressed = decompress_jpeg(pixels_data, pixels_size,
                                         decoded_width, decoded_height, decoded_channels);
         data = decompressed.data();
@@ -434,15 +1167,12 @@ std::vector<double> decode_band_interleaved(const uint8_t *pixels_data, size_t p
             result[i] = static_cast<double>(data[offset]);
         }
         return result;
-    } else if (compression == "none" || compression.empty()) {
-        data = pixels_data;
-        data_size = pixels_size;
-    } else {
-        throw std::invalid_argument("Unknown compression: " + compression);
     }
 
-    // For gzip or no compression: interleaved (BIP) layout
+    // Byte codecs (gzip/zstd/lz4/none): interleaved (BIP) layout
     BandDataType dtype = parse_dtype(dtype_str);
+    data = decode_band_bytes(pixels_data, pixels_size, codec, dtype_size(dtype),
+                             width, height, num_bands, decompressed, data_size);
 
     size_t pixel_count = static_cast<size_t>(width) * height;
     // Validate total interleaved data fits
@@ -452,12 +1182,19 @@ std::vector<double> decode_band_interleaved(const uint8_t *pixels_data, size_t p
         throw std::out_of_range("Interleaved band data too small for declared dimensions");
     }
 
-    std::vector<double> result(pixel_count);
+    if (band_index >= num_bands) {
+        throw std::invalid_argument("Band index exceeds interleaved band count");
+    }
+
+    // Pull the band out into a contiguous plane first (shuffle kernels),
+    // then convert it like a sequential band
+    size_t elem = dtype_size(dtype);
+    std::vector<uint8_t> plane(pixel_count * elem);
+    deinterleave_band(data, num_bands, band_index, pixel_count, elem, plane.data());
 
+    std::vector<double> result(pixel_count);
     for (size_t i = 0; i < pixel_count; i++) {
-        // Interleaved offset: pixel_index * num_bands + band_index
-        size_t element_offset = i * num_bands + band_index;
-        result[i] = get_pixel_value(data, data_size, element_offset, dtype);
+        result[i] = get_pixel_value(plane.data(), plane.size(), i, dtype);
     }
 
     return result;
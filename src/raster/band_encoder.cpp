@@ -1,6 +1,13 @@
 #include "band_encoder.hpp"
+#include "band_decoder.hpp"
+#include "band_interleave.hpp"
+#include "raquet_metrics.hpp"
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <limits>
 #include <stdexcept>
+#include <unordered_map>
 #include <zlib.h>
 
 #ifdef RAQUET_HAS_JPEG
@@ -11,16 +18,54 @@
 #include <webp/encode.h>
 #endif
 
+#ifdef RAQUET_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+#ifdef RAQUET_HAS_LZ4
+#include <lz4frame.h>
+#endif
+
 namespace duckdb {
 namespace raquet {
 
-std::vector<uint8_t> compress_gzip(const uint8_t *data, size_t size) {
+std::vector<uint8_t> compress_gzip(const uint8_t *data, size_t size,
+                                   const std::vector<uint8_t> *dictionary, int level) {
+    ScopedMetricTimer timer(Metric::COMPRESS_NS);
+
+    if (dictionary && !dictionary->empty()) {
+        z_stream strm;
+        memset(&strm, 0, sizeof(strm));
+        int ret = deflateInit(&strm, level);
+        if (ret != Z_OK) {
+            throw std::runtime_error("deflateInit failed with error code " + std::to_string(ret));
+        }
+        ret = deflateSetDictionary(&strm, dictionary->data(), static_cast<uInt>(dictionary->size()));
+        if (ret != Z_OK) {
+            deflateEnd(&strm);
+            throw std::runtime_error("deflateSetDictionary failed with error code " + std::to_string(ret));
+        }
+        std::vector<uint8_t> compressed(deflateBound(&strm, static_cast<uLong>(size)));
+        strm.next_in = const_cast<Bytef *>(data);
+        strm.avail_in = static_cast<uInt>(size);
+        strm.next_out = compressed.data();
+        strm.avail_out = static_cast<uInt>(compressed.size());
+        ret = deflate(&strm, Z_FINISH);
+        size_t out_size = compressed.size() - strm.avail_out;
+        deflateEnd(&strm);
+        if (ret != Z_STREAM_END) {
+            throw std::runtime_error("gzip compression failed with error code " + std::to_string(ret));
+        }
+        compressed.resize(out_size);
+        return compressed;
+    }
+
     // Estimate compressed size (zlib recommends compressBound)
     uLongf compressed_size = compressBound(static_cast<uLong>(size));
     std::vector<uint8_t> compressed(compressed_size);
 
     int ret = compress2(compressed.data(), &compressed_size,
-                        data, static_cast<uLong>(size), Z_DEFAULT_COMPRESSION);
+                        data, static_cast<uLong>(size), level);
     if (ret != Z_OK) {
         throw std::runtime_error("gzip compression failed with error code " + std::to_string(ret));
     }
@@ -29,9 +74,584 @@ std::vector<uint8_t> compress_gzip(const uint8_t *data, size_t size) {
     return compressed;
 }
 
+std::vector<uint8_t> compress_zstd(const uint8_t *data, size_t size, int level) {
+#ifdef RAQUET_HAS_ZSTD
+    ScopedMetricTimer timer(Metric::COMPRESS_NS);
+
+    // ZSTD_compress writes the content size into the frame header, which
+    // decompress_zstd relies on to size its output in one allocation
+    std::vector<uint8_t> compressed(ZSTD_compressBound(size));
+    size_t ret = ZSTD_compress(compressed.data(), compressed.size(), data, size, level);
+    if (ZSTD_isError(ret)) {
+        throw std::runtime_error(std::string("zstd compression failed: ") + ZSTD_getErrorName(ret));
+    }
+
+    compressed.resize(ret);
+    return compressed;
+#else
+    (void)data; (void)size; (void)level;
+    throw std::runtime_error("zstd compression not available: compile with RAQUET_HAS_ZSTD");
+#endif
+}
+
+std::vector<uint8_t> compress_lz4(const uint8_t *data, size_t size) {
+#ifdef RAQUET_HAS_LZ4
+    ScopedMetricTimer timer(Metric::COMPRESS_NS);
+
+    LZ4F_preferences_t prefs;
+    memset(&prefs, 0, sizeof(prefs));
+    prefs.frameInfo.contentSize = size;
+
+    std::vector<uint8_t> compressed(LZ4F_compressFrameBound(size, &prefs));
+    size_t ret = LZ4F_compressFrame(compressed.data(), compressed.size(), data, size, &prefs);
+    if (LZ4F_isError(ret)) {
+        throw std::runtime_error(std::string("LZ4 compression failed: ") + LZ4F_getErrorName(ret));
+    }
+
+    compressed.resize(ret);
+    return compressed;
+#else
+    (void)data; (void)size;
+    throw std::runtime_error("LZ4 compression not available: compile with RAQUET_HAS_LZ4");
+#endif
+}
+
+template <typename T>
+static void apply_predictor_rows(uint8_t *data, size_t size, int width, int samples) {
+    size_t row_elems = static_cast<size_t>(width) * samples;
+    size_t row_bytes = row_elems * sizeof(T);
+    if (row_elems == 0) {
+        return;
+    }
+    for (size_t row = 0; row + row_bytes <= size; row += row_bytes) {
+        uint8_t *p = data + row;
+        // Walk right to left so each difference uses the original neighbour
+        for (size_t i = row_elems - 1; i >= static_cast<size_t>(samples); i--) {
+            T prev, cur;
+            memcpy(&prev, p + (i - samples) * sizeof(T), sizeof(T));
+            memcpy(&cur, p + i * sizeof(T), sizeof(T));
+            cur = static_cast<T>(cur - prev);
+            memcpy(p + i * sizeof(T), &cur, sizeof(T));
+        }
+    }
+}
+
+void apply_horizontal_predictor(uint8_t *data, size_t size, size_t elem_size,
+                                int width, int samples_per_pixel) {
+    if (width <= 0 || samples_per_pixel <= 0) {
+        throw std::invalid_argument("Invalid predictor row geometry");
+    }
+    switch (elem_size) {
+        case 1: apply_predictor_rows<uint8_t>(data, size, width, samples_per_pixel); break;
+        case 2: apply_predictor_rows<uint16_t>(data, size, width, samples_per_pixel); break;
+        case 4: apply_predictor_rows<uint32_t>(data, size, width, samples_per_pixel); break;
+        case 8: apply_predictor_rows<uint64_t>(data, size, width, samples_per_pixel); break;
+        default:
+            throw std::invalid_argument("Unsupported element size for predictor: " + std::to_string(elem_size));
+    }
+}
+
+void apply_float_predictor(uint8_t *data, size_t size, size_t elem_size,
+                           int width, int samples_per_pixel) {
+    if (width <= 0 || samples_per_pixel <= 0) {
+        throw std::invalid_argument("Invalid predictor row geometry");
+    }
+    if (elem_size != 2 && elem_size != 4 && elem_size != 8) {
+        throw std::invalid_argument("Floating-point predictor needs a 2, 4 or 8 byte type, got " +
+                                    std::to_string(elem_size));
+    }
+    size_t row_elems = static_cast<size_t>(width) * samples_per_pixel;
+    size_t row_bytes = row_elems * elem_size;
+    size_t stride = static_cast<size_t>(samples_per_pixel);
+    std::vector<uint8_t> planes(row_bytes);
+
+    for (size_t row = 0; row + row_bytes <= size; row += row_bytes) {
+        uint8_t *p = data + row;
+        for (size_t i = 0; i < row_elems; i++) {
+            for (size_t j = 0; j < elem_size; j++) {
+                planes[(elem_size - 1 - j) * row_elems + i] = p[i * elem_size + j];
+            }
+        }
+        for (size_t i = row_bytes - 1; i >= stride; i--) {
+            planes[i] = static_cast<uint8_t>(planes[i] - planes[i - stride]);
+        }
+        memcpy(p, planes.data(), row_bytes);
+    }
+}
+
+std::vector<uint8_t> encode_constant_tile(const uint8_t *data, size_t size, size_t elem_size) {
+    if (size < elem_size || elem_size == 0 || size % elem_size != 0) {
+        return {};
+    }
+    // Compare each element against the one before it (same bytes, shifted),
+    // which memcmp does in one pass over the whole plane
+    if (memcmp(data, data + elem_size, size - elem_size) != 0) {
+        return {};
+    }
+    std::vector<uint8_t> blob(CONSTANT_TILE_HEADER + elem_size);
+    memcpy(blob.data(), CONSTANT_TILE_MAGIC, CONSTANT_TILE_HEADER);
+    memcpy(blob.data() + CONSTANT_TILE_HEADER, data, elem_size);
+    return blob;
+}
+
+// Shannon entropy in bits per byte of a byte histogram
+static double ByteEntropy(const size_t (&histogram)[256], size_t total) {
+    if (total == 0) {
+        return 0.0;
+    }
+    double entropy = 0.0;
+    for (size_t count : histogram) {
+        if (count > 0) {
+            double p = static_cast<double>(count) / total;
+            entropy -= p * std::log2(p);
+        }
+    }
+    return entropy;
+}
+
+AutoCodecChoice choose_tile_codec(const uint8_t *data, size_t size, size_t elem_size, int width,
+                                  int samples_per_pixel, bool is_float, const std::string &objective) {
+    constexpr size_t SAMPLE_ROWS = 32;
+    constexpr double RAW_ENTROPY = 7.5;        // bits/byte above which no codec pays off
+    constexpr double SPEED_RAW_ENTROPY = 6.0;  // speed: savings too small to spend decode time on
+    constexpr double RUN_HEAVY = 0.9;          // share of bytes repeating their left neighbour
+
+    AutoCodecChoice choice;
+    size_t row_bytes = static_cast<size_t>(width) * samples_per_pixel * elem_size;
+    if (row_bytes == 0 || size < row_bytes) {
+        return choice;
+    }
+    size_t rows = size / row_bytes;
+    size_t stride = rows > SAMPLE_ROWS ? rows / SAMPLE_ROWS : 1;
+    int candidate_predictor = is_float ? 3 : 2;
+    bool predictable = is_float ? (elem_size == 2 || elem_size == 4 || elem_size == 8)
+                                : (elem_size == 1 || elem_size == 2 || elem_size == 4 || elem_size == 8);
+
+    size_t plain[256] = {};
+    size_t predicted[256] = {};
+    size_t sampled = 0;
+    size_t repeats = 0;
+    std::vector<uint8_t> row(row_bytes);
+    for (size_t r = 0; r < rows; r += stride) {
+        const uint8_t *src = data + r * row_bytes;
+        for (size_t i = 0; i < row_bytes; i++) {
+            plain[src[i]]++;
+        }
+        for (size_t i = elem_size; i < row_bytes; i++) {
+            repeats += src[i] == src[i - elem_size];
+        }
+        if (predictable) {
+            memcpy(row.data(), src, row_bytes);
+            if (is_float) {
+                apply_float_predictor(row.data(), row_bytes, elem_size, width, samples_per_pixel);
+            } else {
+                apply_horizontal_predictor(row.data(), row_bytes, elem_size, width, samples_per_pixel);
+            }
+            for (size_t i = 0; i < row_bytes; i++) {
+                predicted[row[i]]++;
+            }
+        }
+        sampled += row_bytes;
+    }
+
+    double plain_entropy = ByteEntropy(plain, sampled);
+    double predicted_entropy = predictable ? ByteEntropy(predicted, sampled) : plain_entropy;
+    bool run_heavy = static_cast<double>(repeats) >= RUN_HEAVY * sampled;
+    // Undoing the predictor costs a pass over the tile. Run-heavy tiles
+    // (class maps, fill) already suit LZ matching, so only "size" spends it
+    // there, and "speed" only when the predictor is what makes the tile
+    // worth compressing at all.
+    bool use_predictor = predictable && predicted_entropy + 0.25 < plain_entropy;
+    if (objective == "balanced") {
+        use_predictor = use_predictor && !run_heavy;
+    } else if (objective == "speed") {
+        use_predictor = use_predictor && !run_heavy && plain_entropy >= SPEED_RAW_ENTROPY &&
+                        predicted_entropy < SPEED_RAW_ENTROPY;
+    }
+    if (use_predictor) {
+        choice.predictor = candidate_predictor;
+    }
+    double entropy = choice.predictor != 1 ? predicted_entropy : plain_entropy;
+
+    if (entropy >= RAW_ENTROPY || (objective == "speed" && entropy >= SPEED_RAW_ENTROPY)) {
+        choice.predictor = 1;
+        return choice;
+    }
+
+#ifdef RAQUET_HAS_ZSTD
+    constexpr bool has_zstd = true;
+#else
+    constexpr bool has_zstd = false;
+#endif
+#ifdef RAQUET_HAS_LZ4
+    constexpr bool has_lz4 = true;
+#else
+    constexpr bool has_lz4 = false;
+#endif
+    if (objective == "size") {
+        choice.compression = has_zstd ? "zstd" : "gzip";
+        choice.level = has_zstd ? 19 : 9;
+    } else if (objective == "speed") {
+        if (has_lz4) {
+            choice.compression = "lz4";
+        } else {
+            choice.compression = has_zstd ? "zstd" : "gzip";
+            choice.level = 1;
+        }
+    } else if (run_heavy || !has_zstd) {
+        // Fast zstd levels trail deflate on long runs of a few values
+        choice.compression = "gzip";
+        choice.level = 6;
+    } else {
+        choice.compression = "zstd";
+        choice.level = 3;
+    }
+    return choice;
+}
+
+std::vector<uint8_t> encode_auto_tile(uint8_t *data, size_t size, size_t elem_size, int width,
+                                      int samples_per_pixel, bool is_float, const std::string &objective) {
+    auto choice = choose_tile_codec(data, size, elem_size, width, samples_per_pixel, is_float, objective);
+    if (choice.predictor == 2) {
+        apply_horizontal_predictor(data, size, elem_size, width, samples_per_pixel);
+    } else if (choice.predictor == 3) {
+        apply_float_predictor(data, size, elem_size, width, samples_per_pixel);
+    }
+
+    std::vector<uint8_t> compressed;
+    if (choice.compression == "gzip") {
+        compressed = compress_gzip(data, size, nullptr, choice.level);
+    } else if (choice.compression == "zstd") {
+        compressed = compress_zstd(data, size, choice.level);
+    } else if (choice.compression == "lz4") {
+        compressed = compress_lz4(data, size);
+    }
+    if (choice.compression == "none" || compressed.size() >= size) {
+        choice.compression = "none";
+        compressed.assign(data, data + size);
+    }
+
+    std::vector<uint8_t> blob(compressed.size() + 1);
+    blob[0] = auto_codec_byte(choice.compression, choice.predictor);
+    memcpy(blob.data() + 1, compressed.data(), compressed.size());
+    return blob;
+}
+
+std::vector<uint8_t> compress_band_bytes(uint8_t *data, size_t size, const std::string &compression,
+                                         const std::string &auto_objective, int predictor, size_t elem_size,
+                                         bool is_float, int width, int samples_per_pixel,
+                                         const std::vector<uint8_t> *dictionary) {
+    if (compression == "auto") {
+        return encode_auto_tile(data, size, elem_size, width, samples_per_pixel, is_float, auto_objective);
+    }
+    if (predictor == 2) {
+        apply_horizontal_predictor(data, size, elem_size, width, samples_per_pixel);
+    } else if (predictor == 3) {
+        apply_float_predictor(data, size, elem_size, width, samples_per_pixel);
+    }
+    if (compression == "gzip") {
+        return compress_gzip(data, size, dictionary);
+    } else if (compression == "zstd") {
+        return compress_zstd(data, size);
+    } else if (compression == "lz4") {
+        return compress_lz4(data, size);
+    }
+    return std::vector<uint8_t>(data, data + size);
+}
+
+std::vector<uint8_t> encode_tile_ref(uint32_t slot) {
+    std::vector<uint8_t> blob(TILE_REF_SIZE);
+    memcpy(blob.data(), TILE_REF_MAGIC, sizeof(TILE_REF_MAGIC));
+    for (int i = 0; i < 4; i++) {
+        blob[sizeof(TILE_REF_MAGIC) + i] = static_cast<uint8_t>(slot >> (8 * i));
+    }
+    return blob;
+}
+
+std::vector<uint8_t> train_deflate_dictionary(const std::vector<std::vector<uint8_t>> &samples,
+                                              size_t dict_size) {
+    constexpr size_t GRAM = 8;
+    // Bound the counting work; large float tiles are strided through.
+    constexpr size_t MAX_TRAINING_POSITIONS = 1 << 20;
+
+    size_t total = 0;
+    for (auto &sample : samples) {
+        total += sample.size();
+    }
+    size_t step = std::max<size_t>(1, total / MAX_TRAINING_POSITIONS);
+
+    // gram -> (number of samples containing it, last sample that counted it)
+    std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> grams;
+    for (size_t s = 0; s < samples.size(); s++) {
+        const auto &sample = samples[s];
+        if (sample.size() < GRAM) {
+            continue;
+        }
+        for (size_t i = 0; i + GRAM <= sample.size(); i += step) {
+            uint64_t g;
+            memcpy(&g, sample.data() + i, GRAM);
+            auto &entry = grams[g];
+            if (entry.second != s + 1) {
+                entry.first++;
+                entry.second = static_cast<uint32_t>(s + 1);
+            }
+        }
+    }
+
+    std::vector<std::pair<uint32_t, uint64_t>> ranked;
+    for (auto &kv : grams) {
+        if (kv.second.first >= 2) {
+            ranked.push_back({kv.second.first, kv.first});
+        }
+    }
+    size_t keep = std::min(ranked.size(), dict_size / GRAM);
+    std::partial_sort(ranked.begin(), ranked.begin() + keep, ranked.end(),
+                      [](const std::pair<uint32_t, uint64_t> &a, const std::pair<uint32_t, uint64_t> &b) {
+                          return a.first != b.first ? a.first > b.first : a.second < b.second;
+                      });
+
+    std::vector<uint8_t> dictionary(keep * GRAM);
+    for (size_t i = 0; i < keep; i++) {
+        // Most common gram goes last, nearest to the data being compressed
+        memcpy(dictionary.data() + (keep - 1 - i) * GRAM, &ranked[i].second, GRAM);
+    }
+    return dictionary;
+}
+
+bool plan_quantization(double min, double max, double max_error, size_t float_size,
+                       std::string &stored_type, double &scale, double &offset,
+                       uint64_t &nodata_code) {
+    if (!(max_error > 0) || !std::isfinite(min) || !std::isfinite(max) || max < min) {
+        return false;
+    }
+    // Decoding rounds code * scale + offset back to a float, which can add up
+    // to half an ulp of the value; reserve that before sizing the step.
+    double magnitude = std::max(std::fabs(min), std::fabs(max));
+    double margin = magnitude * (float_size == 4 ? std::ldexp(1.0, -23) : std::ldexp(1.0, -50));
+    double step = 2.0 * (max_error - margin);
+    if (!(step > 0)) {
+        return false;
+    }
+
+    double max_code = std::ceil((max - min) / step);
+    if (max_code + 1 <= 255.0) {
+        stored_type = "uint8";
+    } else if (max_code + 1 <= 65535.0) {
+        stored_type = "uint16";
+    } else if (max_code + 1 <= 4294967295.0) {
+        stored_type = "uint32";
+    } else {
+        return false;
+    }
+    scale = step;
+    offset = min;
+    nodata_code = static_cast<uint64_t>(max_code) + 1;
+    return true;
+}
+
+// Codes are written front to back over the (at least as wide) floats, so
+// each element is read before anything overwrites it.
+template <typename FloatT, typename CodeT>
+static void QuantizeInPlace(uint8_t *data, size_t count, double scale, double offset,
+                            uint64_t nodata_code, bool has_nodata, double nodata) {
+    const double max_valid = static_cast<double>(nodata_code - 1);
+    const FloatT nodata_f = static_cast<FloatT>(nodata);
+    for (size_t i = 0; i < count; i++) {
+        FloatT v;
+        memcpy(&v, data + i * sizeof(FloatT), sizeof(FloatT));
+        CodeT q;
+        if (std::isnan(v) || (has_nodata && v == nodata_f)) {
+            q = static_cast<CodeT>(nodata_code);
+        } else {
+            double c = std::round((static_cast<double>(v) - offset) / scale);
+            c = std::min(std::max(c, 0.0), max_valid);
+            q = static_cast<CodeT>(c);
+        }
+        memcpy(data + i * sizeof(CodeT), &q, sizeof(CodeT));
+    }
+}
+
+template <typename FloatT>
+static void QuantizeAs(uint8_t *data, size_t count, const std::string &stored_type,
+                       double scale, double offset, uint64_t nodata_code,
+                       bool has_nodata, double nodata) {
+    if (stored_type == "uint8") {
+        QuantizeInPlace<FloatT, uint8_t>(data, count, scale, offset, nodata_code, has_nodata, nodata);
+    } else if (stored_type == "uint16") {
+        QuantizeInPlace<FloatT, uint16_t>(data, count, scale, offset, nodata_code, has_nodata, nodata);
+    } else if (stored_type == "uint32") {
+        QuantizeInPlace<FloatT, uint32_t>(data, count, scale, offset, nodata_code, has_nodata, nodata);
+    } else {
+        throw std::invalid_argument("Unsupported quantized type: " + stored_type);
+    }
+}
+
+void quantize_band(uint8_t *data, size_t count, size_t float_size,
+                   const std::string &stored_type, double scale, double offset,
+                   uint64_t nodata_code, bool has_nodata, double nodata) {
+    if (float_size == 4) {
+        QuantizeAs<float>(data, count, stored_type, scale, offset, nodata_code, has_nodata, nodata);
+    } else if (float_size == 8) {
+        QuantizeAs<double>(data, count, stored_type, scale, offset, nodata_code, has_nodata, nodata);
+    } else {
+        throw std::invalid_argument("Quantization requires float32 or float64 input");
+    }
+}
+
+// IEEE 754 half from double, round to nearest even (inverse of
+// float16_to_double in band_decoder.hpp)
+static uint16_t double_to_float16(double value) {
+    float f = static_cast<float>(value);
+    uint32_t bits;
+    std::memcpy(&bits, &f, 4);
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t mant = bits & 0x7FFFFF;
+    int exp = static_cast<int>((bits >> 23) & 0xFF);
+    if (exp == 0xFF) {
+        return sign | 0x7C00 | (mant ? 0x200 : 0);  // inf / NaN
+    }
+    exp = exp - 127 + 15;
+    if (exp >= 0x1F) {
+        return sign | 0x7C00;  // overflow
+    }
+    if (exp <= 0) {
+        if (exp < -10) return sign;  // underflow
+        mant |= 0x800000;
+        int shift = 14 - exp;
+        uint32_t half = mant >> shift;
+        uint32_t rem = mant & ((1u << shift) - 1);
+        uint32_t mid = 1u << (shift - 1);
+        if (rem > mid || (rem == mid && (half & 1))) half++;
+        return static_cast<uint16_t>(sign | half);
+    }
+    uint32_t half = (static_cast<uint32_t>(exp) << 10) | (mant >> 13);
+    uint32_t rem = mant & 0x1FFF;
+    if (rem > 0x1000 || (rem == 0x1000 && (half & 1))) half++;  // a carry rounds up to the next exponent
+    return static_cast<uint16_t>(sign | half);
+}
+
+template <typename T>
+static void store_rounded(uint8_t *dst, double value) {
+    double r = std::round(value);
+    T v;
+    if (!(r > static_cast<double>(std::numeric_limits<T>::lowest()))) {
+        v = std::numeric_limits<T>::lowest();
+    } else if (r >= static_cast<double>(std::numeric_limits<T>::max())) {
+        v = std::numeric_limits<T>::max();
+    } else {
+        v = static_cast<T>(r);
+    }
+    std::memcpy(dst, &v, sizeof(T));
+}
+
+void store_pixel_value(uint8_t *dst, BandDataType dtype, double value) {
+    switch (dtype) {
+        case BandDataType::UINT8:
+        case BandDataType::UINT1:
+        case BandDataType::UINT2:
+        case BandDataType::UINT4: store_rounded<uint8_t>(dst, value); break;
+        case BandDataType::INT8: store_rounded<int8_t>(dst, value); break;
+        case BandDataType::UINT16: store_rounded<uint16_t>(dst, value); break;
+        case BandDataType::INT16: store_rounded<int16_t>(dst, value); break;
+        case BandDataType::UINT32: store_rounded<uint32_t>(dst, value); break;
+        case BandDataType::INT32: store_rounded<int32_t>(dst, value); break;
+        case BandDataType::UINT64: store_rounded<uint64_t>(dst, value); break;
+        case BandDataType::INT64: store_rounded<int64_t>(dst, value); break;
+        case BandDataType::FLOAT16: {
+            uint16_t h = double_to_float16(value);
+            std::memcpy(dst, &h, 2);
+            break;
+        }
+        case BandDataType::FLOAT32: {
+            float f = static_cast<float>(value);
+            std::memcpy(dst, &f, 4);
+            break;
+        }
+        case BandDataType::FLOAT64: std::memcpy(dst, &value, 8); break;
+    }
+}
+
+size_t pack_bits(uint8_t *data, int width, int height, int bits) {
+    if (bits != 1 && bits != 2 && bits != 4) {
+        throw std::invalid_argument("Unsupported packed pixel width: " + std::to_string(bits) + " bits");
+    }
+    size_t row_bytes = packed_row_bytes(width, bits);
+    int per_byte = 8 / bits;
+    uint8_t limit = static_cast<uint8_t>((1 << bits) - 1);
+    // Packed byte i of row y lands at or before the first pixel it reads, so
+    // the plane can be overwritten front to back.
+    for (int y = 0; y < height; y++) {
+        const uint8_t *src = data + static_cast<size_t>(y) * width;
+        uint8_t *dst = data + static_cast<size_t>(y) * row_bytes;
+        for (size_t i = 0; i < row_bytes; i++) {
+            uint8_t packed = 0;
+            for (int k = 0; k < per_byte; k++) {
+                size_t x = i * per_byte + k;
+                uint8_t v = x < static_cast<size_t>(width) ? src[x] : 0;
+                if (v > limit) {
+                    throw std::out_of_range("Pixel value " + std::to_string(v) + " exceeds uint" +
+                                            std::to_string(bits));
+                }
+                packed = static_cast<uint8_t>(packed | (v << (8 - bits * (k + 1))));
+            }
+            dst[i] = packed;
+        }
+    }
+    return row_bytes * height;
+}
+
+std::vector<uint8_t> build_validity_mask(const uint8_t *data, const std::string &dtype_str, int width, int height,
+                                         double nodata, size_t &valid_count) {
+    BandDataType dtype = parse_dtype(dtype_str);
+    size_t row_bytes = packed_row_bytes(width, 1);
+    size_t elem_size = dtype_size(dtype);
+    size_t data_size = static_cast<size_t>(width) * height * elem_size;
+    bool nan_nodata = std::isnan(nodata);
+    std::vector<uint8_t> mask(row_bytes * height, 0);
+    valid_count = 0;
+    for (int y = 0; y < height; y++) {
+        uint8_t *row = mask.data() + static_cast<size_t>(y) * row_bytes;
+        for (int x = 0; x < width; x++) {
+            double v = get_pixel_value(data, data_size, static_cast<size_t>(y) * width + x, dtype);
+            if (v == nodata || (nan_nodata && std::isnan(v))) {
+                continue;
+            }
+            row[x / 8] = static_cast<uint8_t>(row[x / 8] | (0x80 >> (x % 8)));
+            valid_count++;
+        }
+    }
+    return mask;
+}
+
+std::vector<uint8_t> wrap_validity_mask(const std::vector<uint8_t> &encoded_mask, double nodata,
+                                        const std::vector<uint8_t> &band_blob) {
+    if (encoded_mask.size() > UINT32_MAX) {
+        throw std::length_error("Validity mask too large");
+    }
+    std::vector<uint8_t> out(VALIDITY_MASK_HEADER + encoded_mask.size() + band_blob.size());
+    uint8_t *p = out.data();
+    memcpy(p, VALIDITY_MASK_MAGIC, sizeof(VALIDITY_MASK_MAGIC));
+    p += sizeof(VALIDITY_MASK_MAGIC);
+    uint32_t mask_size = static_cast<uint32_t>(encoded_mask.size());
+    for (int i = 0; i < 4; i++) {
+        *p++ = static_cast<uint8_t>(mask_size >> (8 * i));
+    }
+    memcpy(p, &nodata, sizeof(double));
+    p += sizeof(double);
+    if (!encoded_mask.empty()) {
+        memcpy(p, encoded_mask.data(), encoded_mask.size());
+        p += encoded_mask.size();
+    }
+    if (!band_blob.empty()) {
+        memcpy(p, band_blob.data(), band_blob.size());
+    }
+    return out;
+}
+
 std::vector<uint8_t> encode_jpeg(const uint8_t *data, int width, int height,
                                   int channels, int quality) {
 #ifdef RAQUET_HAS_JPEG
+    ScopedMetricTimer timer(Metric::COMPRESS_NS);
     struct jpeg_compress_struct cinfo;
     struct jpeg_error_mgr jerr;
 
@@ -84,6 +704,7 @@ std::vector<uint8_t> encode_jpeg(const uint8_t *data, int width, int height,
 std::vector<uint8_t> encode_webp(const uint8_t *data, int width, int height,
                                   int channels, int quality) {
 #ifdef RAQUET_HAS_WEBP
+    ScopedMetricTimer timer(Metric::COMPRESS_NS);
     uint8_t *output = nullptr;
     size_t output_size = 0;
 
@@ -111,24 +732,86 @@ std::vector<uint8_t> encode_webp(const uint8_t *data, int width, int height,
 #endif
 }
 
-std::vector<uint8_t> interleave_bands(const std::vector<std::vector<uint8_t>> &bands,
-                                       int width, int height, size_t dtype_size) {
-    size_t num_bands = bands.size();
-    size_t num_pixels = static_cast<size_t>(width) * height;
-    size_t total_size = num_pixels * num_bands * dtype_size;
+static void append_png_chunk(std::vector<uint8_t> &out, const char *type, const uint8_t *data, size_t size) {
+    uint8_t header[8] = {static_cast<uint8_t>(size >> 24), static_cast<uint8_t>(size >> 16),
+                         static_cast<uint8_t>(size >> 8), static_cast<uint8_t>(size),
+                         static_cast<uint8_t>(type[0]), static_cast<uint8_t>(type[1]),
+                         static_cast<uint8_t>(type[2]), static_cast<uint8_t>(type[3])};
+    out.insert(out.end(), header, header + 8);
+    if (size > 0) {
+        out.insert(out.end(), data, data + size);
+    }
+    uLong crc = crc32(0L, header + 4, 4);
+    if (size > 0) {
+        crc = crc32(crc, data, static_cast<uInt>(size));
+    }
+    uint8_t trailer[4] = {static_cast<uint8_t>(crc >> 24), static_cast<uint8_t>(crc >> 16),
+                          static_cast<uint8_t>(crc >> 8), static_cast<uint8_t>(crc)};
+    out.insert(out.end(), trailer, trailer + 4);
+}
 
-    std::vector<uint8_t> interleaved(total_size);
+std::vector<uint8_t> encode_png(const uint8_t *data, int width, int height,
+                                 int channels, int level) {
+    static const uint8_t color_types[] = {0, 0, 4, 2, 6};  // gray, gray+alpha, RGB, RGBA
+    if (channels < 1 || channels > 4) {
+        throw std::invalid_argument("PNG encoding supports 1-4 channels, got " + std::to_string(channels));
+    }
+    if (width <= 0 || height <= 0) {
+        throw std::invalid_argument("PNG encoding requires positive dimensions");
+    }
 
-    for (size_t pixel = 0; pixel < num_pixels; pixel++) {
-        for (size_t band = 0; band < num_bands; band++) {
-            size_t src_offset = pixel * dtype_size;
-            size_t dst_offset = (pixel * num_bands + band) * dtype_size;
-            std::memcpy(interleaved.data() + dst_offset,
-                        bands[band].data() + src_offset,
-                        dtype_size);
+    // Each row: filter byte 2 ("up": difference with the row above), then
+    // the row bytes. Rasters are smooth vertically, so this deflates well.
+    size_t row_bytes = static_cast<size_t>(width) * channels;
+    std::vector<uint8_t> filtered((row_bytes + 1) * height);
+    for (int y = 0; y < height; y++) {
+        uint8_t *dst = filtered.data() + y * (row_bytes + 1);
+        const uint8_t *row = data + y * row_bytes;
+        dst[0] = 2;
+        if (y == 0) {
+            std::memcpy(dst + 1, row, row_bytes);
+        } else {
+            const uint8_t *above = row - row_bytes;
+            for (size_t i = 0; i < row_bytes; i++) {
+                dst[1 + i] = static_cast<uint8_t>(row[i] - above[i]);
+            }
         }
     }
 
+    uLongf idat_size = compressBound(static_cast<uLong>(filtered.size()));
+    std::vector<uint8_t> idat(idat_size);
+    if (compress2(idat.data(), &idat_size, filtered.data(), static_cast<uLong>(filtered.size()), level) != Z_OK) {
+        throw std::runtime_error("PNG deflate failed");
+    }
+
+    std::vector<uint8_t> out = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    uint8_t ihdr[13] = {static_cast<uint8_t>(width >> 24), static_cast<uint8_t>(width >> 16),
+                        static_cast<uint8_t>(width >> 8), static_cast<uint8_t>(width),
+                        static_cast<uint8_t>(height >> 24), static_cast<uint8_t>(height >> 16),
+                        static_cast<uint8_t>(height >> 8), static_cast<uint8_t>(height),
+                        8, color_types[channels], 0, 0, 0};
+    append_png_chunk(out, "IHDR", ihdr, sizeof(ihdr));
+    append_png_chunk(out, "IDAT", idat.data(), idat_size);
+    append_png_chunk(out, "IEND", nullptr, 0);
+    return out;
+}
+
+std::vector<uint8_t> interleave_bands(const std::vector<std::vector<uint8_t>> &bands,
+                                       int width, int height, size_t dtype_size) {
+    std::vector<const uint8_t *> planes;
+    planes.reserve(bands.size());
+    for (auto &band : bands) {
+        planes.push_back(band.data());
+    }
+    return interleave_bands(planes, width, height, dtype_size);
+}
+
+std::vector<uint8_t> interleave_bands(const std::vector<const uint8_t *> &bands,
+                                       int width, int height, size_t dtype_size) {
+    size_t num_bands = bands.size();
+    size_t num_pixels = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> interleaved(num_pixels * num_bands * dtype_size);
+    interleave_planes(bands.data(), num_bands, num_pixels, dtype_size, interleaved.data());
     return interleaved;
 }
 
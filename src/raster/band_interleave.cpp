@@ -0,0 +1,308 @@
+#include "band_interleave.hpp"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define RAQUET_INTERLEAVE_X86 1
+#include <immintrin.h>
+#endif
+
+namespace duckdb {
+namespace raquet {
+
+namespace {
+
+// ─────────────────────────────────────────────
+// Scalar fallback: fixed-size copies for the common sample sizes so the
+// per-sample memcpy compiles to a single move
+// ─────────────────────────────────────────────
+template <size_t ELEM>
+void InterleaveScalar(const uint8_t *const *planes, size_t num_bands, size_t begin, size_t end, uint8_t *dst) {
+    for (size_t p = begin; p < end; p++) {
+        uint8_t *out = dst + p * num_bands * ELEM;
+        for (size_t b = 0; b < num_bands; b++) {
+            std::memcpy(out + b * ELEM, planes[b] + p * ELEM, ELEM);
+        }
+    }
+}
+
+template <size_t ELEM>
+void DeinterleaveScalar(const uint8_t *src, size_t num_bands, size_t band_index, size_t begin, size_t end,
+                        uint8_t *dst) {
+    for (size_t p = begin; p < end; p++) {
+        std::memcpy(dst + p * ELEM, src + (p * num_bands + band_index) * ELEM, ELEM);
+    }
+}
+
+void InterleaveTail(const uint8_t *const *planes, size_t num_bands, size_t elem_size, size_t begin, size_t end,
+                    uint8_t *dst) {
+    switch (elem_size) {
+        case 1: InterleaveScalar<1>(planes, num_bands, begin, end, dst); return;
+        case 2: InterleaveScalar<2>(planes, num_bands, begin, end, dst); return;
+        case 4: InterleaveScalar<4>(planes, num_bands, begin, end, dst); return;
+        case 8: InterleaveScalar<8>(planes, num_bands, begin, end, dst); return;
+        default:
+            for (size_t p = begin; p < end; p++) {
+                for (size_t b = 0; b < num_bands; b++) {
+                    std::memcpy(dst + (p * num_bands + b) * elem_size, planes[b] + p * elem_size, elem_size);
+                }
+            }
+    }
+}
+
+void DeinterleaveTail(const uint8_t *src, size_t num_bands, size_t band_index, size_t elem_size, size_t begin,
+                      size_t end, uint8_t *dst) {
+    switch (elem_size) {
+        case 1: DeinterleaveScalar<1>(src, num_bands, band_index, begin, end, dst); return;
+        case 2: DeinterleaveScalar<2>(src, num_bands, band_index, begin, end, dst); return;
+        case 4: DeinterleaveScalar<4>(src, num_bands, band_index, begin, end, dst); return;
+        case 8: DeinterleaveScalar<8>(src, num_bands, band_index, begin, end, dst); return;
+        default:
+            for (size_t p = begin; p < end; p++) {
+                std::memcpy(dst + p * elem_size, src + (p * num_bands + band_index) * elem_size, elem_size);
+            }
+    }
+}
+
+#ifdef RAQUET_INTERLEAVE_X86
+
+// ─────────────────────────────────────────────
+// Byte-shuffle transpose. A block is 16 bytes of every plane (16 / elem
+// pixels) against 16 * NB bytes of BIP. Output register m of a block is
+// the OR of pshufb(plane b, mask[m][b]) over the bands; each mask moves
+// the bytes of band b that land in register m and zeroes (0x80) the rest.
+// Deinterleave is the same in reverse: pshufb(BIP register k, mask[k])
+// OR-ed over the NB input registers. AVX2 runs two blocks per iteration,
+// one per 128-bit lane (pshufb does not cross lanes).
+// ─────────────────────────────────────────────
+struct ShuffleMasks {
+    alignas(16) uint8_t bytes[4][4][16];
+};
+
+ShuffleMasks InterleaveMasks(size_t num_bands, size_t elem_size) {
+    ShuffleMasks masks;
+    size_t pixel_bytes = num_bands * elem_size;
+    for (size_t m = 0; m < num_bands; m++) {
+        for (size_t b = 0; b < num_bands; b++) {
+            for (size_t j = 0; j < 16; j++) {
+                size_t o = 16 * m + j;
+                size_t pixel = o / pixel_bytes;
+                size_t band = (o % pixel_bytes) / elem_size;
+                masks.bytes[m][b][j] = band == b ? static_cast<uint8_t>(pixel * elem_size + o % elem_size) : 0x80;
+            }
+        }
+    }
+    return masks;
+}
+
+ShuffleMasks DeinterleaveMasks(size_t num_bands, size_t band_index, size_t elem_size) {
+    ShuffleMasks masks;
+    size_t pixel_bytes = num_bands * elem_size;
+    for (size_t k = 0; k < num_bands; k++) {
+        for (size_t j = 0; j < 16; j++) {
+            size_t idx = (j / elem_size) * pixel_bytes + band_index * elem_size + j % elem_size;
+            masks.bytes[k][0][j] = idx / 16 == k ? static_cast<uint8_t>(idx % 16) : 0x80;
+        }
+    }
+    return masks;
+}
+
+template <int NB>
+__attribute__((target("ssse3"))) size_t InterleaveSSSE3(const uint8_t *const *planes, size_t elem_size,
+                                                        size_t num_pixels, uint8_t *dst) {
+    ShuffleMasks masks = InterleaveMasks(NB, elem_size);
+    __m128i shuffle[NB][NB];
+    for (int m = 0; m < NB; m++) {
+        for (int b = 0; b < NB; b++) {
+            shuffle[m][b] = _mm_load_si128(reinterpret_cast<const __m128i *>(masks.bytes[m][b]));
+        }
+    }
+    const size_t block = 16 / elem_size;
+    size_t p = 0;
+    for (; p + block <= num_pixels; p += block) {
+        __m128i in[NB];
+        for (int b = 0; b < NB; b++) {
+            in[b] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(planes[b] + p * elem_size));
+        }
+        uint8_t *out = dst + p * NB * elem_size;
+        for (int m = 0; m < NB; m++) {
+            __m128i acc = _mm_shuffle_epi8(in[0], shuffle[m][0]);
+            for (int b = 1; b < NB; b++) {
+                acc = _mm_or_si128(acc, _mm_shuffle_epi8(in[b], shuffle[m][b]));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * m), acc);
+        }
+    }
+    return p;
+}
+
+template <int NB>
+__attribute__((target("avx2"))) size_t InterleaveAVX2(const uint8_t *const *planes, size_t elem_size,
+                                                      size_t num_pixels, uint8_t *dst) {
+    ShuffleMasks masks = InterleaveMasks(NB, elem_size);
+    __m256i shuffle[NB][NB];
+    for (int m = 0; m < NB; m++) {
+        for (int b = 0; b < NB; b++) {
+            shuffle[m][b] = _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i *>(masks.bytes[m][b])));
+        }
+    }
+    const size_t block = 32 / elem_size;
+    size_t p = 0;
+    for (; p + block <= num_pixels; p += block) {
+        __m256i in[NB];
+        for (int b = 0; b < NB; b++) {
+            in[b] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(planes[b] + p * elem_size));
+        }
+        uint8_t *out = dst + p * NB * elem_size;
+        for (int m = 0; m < NB; m++) {
+            __m256i acc = _mm256_shuffle_epi8(in[0], shuffle[m][0]);
+            for (int b = 1; b < NB; b++) {
+                acc = _mm256_or_si256(acc, _mm256_shuffle_epi8(in[b], shuffle[m][b]));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * m), _mm256_castsi256_si128(acc));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 16 * (NB + m)), _mm256_extracti128_si256(acc, 1));
+        }
+    }
+    return p;
+}
+
+template <int NB>
+__attribute__((target("ssse3"))) size_t DeinterleaveSSSE3(const uint8_t *src, size_t band_index,
+                                                          size_t elem_size, size_t num_pixels, uint8_t *dst) {
+    ShuffleMasks masks = DeinterleaveMasks(NB, band_index, elem_size);
+    __m128i shuffle[NB];
+    for (int k = 0; k < NB; k++) {
+        shuffle[k] = _mm_load_si128(reinterpret_cast<const __m128i *>(masks.bytes[k][0]));
+    }
+    const size_t block = 16 / elem_size;
+    size_t p = 0;
+    for (; p + block <= num_pixels; p += block) {
+        const uint8_t *in = src + p * NB * elem_size;
+        __m128i acc = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in)), shuffle[0]);
+        for (int k = 1; k < NB; k++) {
+            acc = _mm_or_si128(acc, _mm_shuffle_epi8(
+                                        _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 16 * k)), shuffle[k]));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + p * elem_size), acc);
+    }
+    return p;
+}
+
+template <int NB>
+__attribute__((target("avx2"))) size_t DeinterleaveAVX2(const uint8_t *src, size_t band_index, size_t elem_size,
+                                                        size_t num_pixels, uint8_t *dst) {
+    ShuffleMasks masks = DeinterleaveMasks(NB, band_index, elem_size);
+    __m256i shuffle[NB];
+    for (int k = 0; k < NB; k++) {
+        shuffle[k] = _mm256_broadcastsi128_si256(
+            _mm_load_si128(reinterpret_cast<const __m128i *>(masks.bytes[k][0])));
+    }
+    const size_t block = 32 / elem_size;
+    size_t p = 0;
+    for (; p + block <= num_pixels; p += block) {
+        const uint8_t *lo = src + p * NB * elem_size;
+        const uint8_t *hi = lo + 16 * NB;
+        __m256i acc = _mm256_setzero_si256();
+        for (int k = 0; k < NB; k++) {
+            __m256i in = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(lo + 16 * k))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i *>(hi + 16 * k)), 1);
+            acc = _mm256_or_si256(acc, _mm256_shuffle_epi8(in, shuffle[k]));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + p * elem_size), acc);
+    }
+    return p;
+}
+
+#endif // RAQUET_INTERLEAVE_X86
+
+enum class InterleaveIsa { SCALAR, SSSE3, AVX2 };
+
+InterleaveIsa DetectIsa() {
+#ifdef RAQUET_INTERLEAVE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return InterleaveIsa::AVX2;
+    if (__builtin_cpu_supports("ssse3")) return InterleaveIsa::SSSE3;
+#endif
+    return InterleaveIsa::SCALAR;
+}
+
+InterleaveIsa Isa() {
+    static const InterleaveIsa isa = DetectIsa();
+    return isa;
+}
+
+bool HasShuffleKernel(size_t num_bands, size_t elem_size) {
+    return num_bands >= 2 && num_bands <= 4 &&
+           (elem_size == 1 || elem_size == 2 || elem_size == 4 || elem_size == 8);
+}
+
+} // namespace
+
+void interleave_planes(const uint8_t *const *planes, size_t num_bands, size_t num_pixels, size_t elem_size,
+                       uint8_t *dst) {
+    if (num_bands == 1) {
+        std::memcpy(dst, planes[0], num_pixels * elem_size);
+        return;
+    }
+    size_t done = 0;
+#ifdef RAQUET_INTERLEAVE_X86
+    if (HasShuffleKernel(num_bands, elem_size)) {
+        bool avx2 = Isa() == InterleaveIsa::AVX2;
+        if (avx2 || Isa() == InterleaveIsa::SSSE3) {
+            switch (num_bands) {
+                case 2: done = avx2 ? InterleaveAVX2<2>(planes, elem_size, num_pixels, dst)
+                                    : InterleaveSSSE3<2>(planes, elem_size, num_pixels, dst); break;
+                case 3: done = avx2 ? InterleaveAVX2<3>(planes, elem_size, num_pixels, dst)
+                                    : InterleaveSSSE3<3>(planes, elem_size, num_pixels, dst); break;
+                case 4: done = avx2 ? InterleaveAVX2<4>(planes, elem_size, num_pixels, dst)
+                                    : InterleaveSSSE3<4>(planes, elem_size, num_pixels, dst); break;
+            }
+        }
+    }
+#endif
+    InterleaveTail(planes, num_bands, elem_size, done, num_pixels, dst);
+}
+
+void deinterleave_band(const uint8_t *src, size_t num_bands, size_t band_index, size_t num_pixels,
+                       size_t elem_size, uint8_t *dst) {
+    if (num_bands == 1) {
+        std::memcpy(dst, src, num_pixels * elem_size);
+        return;
+    }
+    size_t done = 0;
+#ifdef RAQUET_INTERLEAVE_X86
+    if (HasShuffleKernel(num_bands, elem_size)) {
+        // For 3-4 bands the AVX2 lane inserts cost more than the wider
+        // shuffles save; the SSSE3 kernel is faster there
+        bool avx2 = Isa() == InterleaveIsa::AVX2 && num_bands == 2;
+        if (Isa() != InterleaveIsa::SCALAR) {
+            switch (num_bands) {
+                case 2: done = avx2 ? DeinterleaveAVX2<2>(src, band_index, elem_size, num_pixels, dst)
+                                    : DeinterleaveSSSE3<2>(src, band_index, elem_size, num_pixels, dst); break;
+                case 3: done = DeinterleaveSSSE3<3>(src, band_index, elem_size, num_pixels, dst); break;
+                case 4: done = DeinterleaveSSSE3<4>(src, band_index, elem_size, num_pixels, dst); break;
+            }
+        }
+    }
+#endif
+    DeinterleaveTail(src, num_bands, band_index, elem_size, done, num_pixels, dst);
+}
+
+void deinterleave_planes(const uint8_t *src, size_t num_bands, size_t num_pixels, size_t elem_size,
+                         uint8_t *const *planes) {
+    for (size_t b = 0; b < num_bands; b++) {
+        deinterleave_band(src, num_bands, b, num_pixels, elem_size, planes[b]);
+    }
+}
+
+const char *interleave_kernel_isa() {
+    switch (Isa()) {
+        case InterleaveIsa::AVX2: return "avx2";
+        case InterleaveIsa::SSSE3: return "ssse3";
+        default: return "scalar";
+    }
+}
+
+} // namespace raquet
+} // namespace duckdb
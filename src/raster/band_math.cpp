@@ -1,11 +1,15 @@
 #include "duckdb.hpp"
 #include "duckdb/common/exception.hpp"
+#include "duckdb/function/aggregate_function.hpp"
 #include "duckdb/function/scalar_function.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
 #include "band_decoder.hpp"
 #include "raquet_metadata.hpp"
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <unordered_map>
+#include <vector>
 
 namespace duckdb {
 
@@ -14,20 +18,24 @@ namespace duckdb {
 // These functions perform pixel-by-pixel operations on raster bands
 // ============================================================================
 
-// Helper: Decode band data and return raw pixel pointer with data size
-static const uint8_t* DecodeBandData(const string_t &band, bool compressed,
+// Helper: Decode band data and return raw pixel pointer with data size.
+// Constant tiles are not expanded: the pointer is to their one value and
+// pixel_step is 0, so loops read pixel p at index p * pixel_step.
+static const uint8_t* DecodeBandData(const string_t &band, const raquet::BandCodec &codec,
+                                      raquet::BandDataType dtype, int width, int height,
                                       std::vector<uint8_t> &decompressed_buffer,
-                                      size_t &data_size_out) {
-    if (compressed) {
-        decompressed_buffer = raquet::decompress_gzip(
-            reinterpret_cast<const uint8_t*>(band.GetData()),
-            band.GetSize()
-        );
-        data_size_out = decompressed_buffer.size();
-        return decompressed_buffer.data();
+                                      size_t &data_size_out, size_t &pixel_step) {
+    auto data = reinterpret_cast<const uint8_t*>(band.GetData());
+    size_t size = band.GetSize();
+    raquet::resolve_tile_ref(data, size, codec);
+    if (raquet::is_constant_tile(data, size, raquet::dtype_size(dtype), codec)) {
+        data_size_out = raquet::dtype_size(dtype);
+        pixel_step = 0;
+        return raquet::constant_tile_value(data);
     }
-    data_size_out = band.GetSize();
-    return reinterpret_cast<const uint8_t*>(band.GetData());
+    pixel_step = 1;
+    return raquet::decode_band_bytes(data, size, codec, raquet::dtype_size(dtype),
+                                     width, height, 1, decompressed_buffer, data_size_out);
 }
 
 // ============================================================================
@@ -64,7 +72,7 @@ static void STNormalizedDifferenceFunction(DataChunk &args, ExpressionState &sta
 
         auto band1 = band1_data[i];
         auto band2 = band2_data[i];
-        auto metadata_str = metadata_data[i].GetString();
+        auto metadata_str = metadata_data[i];
 
         if (band1.GetSize() == 0 || band2.GetSize() == 0) {
             list_data[i].offset = total_list_size;
@@ -74,8 +82,9 @@ static void STNormalizedDifferenceFunction(DataChunk &args, ExpressionState &sta
         }
 
         try {
-            auto meta = raquet::parse_metadata(metadata_str);
-            bool compressed = (meta.compression == "gzip");
+            const auto &meta = raquet::parse_metadata_cached(metadata_str.GetData(), metadata_str.GetSize());
+            auto codec1 = meta.band_codec(0);
+            auto codec2 = meta.band_codec(meta.bands.size() > 1 ? 1 : 0);
             int width = meta.block_width;
             int height = meta.block_height;
             size_t num_pixels = static_cast<size_t>(width) * height;
@@ -89,9 +98,11 @@ static void STNormalizedDifferenceFunction(DataChunk &args, ExpressionState &sta
 
             // Decompress band data
             std::vector<uint8_t> decompressed1, decompressed2;
-            size_t raw1_size, raw2_size;
-            const uint8_t *raw1 = DecodeBandData(band1, compressed, decompressed1, raw1_size);
-            const uint8_t *raw2 = DecodeBandData(band2, compressed, decompressed2, raw2_size);
+            size_t raw1_size, raw2_size, step1, step2;
+            const uint8_t *raw1 = DecodeBandData(band1, codec1, band1_dtype, width, height,
+                                                 decompressed1, raw1_size, step1);
+            const uint8_t *raw2 = DecodeBandData(band2, codec2, band2_dtype, width, height,
+                                                 decompressed2, raw2_size, step2);
 
             // Reserve space in result list
             ListVector::Reserve(result, total_list_size + num_pixels);
@@ -99,8 +110,8 @@ static void STNormalizedDifferenceFunction(DataChunk &args, ExpressionState &sta
 
             // Compute normalized difference for each pixel
             for (size_t p = 0; p < num_pixels; p++) {
-                double val1 = raquet::get_pixel_value(raw1, raw1_size, p, band1_dtype);
-                double val2 = raquet::get_pixel_value(raw2, raw2_size, p, band2_dtype);
+                double val1 = raquet::get_pixel_value(raw1, raw1_size, p * step1, band1_dtype);
+                double val2 = raquet::get_pixel_value(raw2, raw2_size, p * step2, band2_dtype);
 
                 double sum = val1 + val2;
                 double nd;
@@ -162,7 +173,7 @@ static void STNormalizedDifferenceNodataFunction(DataChunk &args, ExpressionStat
 
         auto band1 = band1_data[i];
         auto band2 = band2_data[i];
-        auto metadata_str = metadata_data[i].GetString();
+        auto metadata_str = metadata_data[i];
         double nodata = nodata_data[i];
 
         if (band1.GetSize() == 0 || band2.GetSize() == 0) {
@@ -173,8 +184,9 @@ static void STNormalizedDifferenceNodataFunction(DataChunk &args, ExpressionStat
         }
 
         try {
-            auto meta = raquet::parse_metadata(metadata_str);
-            bool compressed = (meta.compression == "gzip");
+            const auto &meta = raquet::parse_metadata_cached(metadata_str.GetData(), metadata_str.GetSize());
+            auto codec1 = meta.band_codec(0);
+            auto codec2 = meta.band_codec(meta.bands.size() > 1 ? 1 : 0);
             int width = meta.block_width;
             int height = meta.block_height;
             size_t num_pixels = static_cast<size_t>(width) * height;
@@ -186,16 +198,18 @@ static void STNormalizedDifferenceNodataFunction(DataChunk &args, ExpressionStat
             auto band2_dtype = raquet::parse_dtype(dtype2);
 
             std::vector<uint8_t> decompressed1, decompressed2;
-            size_t raw1_size, raw2_size;
-            const uint8_t *raw1 = DecodeBandData(band1, compressed, decompressed1, raw1_size);
-            const uint8_t *raw2 = DecodeBandData(band2, compressed, decompressed2, raw2_size);
+            size_t raw1_size, raw2_size, step1, step2;
+            const uint8_t *raw1 = DecodeBandData(band1, codec1, band1_dtype, width, height,
+                                                 decompressed1, raw1_size, step1);
+            const uint8_t *raw2 = DecodeBandData(band2, codec2, band2_dtype, width, height,
+                                                 decompressed2, raw2_size, step2);
 
             ListVector::Reserve(result, total_list_size + num_pixels);
             child_data = FlatVector::GetData<double>(ListVector::GetEntry(result));
 
             for (size_t p = 0; p < num_pixels; p++) {
-                double val1 = raquet::get_pixel_value(raw1, raw1_size, p, band1_dtype);
-                double val2 = raquet::get_pixel_value(raw2, raw2_size, p, band2_dtype);
+                double val1 = raquet::get_pixel_value(raw1, raw1_size, p * step1, band1_dtype);
+                double val2 = raquet::get_pixel_value(raw2, raw2_size, p * step2, band2_dtype);
 
                 // Check for nodata
                 if (val1 == nodata || val2 == nodata) {
@@ -264,7 +278,7 @@ static void STBandMathFunction(DataChunk &args, ExpressionState &state, Vector &
         auto band1 = band1_data[i];
         auto band2 = band2_data[i];
         auto op = op_data[i].GetString();
-        auto metadata_str = metadata_data[i].GetString();
+        auto metadata_str = metadata_data[i];
 
         if (band1.GetSize() == 0 || band2.GetSize() == 0) {
             list_data[i].offset = total_list_size;
@@ -274,8 +288,9 @@ static void STBandMathFunction(DataChunk &args, ExpressionState &state, Vector &
         }
 
         try {
-            auto meta = raquet::parse_metadata(metadata_str);
-            bool compressed = (meta.compression == "gzip");
+            const auto &meta = raquet::parse_metadata_cached(metadata_str.GetData(), metadata_str.GetSize());
+            auto codec1 = meta.band_codec(0);
+            auto codec2 = meta.band_codec(meta.bands.size() > 1 ? 1 : 0);
             int width = meta.block_width;
             int height = meta.block_height;
             size_t num_pixels = static_cast<size_t>(width) * height;
@@ -287,9 +302,11 @@ static void STBandMathFunction(DataChunk &args, ExpressionState &state, Vector &
             auto band2_dtype = raquet::parse_dtype(dtype2);
 
             std::vector<uint8_t> decompressed1, decompressed2;
-            size_t raw1_size, raw2_size;
-            const uint8_t *raw1 = DecodeBandData(band1, compressed, decompressed1, raw1_size);
-            const uint8_t *raw2 = DecodeBandData(band2, compressed, decompressed2, raw2_size);
+            size_t raw1_size, raw2_size, step1, step2;
+            const uint8_t *raw1 = DecodeBandData(band1, codec1, band1_dtype, width, height,
+                                                 decompressed1, raw1_size, step1);
+            const uint8_t *raw2 = DecodeBandData(band2, codec2, band2_dtype, width, height,
+                                                 decompressed2, raw2_size, step2);
 
             ListVector::Reserve(result, total_list_size + num_pixels);
             child_data = FlatVector::GetData<double>(ListVector::GetEntry(result));
@@ -312,8 +329,8 @@ static void STBandMathFunction(DataChunk &args, ExpressionState &state, Vector &
             }
 
             for (size_t p = 0; p < num_pixels; p++) {
-                double val1 = raquet::get_pixel_value(raw1, raw1_size, p, band1_dtype);
-                double val2 = raquet::get_pixel_value(raw2, raw2_size, p, band2_dtype);
+                double val1 = raquet::get_pixel_value(raw1, raw1_size, p * step1, band1_dtype);
+                double val2 = raquet::get_pixel_value(raw2, raw2_size, p * step2, band2_dtype);
 
                 double res;
                 switch (operation) {
@@ -384,7 +401,7 @@ static void STNormalizedDifferenceStatsFunction(DataChunk &args, ExpressionState
 
         auto band1 = band1_data[i];
         auto band2 = band2_data[i];
-        auto metadata_str = metadata_data[i].GetString();
+        auto metadata_str = metadata_data[i];
 
         if (band1.GetSize() == 0 || band2.GetSize() == 0) {
             result_validity.SetInvalid(i);
@@ -392,8 +409,9 @@ static void STNormalizedDifferenceStatsFunction(DataChunk &args, ExpressionState
         }
 
         try {
-            auto meta = raquet::parse_metadata(metadata_str);
-            bool compressed = (meta.compression == "gzip");
+            const auto &meta = raquet::parse_metadata_cached(metadata_str.GetData(), metadata_str.GetSize());
+            auto codec1 = meta.band_codec(0);
+            auto codec2 = meta.band_codec(meta.bands.size() > 1 ? 1 : 0);
             int width = meta.block_width;
             int height = meta.block_height;
             size_t num_pixels = static_cast<size_t>(width) * height;
@@ -405,9 +423,11 @@ static void STNormalizedDifferenceStatsFunction(DataChunk &args, ExpressionState
             auto band2_dtype = raquet::parse_dtype(dtype2);
 
             std::vector<uint8_t> decompressed1, decompressed2;
-            size_t raw1_size, raw2_size;
-            const uint8_t *raw1 = DecodeBandData(band1, compressed, decompressed1, raw1_size);
-            const uint8_t *raw2 = DecodeBandData(band2, compressed, decompressed2, raw2_size);
+            size_t raw1_size, raw2_size, step1, step2;
+            const uint8_t *raw1 = DecodeBandData(band1, codec1, band1_dtype, width, height,
+                                                 decompressed1, raw1_size, step1);
+            const uint8_t *raw2 = DecodeBandData(band2, codec2, band2_dtype, width, height,
+                                                 decompressed2, raw2_size, step2);
 
             // Streaming statistics using Welford's algorithm
             int64_t count = 0;
@@ -418,8 +438,8 @@ static void STNormalizedDifferenceStatsFunction(DataChunk &args, ExpressionState
             double max_val = std::numeric_limits<double>::lowest();
 
             for (size_t p = 0; p < num_pixels; p++) {
-                double val1 = raquet::get_pixel_value(raw1, raw1_size, p, band1_dtype);
-                double val2 = raquet::get_pixel_value(raw2, raw2_size, p, band2_dtype);
+                double val1 = raquet::get_pixel_value(raw1, raw1_size, p * step1, band1_dtype);
+                double val2 = raquet::get_pixel_value(raw2, raw2_size, p * step2, band2_dtype);
 
                 double s = val1 + val2;
                 double nd = (s != 0.0) ? (val1 - val2) / s : 0.0;
@@ -450,6 +470,297 @@ static void STNormalizedDifferenceStatsFunction(DataChunk &args, ExpressionState
     }
 }
 
+// ============================================================================
+// ST_ZonalStatsByBand(value_band, zone_band, metadata [, value_name, zone_name])
+//   -> MAP(BIGINT, STRUCT(count, sum, mean, min, max, stddev))
+// Stats of one band grouped by the classes of another (e.g. NDVI by land
+// cover). Both bands are decoded once per tile. Zones of 8 bits or less
+// (uint1..uint8, int8) go to a dense array indexed by class, wider integer
+// zones to a hash map. Band types and nodata come from the named bands, or
+// bands 1 and 2 like ST_NormalizedDifference; zone nodata pixels are skipped.
+// ============================================================================
+
+struct ZoneAccumulator {
+    int64_t count = 0;
+    double sum = 0.0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double min_val = std::numeric_limits<double>::max();
+    double max_val = std::numeric_limits<double>::lowest();
+
+    void Add(double value) {
+        count++;
+        sum += value;
+        double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+        if (value < min_val) min_val = value;
+        if (value > max_val) max_val = value;
+    }
+
+    void Merge(const ZoneAccumulator &other) {
+        if (other.count == 0) return;
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+        int64_t combined = count + other.count;
+        double delta = other.mean - mean;
+        m2 += other.m2 + delta * delta * static_cast<double>(count) * other.count / combined;
+        mean += delta * other.count / combined;
+        count = combined;
+        sum += other.sum;
+        if (other.min_val < min_val) min_val = other.min_val;
+        if (other.max_val > max_val) max_val = other.max_val;
+    }
+};
+
+// Dense slots cover int8 and every unsigned type up to 8 bits:
+// slot = class + ZONE_DENSE_OFFSET
+static constexpr int64_t ZONE_DENSE_OFFSET = 128;
+static constexpr size_t ZONE_DENSE_SLOTS = 384;
+
+struct ZonalStatsByBandState {
+    std::vector<ZoneAccumulator> *dense;
+    std::unordered_map<int64_t, ZoneAccumulator> *sparse;
+};
+
+static idx_t ZonalStatsByBandStateSize(const AggregateFunction &) {
+    return sizeof(ZonalStatsByBandState);
+}
+
+static void ZonalStatsByBandInitialize(const AggregateFunction &, data_ptr_t state) {
+    auto &s = *reinterpret_cast<ZonalStatsByBandState *>(state);
+    s.dense = nullptr;
+    s.sparse = nullptr;
+}
+
+static void ZonalStatsByBandDestroy(Vector &state_vector, AggregateInputData &aggr_input_data, idx_t count) {
+    auto states = FlatVector::GetData<ZonalStatsByBandState *>(state_vector);
+    for (idx_t i = 0; i < count; i++) {
+        delete states[i]->dense;
+        delete states[i]->sparse;
+        states[i]->dense = nullptr;
+        states[i]->sparse = nullptr;
+    }
+}
+
+static bool IsDenseZoneType(raquet::BandDataType dtype) {
+    switch (dtype) {
+        case raquet::BandDataType::UINT1:
+        case raquet::BandDataType::UINT2:
+        case raquet::BandDataType::UINT4:
+        case raquet::BandDataType::UINT8:
+        case raquet::BandDataType::INT8:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static void ProcessTileForZonalStats(ZonalStatsByBandState &state, const string_t &value_band,
+                                     const string_t &zone_band, const raquet::RaquetMetadata &meta,
+                                     int value_index, int zone_index) {
+    auto value_dtype = raquet::parse_dtype(meta.bands[value_index].second);
+    auto zone_dtype = raquet::parse_dtype(meta.bands[zone_index].second);
+    if (zone_dtype == raquet::BandDataType::FLOAT16 || zone_dtype == raquet::BandDataType::FLOAT32 ||
+        zone_dtype == raquet::BandDataType::FLOAT64) {
+        throw InvalidInputException("ST_ZonalStatsByBand: zone band '%s' must be an integer type, got %s",
+                                    meta.bands[zone_index].first, meta.bands[zone_index].second);
+    }
+
+    bool value_has_nodata = false, zone_has_nodata = false;
+    double value_nodata = 0.0, zone_nodata = 0.0;
+    if (value_index < static_cast<int>(meta.band_info.size()) && meta.band_info[value_index].has_nodata) {
+        value_has_nodata = true;
+        value_nodata = meta.band_info[value_index].nodata;
+    }
+    if (zone_index < static_cast<int>(meta.band_info.size()) && meta.band_info[zone_index].has_nodata) {
+        zone_has_nodata = true;
+        zone_nodata = meta.band_info[zone_index].nodata;
+    }
+
+    int width = meta.block_width;
+    int height = meta.block_height;
+    size_t num_pixels = static_cast<size_t>(width) * height;
+
+    std::vector<uint8_t> value_buffer, zone_buffer;
+    size_t value_size, zone_size, value_step, zone_step;
+    const uint8_t *values = DecodeBandData(value_band, meta.band_codec(value_index), value_dtype, width, height,
+                                           value_buffer, value_size, value_step);
+    const uint8_t *zones = DecodeBandData(zone_band, meta.band_codec(zone_index), zone_dtype, width, height,
+                                          zone_buffer, zone_size, zone_step);
+
+    auto value_ok = [&](double v) {
+        return !(value_has_nodata && (v == value_nodata || (std::isnan(v) && std::isnan(value_nodata))));
+    };
+
+    if (IsDenseZoneType(zone_dtype)) {
+        if (!state.dense) {
+            state.dense = new std::vector<ZoneAccumulator>(ZONE_DENSE_SLOTS);
+        }
+        auto &slots = *state.dense;
+        bool zone_signed = zone_dtype == raquet::BandDataType::INT8;
+        for (size_t p = 0; p < num_pixels; p++) {
+            uint8_t raw = zones[p * zone_step];
+            int64_t zone = zone_signed ? static_cast<int8_t>(raw) : raw;
+            if (zone_has_nodata && static_cast<double>(zone) == zone_nodata) continue;
+            double v = raquet::get_pixel_value(values, value_size, p * value_step, value_dtype);
+            if (!value_ok(v)) continue;
+            slots[zone + ZONE_DENSE_OFFSET].Add(v);
+        }
+        return;
+    }
+
+    if (!state.sparse) {
+        state.sparse = new std::unordered_map<int64_t, ZoneAccumulator>();
+    }
+    // Zones are spatially coherent: remember the last slot to skip most lookups
+    int64_t last_zone = 0;
+    ZoneAccumulator *last_slot = nullptr;
+    for (size_t p = 0; p < num_pixels; p++) {
+        double zone_value = raquet::get_pixel_value(zones, zone_size, p * zone_step, zone_dtype);
+        if (zone_has_nodata && zone_value == zone_nodata) continue;
+        double v = raquet::get_pixel_value(values, value_size, p * value_step, value_dtype);
+        if (!value_ok(v)) continue;
+        auto zone = static_cast<int64_t>(zone_value);
+        if (!last_slot || zone != last_zone) {
+            last_slot = &(*state.sparse)[zone];
+            last_zone = zone;
+        }
+        last_slot->Add(v);
+    }
+}
+
+static void ZonalStatsByBandUpdate(Vector inputs[], AggregateInputData &aggr_input_data, idx_t input_count,
+                                   Vector &state_vector, idx_t count) {
+    for (idx_t c = 0; c < input_count; c++) {
+        inputs[c].Flatten(count);
+    }
+    auto value_data = FlatVector::GetData<string_t>(inputs[0]);
+    auto zone_data = FlatVector::GetData<string_t>(inputs[1]);
+    auto metadata_data = FlatVector::GetData<string_t>(inputs[2]);
+    auto &value_validity = FlatVector::Validity(inputs[0]);
+    auto &zone_validity = FlatVector::Validity(inputs[1]);
+
+    auto states = FlatVector::GetData<ZonalStatsByBandState *>(state_vector);
+
+    // Band names normally repeat on every row, so they are resolved once per
+    // run of rows sharing the same metadata and names, without copying them
+    bool resolved = false;
+    string_t resolved_metadata, resolved_value_name, resolved_zone_name;
+    int resolved_value_index = 0;
+    int resolved_zone_index = 0;
+
+    for (idx_t i = 0; i < count; i++) {
+        if (!value_validity.RowIsValid(i) || !zone_validity.RowIsValid(i)) continue;
+        if (value_data[i].GetSize() == 0 || zone_data[i].GetSize() == 0) continue;
+
+        const auto &meta = raquet::parse_metadata_cached(metadata_data[i].GetData(), metadata_data[i].GetSize());
+        int value_index = 0;
+        int zone_index = meta.bands.size() > 1 ? 1 : 0;
+        if (input_count == 5) {
+            const auto &value_name = FlatVector::GetData<string_t>(inputs[3])[i];
+            const auto &zone_name = FlatVector::GetData<string_t>(inputs[4])[i];
+            if (!resolved || !(resolved_metadata == metadata_data[i]) || !(resolved_value_name == value_name) ||
+                !(resolved_zone_name == zone_name)) {
+                resolved_value_index = meta.get_band_index(value_name.GetString());
+                resolved_zone_index = meta.get_band_index(zone_name.GetString());
+                if (resolved_value_index < 0 || resolved_zone_index < 0) {
+                    throw InvalidInputException("ST_ZonalStatsByBand: unknown band '%s'",
+                                                resolved_value_index < 0 ? value_name.GetString()
+                                                                         : zone_name.GetString());
+                }
+                resolved = true;
+                resolved_metadata = metadata_data[i];
+                resolved_value_name = value_name;
+                resolved_zone_name = zone_name;
+            }
+            value_index = resolved_value_index;
+            zone_index = resolved_zone_index;
+        }
+        if (meta.bands.empty()) continue;
+        ProcessTileForZonalStats(*states[i], value_data[i], zone_data[i], meta, value_index, zone_index);
+    }
+}
+
+static void ZonalStatsByBandCombine(Vector &source, Vector &target, AggregateInputData &aggr_input_data,
+                                    idx_t count) {
+    auto source_data = FlatVector::GetData<ZonalStatsByBandState *>(source);
+    auto target_data = FlatVector::GetData<ZonalStatsByBandState *>(target);
+
+    for (idx_t i = 0; i < count; i++) {
+        auto &src = *source_data[i];
+        auto &tgt = *target_data[i];
+        if (src.dense) {
+            if (!tgt.dense) {
+                tgt.dense = new std::vector<ZoneAccumulator>(ZONE_DENSE_SLOTS);
+            }
+            for (size_t z = 0; z < ZONE_DENSE_SLOTS; z++) {
+                (*tgt.dense)[z].Merge((*src.dense)[z]);
+            }
+        }
+        if (src.sparse) {
+            if (!tgt.sparse) {
+                tgt.sparse = new std::unordered_map<int64_t, ZoneAccumulator>();
+            }
+            for (auto &entry : *src.sparse) {
+                (*tgt.sparse)[entry.first].Merge(entry.second);
+            }
+        }
+    }
+}
+
+static void ZonalStatsByBandFinalize(Vector &states, AggregateInputData &aggr_input_data, Vector &result,
+                                     idx_t count, idx_t offset) {
+    auto state_data = FlatVector::GetData<ZonalStatsByBandState *>(states);
+    auto &map_type = result.GetType();
+    auto &key_type = MapType::KeyType(map_type);
+    auto &value_type = MapType::ValueType(map_type);
+
+    for (idx_t i = 0; i < count; i++) {
+        auto &state = *state_data[i];
+
+        std::vector<std::pair<int64_t, ZoneAccumulator>> zones;
+        if (state.dense) {
+            for (size_t z = 0; z < ZONE_DENSE_SLOTS; z++) {
+                if ((*state.dense)[z].count > 0) {
+                    zones.emplace_back(static_cast<int64_t>(z) - ZONE_DENSE_OFFSET, (*state.dense)[z]);
+                }
+            }
+        }
+        if (state.sparse) {
+            for (auto &entry : *state.sparse) {
+                zones.push_back(entry);
+            }
+        }
+        if (zones.empty()) {
+            FlatVector::SetNull(result, offset + i, true);
+            continue;
+        }
+        std::sort(zones.begin(), zones.end(),
+                  [](const std::pair<int64_t, ZoneAccumulator> &a, const std::pair<int64_t, ZoneAccumulator> &b) {
+                      return a.first < b.first;
+                  });
+
+        vector<Value> keys, values;
+        for (auto &zone : zones) {
+            auto &acc = zone.second;
+            keys.push_back(Value::BIGINT(zone.first));
+            child_list_t<Value> stats;
+            stats.push_back(make_pair("count", Value::BIGINT(acc.count)));
+            stats.push_back(make_pair("sum", Value::DOUBLE(acc.sum)));
+            stats.push_back(make_pair("mean", Value::DOUBLE(acc.sum / acc.count)));
+            stats.push_back(make_pair("min", Value::DOUBLE(acc.min_val)));
+            stats.push_back(make_pair("max", Value::DOUBLE(acc.max_val)));
+            stats.push_back(make_pair("stddev", Value::DOUBLE(acc.count > 1 ? std::sqrt(acc.m2 / (acc.count - 1))
+                                                                            : 0.0)));
+            values.push_back(Value::STRUCT(std::move(stats)));
+        }
+        result.SetValue(offset + i, Value::MAP(key_type, value_type, std::move(keys), std::move(values)));
+    }
+}
+
 // ============================================================================
 // Function Registration
 // ============================================================================
@@ -492,6 +803,29 @@ void RegisterBandMathFunctions(ExtensionLoader &loader) {
         stats_type,
         STNormalizedDifferenceStatsFunction);
     loader.RegisterFunction(nd_stats_fn);
+
+    // ST_ZonalStatsByBand(value_band BLOB, zone_band BLOB, metadata VARCHAR [, value_name, zone_name])
+    //   -> MAP(BIGINT, STRUCT(...))
+    AggregateFunctionSet zonal_by_band_set("ST_ZonalStatsByBand");
+    auto zonal_map_type = LogicalType::MAP(LogicalType::BIGINT, stats_type);
+    AggregateFunction zonal_by_band(
+        {LogicalType::BLOB, LogicalType::BLOB, LogicalType::VARCHAR},
+        zonal_map_type,
+        ZonalStatsByBandStateSize,
+        ZonalStatsByBandInitialize,
+        ZonalStatsByBandUpdate,
+        ZonalStatsByBandCombine,
+        ZonalStatsByBandFinalize,
+        FunctionNullHandling::DEFAULT_NULL_HANDLING,
+        nullptr,  // simple_update
+        nullptr,  // bind
+        ZonalStatsByBandDestroy
+    );
+    zonal_by_band_set.AddFunction(zonal_by_band);
+    zonal_by_band.arguments.push_back(LogicalType::VARCHAR);
+    zonal_by_band.arguments.push_back(LogicalType::VARCHAR);
+    zonal_by_band_set.AddFunction(zonal_by_band);
+    loader.RegisterFunction(zonal_by_band_set);
 }
 
 } // namespace duckdb
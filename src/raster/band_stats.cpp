@@ -6,12 +6,18 @@
 #include <cpl_error.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <exception>
+#include <functional>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <random>
+#include <stdexcept>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -56,6 +62,71 @@ static inline bool is_fixed_bucket_int(GDALDataType dt) {
            dt == GDT_UInt16 || dt == GDT_Int16;
 }
 
+// Dense bucket layout for fixed-bucket ints: bucket key k lives at index
+// k - offset in a vector of `size` counters.
+static inline void fixed_bucket_range(GDALDataType dt, int64_t &offset, size_t &size) {
+    switch (dt) {
+        case GDT_Byte:   offset = 0;      size = 256;   break;
+        case GDT_Int8:   offset = -128;   size = 256;   break;
+        case GDT_UInt16: offset = 0;      size = 65536; break;
+        case GDT_Int16:  offset = -32768; size = 65536; break;
+        default:         offset = 0;      size = 0;     break;
+    }
+}
+
+// One native-dtype pixel as double.
+static inline double read_value(const uint8_t *p, GDALDataType dt) {
+    switch (dt) {
+        case GDT_Byte:    return static_cast<double>(*reinterpret_cast<const uint8_t *>(p));
+        case GDT_Int8:    return static_cast<double>(*reinterpret_cast<const int8_t  *>(p));
+        case GDT_UInt16:  return static_cast<double>(*reinterpret_cast<const uint16_t *>(p));
+        case GDT_Int16:   return static_cast<double>(*reinterpret_cast<const int16_t  *>(p));
+        case GDT_UInt32:  return static_cast<double>(*reinterpret_cast<const uint32_t *>(p));
+        case GDT_Int32:   return static_cast<double>(*reinterpret_cast<const int32_t  *>(p));
+        case GDT_UInt64:  return static_cast<double>(*reinterpret_cast<const uint64_t *>(p));
+        case GDT_Int64:   return static_cast<double>(*reinterpret_cast<const int64_t  *>(p));
+        case GDT_Float32: return static_cast<double>(*reinterpret_cast<const float    *>(p));
+        case GDT_Float64: return *reinterpret_cast<const double *>(p);
+        default:          return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+// Histogram bucketing shared by the serial and parallel exact paths. For
+// fixed-bucket ints the key is the value itself; otherwise values fall into
+// n_bins equal-width bins over [dmin, dmax] and report the bin center.
+struct HistogramBuckets {
+    bool fixed_int;
+    int n_bins;
+    double dmin, bin_span, bin_width;
+
+    HistogramBuckets(GDALDataType dtype, double dmin_p, double dmax) {
+        fixed_int = is_fixed_bucket_int(dtype);
+        n_bins = is_integer_dtype(dtype) ? kWideIntBins : kFloatBins;
+        dmin = dmin_p;
+        bin_span = (dmax > dmin) ? (dmax - dmin) : 1.0;
+        bin_width = bin_span / static_cast<double>(n_bins);
+    }
+
+    int64_t bucket_for(double v) const {
+        if (fixed_int) {
+            return static_cast<int64_t>(v);
+        }
+        double rel = (v - dmin) / bin_span;
+        int64_t b = static_cast<int64_t>(std::floor(rel * n_bins));
+        if (b < 0) b = 0;
+        if (b >= n_bins) b = n_bins - 1;
+        return b;
+    }
+
+    double value_for(int64_t bucket) const {
+        if (fixed_int) {
+            return static_cast<double>(bucket);
+        }
+        // bucket center
+        return dmin + (static_cast<double>(bucket) + 0.5) * bin_width;
+    }
+};
+
 // ─────────────────────────────────────────────
 // Step 1: pull basic stats from GDAL.
 // ─────────────────────────────────────────────
@@ -101,6 +172,21 @@ static bool extract_basic_stats(
 // ─────────────────────────────────────────────
 // Step 2a (approx): collect 1000-pixel random sample
 // ─────────────────────────────────────────────
+//
+// Block-clustered: a single-pixel GDALRasterIO on a compressed GeoTIFF
+// decompresses the whole internal block, so sampling pixel-by-pixel costs
+// up to kMaxSamples block decodes. Instead each iteration picks up to
+// kSampleBlocks internal blocks, reads each chosen block once with
+// GDALReadBlock, and draws all of that iteration's samples from them.
+//
+// Blocks are picked by drawing a uniform random pixel and taking its block
+// (so edge blocks are chosen in proportion to their valid area), then each
+// sample picks one of the chosen blocks uniformly and a uniform pixel
+// within its valid extent — every source pixel stays equally likely, as
+// in raster-loader's sampler. The seed, sample budget and iteration cap
+// are unchanged, so results remain deterministic.
+static constexpr int kSampleBlocks = 64;
+
 static std::vector<double> sample_band(
     GDALRasterBandH band,
     int raster_width, int raster_height,
@@ -110,21 +196,57 @@ static std::vector<double> sample_band(
     std::uniform_int_distribution<int> rx_dist(0, raster_width - 1);
     std::uniform_int_distribution<int> ry_dist(0, raster_height - 1);
 
+    int block_xsize = 0, block_ysize = 0;
+    GDALGetBlockSize(band, &block_xsize, &block_ysize);
+    if (block_xsize <= 0) block_xsize = 256;
+    if (block_ysize <= 0) block_ysize = 256;
+    const GDALDataType dtype = GDALGetRasterDataType(band);
+    const int dtype_size = GDALGetDataTypeSizeBytes(dtype);
+    std::vector<uint8_t> block_buf(static_cast<size_t>(block_xsize) *
+                                    static_cast<size_t>(block_ysize) *
+                                    static_cast<size_t>(dtype_size));
+
     std::vector<double> samples;
     samples.reserve(kMaxSamples);
 
     for (int iter = 0; iter < kMaxIterations; iter++) {
         const int needed = kMaxSamples - static_cast<int>(samples.size());
         if (needed <= 0) break;
+
+        // Choose blocks (area-weighted, with replacement).
+        std::vector<std::pair<int, int>> chosen;
+        chosen.reserve(kSampleBlocks);
+        for (int i = 0; i < kSampleBlocks; i++) {
+            chosen.emplace_back(rx_dist(rng) / block_xsize, ry_dist(rng) / block_ysize);
+        }
+
+        // Assign each sample to a chosen block; group so every block is
+        // read once per iteration.
+        std::uniform_int_distribution<int> pick(0, kSampleBlocks - 1);
+        std::map<std::pair<int, int>, int> per_block;
         for (int i = 0; i < needed; i++) {
-            const int px = rx_dist(rng);
-            const int py = ry_dist(rng);
-            double val = 0.0;
-            CPLErr err = GDALRasterIO(band, GF_Read, px, py, 1, 1,
-                                       &val, 1, 1, GDT_Float64, 0, 0);
-            if (err != CE_None) continue;
-            if (is_invalid(val, nodata, has_nodata)) continue;
-            samples.push_back(val);
+            per_block[chosen[pick(rng)]]++;
+        }
+
+        for (auto &kv : per_block) {
+            const int bx = kv.first.first;
+            const int by = kv.first.second;
+            const int valid_xsize = std::min(block_xsize, raster_width - bx * block_xsize);
+            const int valid_ysize = std::min(block_ysize, raster_height - by * block_ysize);
+            std::uniform_int_distribution<int> x_dist(0, valid_xsize - 1);
+            std::uniform_int_distribution<int> y_dist(0, valid_ysize - 1);
+            const bool read_ok = GDALReadBlock(band, bx, by, block_buf.data()) == CE_None;
+            for (int i = 0; i < kv.second; i++) {
+                // Draw positions even on a failed read so the RNG stream
+                // does not depend on IO errors.
+                const int x = x_dist(rng);
+                const int y = y_dist(rng);
+                if (!read_ok) continue;
+                const size_t offset = (static_cast<size_t>(y) * block_xsize + x) * dtype_size;
+                double val = read_value(block_buf.data() + offset, dtype);
+                if (is_invalid(val, nodata, has_nodata)) continue;
+                samples.push_back(val);
+            }
         }
     }
     return samples;
@@ -180,6 +302,66 @@ static void quantiles_and_top_values_from_sample(
     }
 }
 
+// Quantiles via CDF walk over an ordered (ascending key) histogram, plus
+// top-K buckets by frequency. method="lower" matches raster-loader's
+// numpy.quantile call.
+static void quantiles_and_top_values_from_buckets(
+    const std::vector<std::pair<int64_t, int64_t>> &histogram,
+    const HistogramBuckets &buckets,
+    std::map<int, std::vector<double>> &quantiles,
+    std::map<double, int64_t> &top_values) {
+
+    if (histogram.empty()) return;
+
+    int64_t total = 0;
+    for (auto &kv : histogram) total += kv.second;
+    if (total <= 0) return;
+
+    for (int N = kOverviewMin; N <= kOverviewMax; N++) {
+        std::vector<double> qs;
+        qs.reserve(N - 1);
+        // Targets are floor(total*j/N) for j in 1..N-1 — same formula as
+        // the sample path's index calculation.
+        std::vector<int64_t> targets;
+        targets.reserve(N - 1);
+        for (int j = 1; j < N; j++) {
+            targets.push_back((total * j) / N);
+        }
+        // Walk the CDF; for each target index, take the value of the
+        // bucket where the running count first crosses the target.
+        size_t target_idx = 0;
+        int64_t running = 0;
+        for (auto &kv : histogram) {
+            running += kv.second;
+            while (target_idx < targets.size() && running > targets[target_idx]) {
+                qs.push_back(buckets.value_for(kv.first));
+                target_idx++;
+            }
+            if (target_idx >= targets.size()) break;
+        }
+        // Pad in case of edge cases at the boundary.
+        while (qs.size() < static_cast<size_t>(N - 1)) {
+            qs.push_back(buckets.value_for(histogram.back().first));
+        }
+        quantiles[N] = std::move(qs);
+    }
+
+    // top_values: top-K buckets by frequency.
+    std::vector<std::pair<int64_t, int64_t>> ranked(histogram.begin(), histogram.end());
+    std::sort(ranked.begin(), ranked.end(),
+              [](const std::pair<int64_t, int64_t> &a,
+                 const std::pair<int64_t, int64_t> &b) {
+                  if (a.second != b.second) return a.second > b.second;
+                  return a.first < b.first;
+              });
+    const int K = std::min<int>(kMaxMostCommon, static_cast<int>(ranked.size()));
+    for (int i = 0; i < K; i++) {
+        if (ranked[i].second > 0) {
+            top_values[buckets.value_for(ranked[i].first)] = ranked[i].second;
+        }
+    }
+}
+
 // ─────────────────────────────────────────────
 // Step 2b (exact): histogram-based quantiles + top_values.
 // ─────────────────────────────────────────────
@@ -198,39 +380,8 @@ static void quantiles_and_top_values_from_histogram(
     std::map<int, std::vector<double>> &quantiles,
     std::map<double, int64_t> &top_values) {
 
-    // Bucketing strategy — see helpers above.
-    const bool fixed_int = is_fixed_bucket_int(dtype);
-    const bool integer_typed = is_integer_dtype(dtype);
-    const int  n_bins = integer_typed ? kWideIntBins : kFloatBins;
-    const double bin_span = (dmax > dmin) ? (dmax - dmin) : 1.0;
-    const double bin_width = bin_span / static_cast<double>(n_bins);
-
-    auto bucket_for = [&](double v) -> int64_t {
-        if (fixed_int) {
-            return static_cast<int64_t>(v);
-        }
-        if (integer_typed) {
-            // adaptive integer bins
-            double rel = (v - dmin) / bin_span;
-            int64_t b = static_cast<int64_t>(std::floor(rel * n_bins));
-            if (b < 0) b = 0;
-            if (b >= n_bins) b = n_bins - 1;
-            return b;
-        }
-        // float
-        double rel = (v - dmin) / bin_span;
-        int64_t b = static_cast<int64_t>(std::floor(rel * n_bins));
-        if (b < 0) b = 0;
-        if (b >= n_bins) b = n_bins - 1;
-        return b;
-    };
-    auto value_for = [&](int64_t bucket) -> double {
-        if (fixed_int) {
-            return static_cast<double>(bucket);
-        }
-        // bucket center
-        return dmin + (static_cast<double>(bucket) + 0.5) * bin_width;
-    };
+    // Bucketing strategy — see HistogramBuckets.
+    const HistogramBuckets buckets(dtype, dmin, dmax);
 
     // Accumulate via GDALReadBlock for efficient chunked I/O.
     int block_xsize = 0, block_ysize = 0;
@@ -248,22 +399,6 @@ static void quantiles_and_top_values_from_histogram(
 
     std::map<int64_t, int64_t> histogram;
 
-    auto extract_one = [&](const uint8_t *p, GDALDataType dt) -> double {
-        switch (dt) {
-            case GDT_Byte:    return static_cast<double>(*reinterpret_cast<const uint8_t *>(p));
-            case GDT_Int8:    return static_cast<double>(*reinterpret_cast<const int8_t  *>(p));
-            case GDT_UInt16:  return static_cast<double>(*reinterpret_cast<const uint16_t *>(p));
-            case GDT_Int16:   return static_cast<double>(*reinterpret_cast<const int16_t  *>(p));
-            case GDT_UInt32:  return static_cast<double>(*reinterpret_cast<const uint32_t *>(p));
-            case GDT_Int32:   return static_cast<double>(*reinterpret_cast<const int32_t  *>(p));
-            case GDT_UInt64:  return static_cast<double>(*reinterpret_cast<const uint64_t *>(p));
-            case GDT_Int64:   return static_cast<double>(*reinterpret_cast<const int64_t  *>(p));
-            case GDT_Float32: return static_cast<double>(*reinterpret_cast<const float    *>(p));
-            case GDT_Float64: return *reinterpret_cast<const double *>(p);
-            default:          return std::numeric_limits<double>::quiet_NaN();
-        }
-    };
-
     for (int by = 0; by < blocks_y; by++) {
         const int valid_ysize = std::min(block_ysize, raster_height - by * block_ysize);
         for (int bx = 0; bx < blocks_x; bx++) {
@@ -274,65 +409,331 @@ static void quantiles_and_top_values_from_histogram(
                 const uint8_t *row = block_buf.data() +
                     static_cast<size_t>(y) * static_cast<size_t>(block_xsize) * dtype_size;
                 for (int x = 0; x < valid_xsize; x++) {
-                    double v = extract_one(row + static_cast<size_t>(x) * dtype_size, dtype);
+                    double v = read_value(row + static_cast<size_t>(x) * dtype_size, dtype);
                     if (is_invalid(v, nodata, has_nodata)) continue;
-                    histogram[bucket_for(v)]++;
+                    histogram[buckets.bucket_for(v)]++;
                 }
             }
         }
     }
 
-    if (histogram.empty()) return;
+    std::vector<std::pair<int64_t, int64_t>> ordered(histogram.begin(), histogram.end());
+    quantiles_and_top_values_from_buckets(ordered, buckets, quantiles, top_values);
+}
 
-    // Quantiles via CDF walk over the ordered histogram. method="lower"
-    // matches raster-loader's numpy.quantile call.
-    int64_t total = 0;
-    for (auto &kv : histogram) total += kv.second;
-    if (total <= 0) return;
+// ─────────────────────────────────────────────
+// Exact path, parallel: block-row stripes with mergeable accumulators.
+// ─────────────────────────────────────────────
+//
+// All requested bands are read in the same pass: each worker opens its
+// own dataset (GDAL handles are not thread-safe), claims block rows off
+// an atomic counter and folds every block of every band into a
+// per-worker accumulator. Per-block moments are computed two-pass over
+// the in-memory block and merged with Chan's formula, so the result does
+// not depend on how rows were split across workers.
+//
+// Fixed-bucket ints get everything in one pass — the dense histogram is
+// exact and min/max are known by the end. Wider ints and floats need
+// min/max to place bins, so they take a second (also parallel) pass for
+// the histogram.
+struct ExactBandAccumulator {
+    int64_t count = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double mean = 0.0;
+    double m2 = 0.0;
+    std::vector<int64_t> histogram;  // dense; see fixed_bucket_range / HistogramBuckets
+
+    void merge_moments(int64_t n, double block_mean, double block_m2) {
+        if (n == 0) return;
+        if (count == 0) {
+            count = n;
+            mean = block_mean;
+            m2 = block_m2;
+            return;
+        }
+        const int64_t total = count + n;
+        const double delta = block_mean - mean;
+        mean += delta * static_cast<double>(n) / static_cast<double>(total);
+        m2 += block_m2 + delta * delta *
+              (static_cast<double>(count) * static_cast<double>(n) / static_cast<double>(total));
+        count = total;
+    }
 
-    for (int N = kOverviewMin; N <= kOverviewMax; N++) {
-        std::vector<double> qs;
-        qs.reserve(N - 1);
-        // Targets are floor(total*j/N) for j in 1..N-1 — same formula as
-        // the sample path's index calculation.
-        std::vector<int64_t> targets;
-        targets.reserve(N - 1);
-        for (int j = 1; j < N; j++) {
-            targets.push_back((total * j) / N);
+    void merge(const ExactBandAccumulator &o) {
+        merge_moments(o.count, o.mean, o.m2);
+        min = std::min(min, o.min);
+        max = std::max(max, o.max);
+        if (histogram.size() < o.histogram.size()) {
+            histogram.resize(o.histogram.size(), 0);
         }
-        // Walk the CDF; for each target index, take the value of the
-        // bucket where the running count first crosses the target.
-        size_t target_idx = 0;
-        int64_t running = 0;
-        for (auto &kv : histogram) {
-            running += kv.second;
-            while (target_idx < targets.size() && running > targets[target_idx]) {
-                qs.push_back(value_for(kv.first));
-                target_idx++;
+        for (size_t i = 0; i < o.histogram.size(); i++) {
+            histogram[i] += o.histogram[i];
+        }
+    }
+};
+
+// Runs visit(worker_index, dataset, block_row) for every block row, spread
+// over `threads` workers started through run_workers. Worker datasets come
+// from open_dataset and are closed here. The first worker exception is
+// rethrown on the caller.
+template <class VISIT>
+static void for_each_block_row(const std::function<GDALDatasetH()> &open_dataset,
+                               int threads, const ParallelRunner &run_workers,
+                               int blocks_y, VISIT &&visit) {
+    std::atomic<int> next_row{0};
+    std::exception_ptr failure;
+    std::mutex failure_lock;
+
+    auto worker = [&](int w) {
+        GDALDatasetH ds = nullptr;
+        try {
+            ds = open_dataset();
+            if (!ds) {
+                throw std::runtime_error("band stats: worker failed to open raster");
             }
-            if (target_idx >= targets.size()) break;
+            for (int by = next_row.fetch_add(1); by < blocks_y; by = next_row.fetch_add(1)) {
+                visit(w, ds, by);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> guard(failure_lock);
+            if (!failure) failure = std::current_exception();
+            next_row.store(blocks_y);  // stop the other workers early
         }
-        // Pad in case of edge cases at the boundary.
-        while (qs.size() < static_cast<size_t>(N - 1)) {
-            qs.push_back(value_for(histogram.rbegin()->first));
+        if (ds) GDALClose(ds);
+    };
+
+    run_workers(threads, worker);
+    if (failure) std::rethrow_exception(failure);
+}
+
+// GDALComputeRasterStatistics honours the band's mask; do the same when the
+// mask says more than nodata (alpha band, per-dataset or external mask).
+static bool band_uses_mask(GDALRasterBandH band) {
+    const int flags = GDALGetMaskFlags(band);
+    return !(flags & GMF_ALL_VALID) && !(flags & GMF_NODATA);
+}
+
+// Reads block (bx, by) of `band`, plus its mask window into `mask` (one byte
+// per valid pixel, row stride valid_xsize) when use_mask is set.
+static void read_stats_block(GDALRasterBandH band, int band_index, int bx, int by,
+                             int block_xsize, int block_ysize, int valid_xsize, int valid_ysize,
+                             bool use_mask, std::vector<uint8_t> &block_buf, std::vector<uint8_t> &mask) {
+    if (GDALReadBlock(band, bx, by, block_buf.data()) != CE_None) {
+        throw std::runtime_error("band stats: failed to read block (" + std::to_string(bx) + ", " +
+                                 std::to_string(by) + ") of band " + std::to_string(band_index));
+    }
+    if (!use_mask) {
+        return;
+    }
+    mask.resize(static_cast<size_t>(valid_xsize) * static_cast<size_t>(valid_ysize));
+    if (GDALRasterIO(GDALGetMaskBand(band), GF_Read, bx * block_xsize, by * block_ysize,
+                     valid_xsize, valid_ysize, mask.data(), valid_xsize, valid_ysize,
+                     GDT_Byte, 0, 0) != CE_None) {
+        throw std::runtime_error("band stats: failed to read mask block (" + std::to_string(bx) + ", " +
+                                 std::to_string(by) + ") of band " + std::to_string(band_index));
+    }
+}
+
+std::vector<BandStatsResult> compute_band_stats_exact_parallel(
+    const std::function<GDALDatasetH()> &open_dataset,
+    const std::vector<int> &band_indices,
+    int raster_width, int raster_height,
+    const std::vector<double> &nodatas, const std::vector<bool> &has_nodatas,
+    GDALDataType dtype,
+    int threads,
+    const ParallelRunner &run_workers) {
+
+    const size_t n_bands = band_indices.size();
+    std::vector<BandStatsResult> results(n_bands);
+    for (auto &r : results) r.version = kVersionTag;
+    if (n_bands == 0 || raster_width <= 0 || raster_height <= 0) {
+        return results;
+    }
+
+    // Block geometry from the first band; stripes are whole block rows so
+    // every GDALReadBlock maps to exactly one source block.
+    int block_xsize = 0, block_ysize = 0;
+    std::vector<bool> use_mask(n_bands, false);
+    {
+        GDALDatasetH ds = open_dataset();
+        if (!ds) {
+            throw std::runtime_error("band stats: failed to open raster");
         }
-        quantiles[N] = std::move(qs);
+        GDALGetBlockSize(GDALGetRasterBand(ds, band_indices[0]), &block_xsize, &block_ysize);
+        bool uniform = true;
+        for (int idx : band_indices) {
+            int bxs = 0, bys = 0;
+            GDALGetBlockSize(GDALGetRasterBand(ds, idx), &bxs, &bys);
+            uniform = uniform && bxs == block_xsize && bys == block_ysize;
+        }
+        if (!uniform) {
+            // Mixed block layouts can't share one stripe grid; fall back to
+            // the serial per-band path.
+            for (size_t b = 0; b < n_bands; b++) {
+                results[b] = compute_band_stats(GDALGetRasterBand(ds, band_indices[b]),
+                                                raster_width, raster_height,
+                                                nodatas[b], has_nodatas[b], dtype, false);
+            }
+            GDALClose(ds);
+            return results;
+        }
+        for (size_t b = 0; b < n_bands; b++) {
+            use_mask[b] = band_uses_mask(GDALGetRasterBand(ds, band_indices[b]));
+        }
+        GDALClose(ds);
     }
+    if (block_xsize <= 0) block_xsize = 256;
+    if (block_ysize <= 0) block_ysize = 256;
+    const int blocks_x = (raster_width  + block_xsize - 1) / block_xsize;
+    const int blocks_y = (raster_height + block_ysize - 1) / block_ysize;
+    threads = std::max(1, std::min(threads, blocks_y));
 
-    // top_values: top-K buckets by frequency.
-    std::vector<std::pair<int64_t, int64_t>> ranked(histogram.begin(), histogram.end());
-    std::sort(ranked.begin(), ranked.end(),
-              [](const std::pair<int64_t, int64_t> &a,
-                 const std::pair<int64_t, int64_t> &b) {
-                  if (a.second != b.second) return a.second > b.second;
-                  return a.first < b.first;
-              });
-    const int K = std::min<int>(kMaxMostCommon, static_cast<int>(ranked.size()));
-    for (int i = 0; i < K; i++) {
-        if (ranked[i].second > 0) {
-            top_values[value_for(ranked[i].first)] = ranked[i].second;
+    const int dtype_size = GDALGetDataTypeSizeBytes(dtype);
+    const size_t block_bytes = static_cast<size_t>(block_xsize) *
+                               static_cast<size_t>(block_ysize) *
+                               static_cast<size_t>(dtype_size);
+    const bool fixed_int = is_fixed_bucket_int(dtype);
+    int64_t fixed_offset = 0;
+    size_t fixed_size = 0;
+    fixed_bucket_range(dtype, fixed_offset, fixed_size);
+
+    // acc[worker][band]
+    std::vector<std::vector<ExactBandAccumulator>> acc(
+        threads, std::vector<ExactBandAccumulator>(n_bands));
+    if (fixed_int) {
+        for (auto &per_worker : acc) {
+            for (auto &a : per_worker) a.histogram.assign(fixed_size, 0);
+        }
+    }
+
+    // Pass 1: moments, min/max and (fixed-bucket ints) the dense histogram.
+    for_each_block_row(open_dataset, threads, run_workers, blocks_y, [&](int w, GDALDatasetH ds, int by) {
+        std::vector<uint8_t> block_buf(block_bytes);
+        std::vector<uint8_t> mask;
+        std::vector<double> valid;
+        valid.reserve(static_cast<size_t>(block_xsize) * block_ysize);
+        const int valid_ysize = std::min(block_ysize, raster_height - by * block_ysize);
+        for (size_t b = 0; b < n_bands; b++) {
+            GDALRasterBandH band = GDALGetRasterBand(ds, band_indices[b]);
+            auto &a = acc[w][b];
+            for (int bx = 0; bx < blocks_x; bx++) {
+                const int valid_xsize = std::min(block_xsize, raster_width - bx * block_xsize);
+                read_stats_block(band, band_indices[b], bx, by, block_xsize, block_ysize,
+                                 valid_xsize, valid_ysize, use_mask[b], block_buf, mask);
+                valid.clear();
+                for (int y = 0; y < valid_ysize; y++) {
+                    const uint8_t *row = block_buf.data() +
+                        static_cast<size_t>(y) * static_cast<size_t>(block_xsize) * dtype_size;
+                    for (int x = 0; x < valid_xsize; x++) {
+                        if (use_mask[b] && mask[static_cast<size_t>(y) * valid_xsize + x] == 0) continue;
+                        double v = read_value(row + static_cast<size_t>(x) * dtype_size, dtype);
+                        if (is_invalid(v, nodatas[b], has_nodatas[b])) continue;
+                        valid.push_back(v);
+                    }
+                }
+                if (valid.empty()) continue;
+                double sum = 0.0;
+                for (double v : valid) {
+                    sum += v;
+                    if (v < a.min) a.min = v;
+                    if (v > a.max) a.max = v;
+                }
+                const double block_mean = sum / static_cast<double>(valid.size());
+                double block_m2 = 0.0;
+                for (double v : valid) {
+                    const double d = v - block_mean;
+                    block_m2 += d * d;
+                }
+                a.merge_moments(static_cast<int64_t>(valid.size()), block_mean, block_m2);
+                if (fixed_int) {
+                    for (double v : valid) {
+                        a.histogram[static_cast<size_t>(static_cast<int64_t>(v) - fixed_offset)]++;
+                    }
+                }
+            }
+        }
+    });
+
+    std::vector<ExactBandAccumulator> total(n_bands);
+    for (int w = 0; w < threads; w++) {
+        for (size_t b = 0; b < n_bands; b++) total[b].merge(acc[w][b]);
+    }
+
+    // Pass 2 (wide ints / floats): dense n_bins histogram now that min/max
+    // are known.
+    if (!fixed_int) {
+        std::vector<HistogramBuckets> bucketers;
+        for (size_t b = 0; b < n_bands; b++) {
+            bucketers.emplace_back(dtype, total[b].min, total[b].max);
+        }
+        std::vector<std::vector<std::vector<int64_t>>> hist(
+            threads, std::vector<std::vector<int64_t>>(n_bands));
+        for (auto &per_worker : hist) {
+            for (size_t b = 0; b < n_bands; b++) per_worker[b].assign(bucketers[b].n_bins, 0);
+        }
+        for_each_block_row(open_dataset, threads, run_workers, blocks_y, [&](int w, GDALDatasetH ds, int by) {
+            std::vector<uint8_t> block_buf(block_bytes);
+            std::vector<uint8_t> mask;
+            const int valid_ysize = std::min(block_ysize, raster_height - by * block_ysize);
+            for (size_t b = 0; b < n_bands; b++) {
+                if (total[b].count == 0) continue;
+                GDALRasterBandH band = GDALGetRasterBand(ds, band_indices[b]);
+                auto &h = hist[w][b];
+                for (int bx = 0; bx < blocks_x; bx++) {
+                    const int valid_xsize = std::min(block_xsize, raster_width - bx * block_xsize);
+                    read_stats_block(band, band_indices[b], bx, by, block_xsize, block_ysize,
+                                     valid_xsize, valid_ysize, use_mask[b], block_buf, mask);
+                    for (int y = 0; y < valid_ysize; y++) {
+                        const uint8_t *row = block_buf.data() +
+                            static_cast<size_t>(y) * static_cast<size_t>(block_xsize) * dtype_size;
+                        for (int x = 0; x < valid_xsize; x++) {
+                            if (use_mask[b] && mask[static_cast<size_t>(y) * valid_xsize + x] == 0) continue;
+                            double v = read_value(row + static_cast<size_t>(x) * dtype_size, dtype);
+                            if (is_invalid(v, nodatas[b], has_nodatas[b])) continue;
+                            h[static_cast<size_t>(bucketers[b].bucket_for(v))]++;
+                        }
+                    }
+                }
+            }
+        });
+        for (size_t b = 0; b < n_bands; b++) {
+            total[b].histogram.assign(bucketers[b].n_bins, 0);
+            for (int w = 0; w < threads; w++) {
+                for (size_t i = 0; i < hist[w][b].size(); i++) total[b].histogram[i] += hist[w][b][i];
+            }
+        }
+    }
+
+    const int64_t pixels = static_cast<int64_t>(raster_width) * static_cast<int64_t>(raster_height);
+    for (size_t b = 0; b < n_bands; b++) {
+        auto &t = total[b];
+        auto &r = results[b];
+        r.approximated = false;
+        if (t.count == 0) {
+            continue;  // all-nodata: has_stats=false, like the GDAL path
+        }
+        const double variance = t.m2 / static_cast<double>(t.count);  // population, as GDAL
+        r.count         = t.count;
+        r.min           = t.min;
+        r.max           = t.max;
+        r.mean          = t.mean;
+        r.stddev        = std::sqrt(variance);
+        r.sum           = t.mean * static_cast<double>(t.count);
+        r.sum_squares   = static_cast<double>(t.count) * (variance + t.mean * t.mean);
+        r.valid_percent = 100.0 * static_cast<double>(t.count) / static_cast<double>(pixels);
+        r.has_stats     = true;
+
+        const HistogramBuckets buckets(dtype, t.min, t.max);
+        std::vector<std::pair<int64_t, int64_t>> ordered;
+        for (size_t i = 0; i < t.histogram.size(); i++) {
+            if (t.histogram[i] == 0) continue;
+            int64_t key = fixed_int ? static_cast<int64_t>(i) + fixed_offset : static_cast<int64_t>(i);
+            ordered.emplace_back(key, t.histogram[i]);
         }
+        quantiles_and_top_values_from_buckets(ordered, buckets, r.quantiles, r.top_values);
     }
+    return results;
 }
 
 // ─────────────────────────────────────────────
@@ -1,14 +1,20 @@
 #ifdef RAQUET_HAS_GDAL
 
+#include "proj_embed.hpp"
+#include "raquet_metrics.hpp"
+
 #include <proj.h>
 #include <sqlite3.h>
+#include <zlib.h>
 #include <mutex>
 #include <stdexcept>
 #include <cstdio>
+#include <vector>
 
-// Embedded proj.db data (generated at build time by xxd)
+// Embedded proj.db, zlib-compressed at build time (scripts/bin2c.py --deflate)
 extern "C" unsigned char proj_db[];
 extern "C" unsigned int proj_db_len;
+extern "C" unsigned int proj_db_raw_len;
 
 // memvfs SQLite extension
 extern "C" int sqlite3_memvfs_init(sqlite3 *, char **, const sqlite3_api_routines *);
@@ -19,6 +25,16 @@ namespace raquet {
 void InitEmbeddedProj() {
     static std::once_flag flag;
     std::call_once(flag, []() {
+        ScopedMetricTimer timer(Metric::INIT_NS);
+
+        // Inflate on first use rather than at LOAD. Leaked on purpose: memvfs
+        // serves pages straight from this buffer for the life of the process.
+        auto *db_bytes = new std::vector<unsigned char>(proj_db_raw_len);
+        uLongf inflated = proj_db_raw_len;
+        if (uncompress(db_bytes->data(), &inflated, proj_db, proj_db_len) != Z_OK || inflated != proj_db_raw_len) {
+            throw std::runtime_error("Could not inflate embedded proj.db");
+        }
+
         // Initialize SQLite and register the memvfs VFS
         sqlite3_initialize();
         sqlite3_memvfs_init(nullptr, nullptr, nullptr);
@@ -33,7 +49,7 @@ void InitEmbeddedProj() {
         char path[256];
         snprintf(path, sizeof(path),
                  "file:/proj.db?immutable=1&ptr=%llu&sz=%u&max=%u",
-                 reinterpret_cast<unsigned long long>(proj_db), proj_db_len, proj_db_len);
+                 reinterpret_cast<unsigned long long>(db_bytes->data()), proj_db_raw_len, proj_db_raw_len);
 
         // Configure the default PROJ context to use memvfs
         proj_context_set_sqlite3_vfs_name(nullptr, "memvfs");
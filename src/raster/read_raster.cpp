@@ -7,11 +7,18 @@
 #include "raquet_metadata.hpp"
 #include "quadbin.hpp"
 #include "proj_embed.hpp"
+#include "raquet_metrics.hpp"
 
 #include "duckdb/common/exception.hpp"
+#include "duckdb/common/insertion_order_preserving_map.hpp"
 #include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/hash.hpp"
 #include "duckdb/function/table_function.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/parallel/task_executor.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/storage/buffer/block_handle.hpp"
+#include "duckdb/storage/buffer_manager.hpp"
 #include "duckdb/storage/statistics/node_statistics.hpp"
 
 #include <gdal.h>
@@ -30,12 +37,14 @@
 #include <condition_variable>
 #include <cstdlib>
 #include <cstring>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <set>
 #include <sstream>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace duckdb {
@@ -55,7 +64,7 @@ static bool DebugTimingEnabled() {
 }
 
 // ─────────────────────────────────────────────
-// Register GDAL drivers exactly once, process-wide.
+// Register GDAL drivers exactly once, process-wide, on first use.
 //
 // GDALAllRegister() mutates the global GDALDriverManager (it appends to the
 // driver array and runs AutoLoadDrivers/AutoLoadPythonDrivers) and is NOT
@@ -64,10 +73,19 @@ static bool DebugTimingEnabled() {
 // workers and corrupts the heap (observed as SIGTRAP in malloc). std::call_once
 // guarantees a single registration regardless of which phase/thread arrives
 // first (Bind, or the first Execute worker).
+//
+// Every driver is registered in that one call, not just the ones a file
+// needs to open: a VRT's sources (JPEG, PNG, JP2, NetCDF, ...) are only
+// opened when it is read or warped, and registering more drivers later
+// would race with queries already using GDAL. Registration still waits for
+// the first read_raster() call, so LOAD raquet does no GDAL work.
 // ─────────────────────────────────────────────
 static void EnsureGDALRegistered() {
     static std::once_flag gdal_register_once;
-    std::call_once(gdal_register_once, []() { GDALAllRegister(); });
+    std::call_once(gdal_register_once, []() {
+        raquet::ScopedMetricTimer timer(raquet::Metric::INIT_NS);
+        GDALAllRegister();
+    });
 }
 
 // ─────────────────────────────────────────────
@@ -178,8 +196,19 @@ struct ReadRasterBindData : public TableFunctionData {
     int block_zoom = 8;    // log2(block_size)
 
     // User parameters
-    std::string compression = "gzip";
+    std::string compression = "gzip";  // or "auto": codec chosen per tile (see raquet::choose_tile_codec)
+    std::string auto_objective = "balanced";  // compression='auto' target: size, balanced or speed
     int compression_quality = 85;
+    int predictor = 1;  // 2 = horizontal differencing, 3 = floating point (before gzip/zstd/lz4)
+    double max_error = 0.0;  // > 0: quantize float bands to integer codes within this bound
+    std::vector<raquet::BandInfo::Quantization> band_quant;  // per output band, planned at bind
+    int dictionary_size = 0;  // > 0: train a preset deflate dictionary of up to this many bytes per band
+    bool constant_tiles = false;  // uniform band planes become a marker + one value (sequential layout)
+    bool dedup = false;  // repeated band blobs become references into a per-band tile_dictionary
+    int nbits = 0;        // requested pixel width for byte bands: 0 = source NBITS, 1/2/4 = pack, 8 = bytes
+    int packed_bits = 0;  // resolved at bind: > 0 stores bands bit-packed as uint1/uint2/uint4
+    bool validity_mask = false;  // tiles mixing valid and nodata pixels carry a validity bitmask
+    std::vector<std::shared_ptr<const std::vector<uint8_t>>> band_dictionaries;  // per output band, may be null
     GDALResampleAlg resampling = GRA_NearestNeighbour;
     std::string band_layout = "sequential";
     std::string overviews = "auto";
@@ -231,15 +260,50 @@ struct ReadRasterBindData : public TableFunctionData {
 struct TileData {
     std::vector<std::vector<uint8_t>> compressed;  // compressed band buffers
     std::vector<raquet::BandStats> stats;           // per-band statistics (empty if not requested)
+    uint64_t io_ns = 0;                             // GDALRasterIO time (read_raster_profile)
+    uint64_t compress_ns = 0;                       // interleave + encode time
 };
 
 // One overview tile fully prepared for emission. Phase 2 stages these into a
-// shared queue (single-producer, multi-consumer) instead of writing directly
-// to the output DataChunk, so emission can span multiple Execute calls
-// without losing tiles past STANDARD_VECTOR_SIZE.
+// shared queue instead of writing directly to the output DataChunk, so
+// emission can span multiple Execute calls without losing tiles past
+// STANDARD_VECTOR_SIZE.
+//
+// The band blobs are concatenated into a pooled buffer-managed block (see
+// OverviewStaging); the entry itself only records where they live.
 struct OverviewResult {
     uint64_t block;
-    TileData tile_data;
+    idx_t staging_block;                       // index into OverviewStaging::blocks
+    idx_t offset;                              // byte offset of the first blob
+    std::vector<idx_t> blob_sizes;             // per-blob byte length, in order
+    std::vector<raquet::BandStats> stats;
+};
+
+// Staged overview payloads are appended into shared blocks of this size (a
+// larger tile gets a block of its own), so a pyramid of small tiles costs a
+// handful of spillable allocations rather than one per tile.
+static constexpr idx_t OVERVIEW_STAGING_BLOCK_SIZE = idx_t(4) << 20;
+
+struct OverviewStagingBlock {
+    shared_ptr<BlockHandle> handle;
+    idx_t size = 0;
+    idx_t used = 0;
+    idx_t live = 0;                            // staged tiles not yet drained
+};
+
+// Phase 2 staging pool and queue, guarded by one mutex. Only the block being
+// filled stays pinned; closed blocks are unpinned so the buffer manager can
+// spill them under memory pressure, and each block is freed as soon as its
+// last tile has been drained. `staged_bytes` counts payload awaiting drain
+// and drives producer pushback (see OverviewStagingSaturated).
+struct OverviewStaging {
+    std::mutex mutex;
+    std::vector<OverviewStagingBlock> blocks;
+    BufferHandle open_pin;                     // pin on blocks.back() while open
+    bool has_open = false;
+    std::deque<OverviewResult> queue;
+    idx_t staged_bytes = 0;
+    idx_t budget = 0;                          // staged_bytes ceiling before pushback
 };
 
 // ─────────────────────────────────────────────
@@ -249,6 +313,63 @@ struct OverviewFrame {
     RasterTile tile;
 };
 
+// ─────────────────────────────────────────────
+// Per-thread scan profile, reported by read_raster_profile(). Each worker
+// owns one slot: InitLocal allocates it inside the global state (so it
+// outlives the local state) and only the owning thread writes to it. The
+// global state publishes all slots when the scan is torn down.
+// ─────────────────────────────────────────────
+struct ReadRasterThreadProfile {
+    std::atomic<uint64_t> tiles_emitted{0};
+    std::atomic<uint64_t> tiles_skipped_outside{0};  // geometric pre-check
+    std::atomic<uint64_t> tiles_skipped_probe{0};    // sparsity IO probe
+    std::atomic<uint64_t> tiles_skipped_empty{0};    // post-warp IsTileEmpty
+    std::atomic<uint64_t> probe_ns{0};
+    std::atomic<uint64_t> warp_ns{0};
+    std::atomic<uint64_t> io_ns{0};
+    std::atomic<uint64_t> compress_ns{0};
+};
+
+static void ProfileAdd(std::atomic<uint64_t> &slot, uint64_t delta) {
+    slot.fetch_add(delta, std::memory_order_relaxed);
+}
+
+static uint64_t ElapsedNs(std::chrono::steady_clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+struct ReadRasterGlobalState;
+
+// ─────────────────────────────────────────────
+// Content-hash deduplication (dedup := true)
+//
+// Every band blob of at least DEDUP_MIN_BLOB bytes is hashed. The first
+// tile to produce some content keeps its blob; the second copies it into
+// the band's tile_dictionary, and from then on every tile with the same
+// bytes stores an 8-byte TILE_REF_MAGIC reference to that slot. Only the
+// hash of a blob seen once is kept, and a slot is only reused after a
+// byte-for-byte compare, so a hash collision costs a missed dedup, never a
+// wrong tile. The dictionary goes base64 into the metadata string, which
+// every row of read_raquet() carries and scalar functions compare against
+// their cached parse, so it is capped at DEDUP_MAX_DICTIONARY bytes.
+// ─────────────────────────────────────────────
+static constexpr size_t DEDUP_MIN_BLOB = 32;
+static constexpr size_t DEDUP_MAX_DICTIONARY = 16 * 1024;
+
+struct TileDedup {
+    struct Entry {
+        int band;
+        int64_t slot;  // -1 until a second tile produced this hash
+    };
+
+    std::mutex lock;
+    std::unordered_map<hash_t, Entry> seen;
+    std::vector<std::vector<std::vector<uint8_t>>> band_blobs;  // per output band
+    size_t dictionary_bytes = 0;
+};
+static void PublishReadRasterProfile(const ReadRasterGlobalState &state);
+
 // ─────────────────────────────────────────────
 // Execution state machine — three phases, transitions enforced via the
 // atomic flags below.
@@ -266,15 +387,18 @@ struct OverviewFrame {
 //     publishes the overview frame queue. All workers then pull from
 //     `overview_frames` via `next_overview_idx`. Each tile uses the
 //     COG fast path when source overviews exist, falling back to base
-//     warp otherwise. Results are pushed into the `overview_results`
-//     staging vector under a brief mutex; the staging is by design —
-//     it lets emission span multiple Execute() calls so we don't
-//     silently lose overview tiles past STANDARD_VECTOR_SIZE.
-//     Last Phase 2 finisher publishes `phase2_staged`.
+//     warp otherwise. Results are staged into `overview_staging`; the
+//     staging is by design — it lets emission span multiple Execute()
+//     calls so we don't silently lose overview tiles past
+//     STANDARD_VECTOR_SIZE. A worker that finds the staging pool over
+//     budget drains it into its output chunk and returns instead of
+//     pulling more frames, so the pipeline consumes rows before the
+//     memory limit is reached. Last Phase 2 finisher publishes
+//     `phase2_staged`.
 //
 //   Phase 3 — Drain + metadata (cooperative)
-//     Any worker can drain `overview_results` into output DataChunks
-//     via `overview_drain_idx`. Once drained, exactly one thread
+//     Any worker can drain `overview_staging` into output DataChunks.
+//     Once drained, exactly one thread
 //     (elected via `metadata_emitted` CAS) builds and emits the
 //     `block=0` metadata row. After that, `finished` is set and all
 //     subsequent Execute() calls return zero rows.
@@ -294,9 +418,9 @@ struct ReadRasterGlobalState : public GlobalTableFunctionState {
 
     // Phase 2 work queue: every thread pulls overview frames from this list
     // via next_overview_idx and warps them with its own per-thread GDAL handle
-    // (local.src_ds), then pushes the result into overview_results under a
-    // mutex. The last thread to finish publishes phase2_staged; afterwards
-    // any thread can drain overview_results lock-free.
+    // (local.src_ds), then stages the result into overview_staging. The last
+    // thread to finish publishes phase2_staged; the queue may be drained
+    // before that when producers hit the staging budget.
     std::vector<OverviewFrame> overview_frames;
     std::atomic<idx_t> next_overview_idx{0};            // work pull pointer
     std::atomic<idx_t> overview_frames_processed{0};    // completion counter
@@ -307,18 +431,25 @@ struct ReadRasterGlobalState : public GlobalTableFunctionState {
     std::atomic<bool> phase2_init_claimed{false};
     std::atomic<bool> phase2_init_done{false};
 
-    // Phase 2 staged results — filled in parallel by every Phase 2 worker
-    // (push_back guarded by overview_results_mutex), drained lock-free via
-    // overview_drain_idx after phase2_staged is set. Staging into a queue
-    // instead of writing directly into the output DataChunk is what avoids
-    // the silent row-cap drop that capped Phase 2 emission at
-    // STANDARD_VECTOR_SIZE rows (for Germany at default zoom: ~11k overview
-    // tiles were silently lost).
-    std::vector<OverviewResult> overview_results;
-    std::mutex overview_results_mutex;
-    std::atomic<idx_t> overview_drain_idx{0};
+    // Phase 2 staged results — filled in parallel by every Phase 2 worker and
+    // drained by any thread. Staging into a queue instead of writing directly
+    // into the output DataChunk is what avoids the silent row-cap drop that
+    // capped Phase 2 emission at STANDARD_VECTOR_SIZE rows (for Germany at
+    // default zoom: ~11k overview tiles were silently lost). Payloads live
+    // in pooled buffer-managed blocks, so the queue counts against
+    // memory_limit and spills to temp_directory rather than growing the heap;
+    // producers that find the pool saturated drain it into their own output
+    // chunk instead of warping more tiles.
+    OverviewStaging overview_staging;
     std::atomic<bool> phase2_staged{false};
 
+    // Buffer manager for spillable Phase 2 staging (see OverviewResult)
+    BufferManager *buffer_manager = nullptr;
+
+    // dedup := true (see DeduplicateTile); written by every phase, read by
+    // the Phase 3 metadata row.
+    TileDedup dedup;
+
     // Shared config
     GDALResampleAlg source_resampling = GRA_NearestNeighbour;
     double nodata_value = 0;
@@ -356,10 +487,21 @@ struct ReadRasterGlobalState : public GlobalTableFunctionState {
     std::atomic<int64_t> phase2_staged_ns{-1};
     std::atomic<int64_t> phase3_done_ns{-1};
 
+    // raquet_metrics() totals at init; EXPLAIN ANALYZE reports the delta.
+    std::vector<uint64_t> metrics_at_init;
+
+    // read_raster_profile() slots, one per worker (see ReadRasterThreadProfile)
+    std::mutex profile_mutex;
+    std::vector<unique_ptr<ReadRasterThreadProfile>> thread_profiles;
+    int profile_block_size = 0;
+
     idx_t MaxThreads() const override {
         return GlobalTableFunctionState::MAX_THREADS;
     }
 
+    ~ReadRasterGlobalState() override {
+        PublishReadRasterProfile(*this);
+    }
 };
 
 // ─────────────────────────────────────────────
@@ -389,6 +531,15 @@ struct ReadRasterLocalState : public LocalTableFunctionState {
     // Base resolution (level -1) uses src_ds, not this cache.
     std::vector<GDALDatasetH> overview_src_ds;
 
+    // This thread's read_raster_profile() slot; owned by the global state.
+    ReadRasterThreadProfile *profile = nullptr;
+
+    // Per-thread raw band buffer (selected bands × block_size² × dtype size),
+    // allocated once from DuckDB's buffer manager so the ingestion working
+    // set is visible to memory_limit. Pinned for the thread's lifetime.
+    BufferHandle band_scratch;
+    idx_t band_scratch_size = 0;
+
     ~ReadRasterLocalState() {
         if (warp_transformer) GDALDestroyGenImgProjTransformer(warp_transformer);
         if (web_mercator_wkt) CPLFree(web_mercator_wkt);
@@ -399,6 +550,92 @@ struct ReadRasterLocalState : public LocalTableFunctionState {
     }
 };
 
+// ─────────────────────────────────────────────
+// Last published scan profile (read_raster_profile()). Process-wide: the
+// most recently torn-down read_raster scan wins, whichever connection ran it.
+// ─────────────────────────────────────────────
+struct ReadRasterProfileRow {
+    std::string scope;   // "scan" or "thread_<n>"
+    std::string metric;
+    double value;
+    std::string unit;
+};
+
+static std::mutex &LastProfileMutex() {
+    static std::mutex m;
+    return m;
+}
+
+static std::vector<ReadRasterProfileRow> &LastProfile() {
+    static std::vector<ReadRasterProfileRow> rows;
+    return rows;
+}
+
+static void PublishReadRasterProfile(const ReadRasterGlobalState &state) {
+    auto phase_ns = [](const std::atomic<int64_t> &a) { return a.load(std::memory_order_acquire); };
+    int64_t p1_first = phase_ns(state.phase1_first_ns);
+    int64_t p1_done = phase_ns(state.phase1_done_ns);
+    int64_t p2_init = phase_ns(state.phase2_init_ns);
+    int64_t p2_staged = phase_ns(state.phase2_staged_ns);
+    int64_t p3_done = phase_ns(state.phase3_done_ns);
+    int64_t end_ns = p3_done >= 0 ? p3_done
+                                  : static_cast<int64_t>(ElapsedNs(state.init_start));
+
+    std::vector<ReadRasterProfileRow> rows;
+    rows.push_back({"scan", "total_wall", end_ns / 1e6, "ms"});
+    if (p1_first >= 0 && p1_done >= 0) {
+        rows.push_back({"scan", "phase1_wall", (p1_done - p1_first) / 1e6, "ms"});
+    }
+    if (p2_init >= 0 && p2_staged >= 0) {
+        rows.push_back({"scan", "phase2_wall", (p2_staged - p2_init) / 1e6, "ms"});
+    }
+    if (p2_staged >= 0 && p3_done >= 0) {
+        rows.push_back({"scan", "phase3_wall", (p3_done - p2_staged) / 1e6, "ms"});
+    }
+    rows.push_back({"scan", "completed", state.metadata_emitted.load() ? 1.0 : 0.0, "bool"});
+    rows.push_back({"scan", "block_size", static_cast<double>(state.profile_block_size), "px"});
+    rows.push_back({"scan", "threads", static_cast<double>(state.thread_profiles.size()), "count"});
+    rows.push_back({"scan", "native_tiles", static_cast<double>(state.native_tiles.size()), "count"});
+    rows.push_back({"scan", "overview_frames", static_cast<double>(state.overview_frames.size()), "count"});
+
+    struct Counter {
+        const char *name;
+        const char *unit;
+        std::atomic<uint64_t> ReadRasterThreadProfile::*field;
+        double scale;
+    };
+    static const Counter counters[] = {
+        {"tiles_emitted",         "count", &ReadRasterThreadProfile::tiles_emitted,         1.0},
+        {"tiles_skipped_outside", "count", &ReadRasterThreadProfile::tiles_skipped_outside, 1.0},
+        {"tiles_skipped_probe",   "count", &ReadRasterThreadProfile::tiles_skipped_probe,   1.0},
+        {"tiles_skipped_empty",   "count", &ReadRasterThreadProfile::tiles_skipped_empty,   1.0},
+        {"probe_time",            "ms",    &ReadRasterThreadProfile::probe_ns,              1e-6},
+        {"warp_time",             "ms",    &ReadRasterThreadProfile::warp_ns,               1e-6},
+        {"io_time",               "ms",    &ReadRasterThreadProfile::io_ns,                 1e-6},
+        {"compress_time",         "ms",    &ReadRasterThreadProfile::compress_ns,           1e-6},
+    };
+
+    // Scan-level rows sum every thread (so *_time is CPU time, not wall);
+    // per-thread rows follow so load imbalance is visible.
+    for (auto &c : counters) {
+        uint64_t total = 0;
+        for (auto &tp : state.thread_profiles) {
+            total += ((*tp).*(c.field)).load(std::memory_order_relaxed);
+        }
+        rows.push_back({"scan", c.name, total * c.scale, c.unit});
+    }
+    for (size_t t = 0; t < state.thread_profiles.size(); t++) {
+        auto &tp = *state.thread_profiles[t];
+        std::string scope = "thread_" + std::to_string(t);
+        for (auto &c : counters) {
+            rows.push_back({scope, c.name, (tp.*(c.field)).load(std::memory_order_relaxed) * c.scale, c.unit});
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(LastProfileMutex());
+    LastProfile() = std::move(rows);
+}
+
 // ─────────────────────────────────────────────
 // Helper: Enumerate tiles at a given zoom that intersect bounds
 // ─────────────────────────────────────────────
@@ -534,6 +771,7 @@ static void WarpIntoTile(ReadRasterLocalState &local, GDALDatasetH src_ds,
                           GDALResampleAlg resample, double nodata, bool has_nodata,
                           const std::vector<int> &selected_bands,
                           int overview_level = -1) {
+    raquet::ScopedMetricTimer warp_timer(raquet::Metric::WARP_NS);
     EnsureWarpTransformer(local, src_ds, tile_ds, overview_level);
 
     GDALWarpOptions *wo = GDALCreateWarpOptions();
@@ -814,9 +1052,14 @@ static bool IsTileEmpty(GDALDatasetH ds,
 // Optionally computes per-band statistics from raw data before compression
 // ─────────────────────────────────────────────
 static TileData ReadAndCompressBands(
-    GDALDatasetH ds, const std::string &compression, int quality,
-    const std::string &band_layout, bool compute_stats,
-    const std::string &dtype_str, bool has_nodata, double nodata_val) {
+    GDALDatasetH ds, data_ptr_t scratch, idx_t scratch_size,
+    const std::string &compression, const std::string &auto_objective, int quality, int predictor,
+    const std::string &band_layout, bool constant_tiles, bool compute_stats,
+    const std::string &dtype_str, bool has_nodata, double nodata_val,
+    const std::vector<raquet::BandInfo::Quantization> &band_quant,
+    const std::vector<double> &band_nodatas, const std::vector<bool> &band_has_nodata,
+    const std::vector<std::shared_ptr<const std::vector<uint8_t>>> &band_dictionaries, int packed_bits,
+    bool validity_mask) {
 
     TileData result;
     int width = GDALGetRasterXSize(ds);
@@ -826,58 +1069,182 @@ static TileData ReadAndCompressBands(
     int dt_size = GDALGetDataTypeSizeBytes(dt);
     size_t band_bytes = static_cast<size_t>(width) * height * dt_size;
 
-    // Read all bands as raw bytes
-    std::vector<std::vector<uint8_t>> raw_bands(band_count);
+    if (band_bytes * band_count > scratch_size) {
+        throw InternalException("read_raster: band scratch of %llu bytes too small for %d bands of %llu bytes",
+                                scratch_size, band_count, band_bytes);
+    }
+
+    // Read all bands as raw bytes into the caller's scratch block
+    std::vector<const uint8_t *> raw_bands(band_count);
     for (int b = 0; b < band_count; b++) {
-        raw_bands[b].resize(band_bytes);
+        uint8_t *plane = scratch + static_cast<size_t>(b) * band_bytes;
+        raw_bands[b] = plane;
         GDALRasterBandH band = GDALGetRasterBand(ds, b + 1);
+        auto io_start = std::chrono::steady_clock::now();
         CPLErr err = GDALRasterIO(band, GF_Read, 0, 0, width, height,
-                                   raw_bands[b].data(), width, height, dt, 0, 0);
+                                   plane, width, height, dt, 0, 0);
+        result.io_ns += ElapsedNs(io_start);
         if (err != CE_None) {
             throw IOException("Failed to read band %d from tile", b + 1);
         }
 
-        // Compute stats from raw (uncompressed) data if requested
+        // Compute stats from raw (uncompressed) data if requested. Bit-packed
+        // bands are still one byte per pixel here.
         if (compute_stats) {
             auto stats = raquet::compute_band_stats(
-                raw_bands[b].data(), raw_bands[b].size(),
-                dtype_str, width, height,
+                plane, band_bytes,
+                packed_bits > 0 ? "uint8" : dtype_str, width, height,
                 false, // data is already uncompressed
                 has_nodata, nodata_val);
             result.stats.push_back(stats);
         }
     }
 
+    auto compress_start = std::chrono::steady_clock::now();
     if (band_layout == "interleaved") {
         auto interleaved = raquet::interleave_bands(raw_bands, width, height, dt_size);
 
-        if (compression == "gzip") {
-            result.compressed.push_back(raquet::compress_gzip(interleaved.data(), interleaved.size()));
-        } else if (compression == "jpeg") {
+        if (compression == "jpeg") {
             result.compressed.push_back(raquet::encode_jpeg(interleaved.data(), width, height,
                                                              band_count, quality));
         } else if (compression == "webp") {
             result.compressed.push_back(raquet::encode_webp(interleaved.data(), width, height,
                                                              band_count, quality));
+        } else if (compression == "gzip" || compression == "zstd" || compression == "lz4" ||
+                   compression == "auto") {
+            result.compressed.push_back(raquet::compress_band_bytes(interleaved.data(), interleaved.size(),
+                                                                    compression, auto_objective, predictor, dt_size,
+                                                                    GDALDataTypeIsFloating(dt), width, band_count));
         } else {
             result.compressed.push_back(std::move(interleaved));
         }
     } else {
         for (int b = 0; b < band_count; b++) {
-            if (compression == "gzip") {
-                result.compressed.push_back(raquet::compress_gzip(raw_bands[b].data(), raw_bands[b].size()));
-            } else if (compression == "none" || compression.empty()) {
-                result.compressed.push_back(std::move(raw_bands[b]));
+            if (compression == "gzip" || compression == "zstd" || compression == "lz4" ||
+                compression == "auto" || compression == "none" || compression.empty()) {
+                // Stats above were taken from the plane before the predictor runs
+                uint8_t *plane = scratch + static_cast<size_t>(b) * band_bytes;
+                if (constant_tiles) {
+                    auto constant = raquet::encode_constant_tile(plane, band_bytes, dt_size);
+                    if (!constant.empty()) {
+                        result.compressed.push_back(std::move(constant));
+                        continue;
+                    }
+                }
+                // validity_mask: built from the plane as read, before packing or
+                // quantization rewrite it. Bands without nodata never need one.
+                std::vector<uint8_t> mask;
+                if (validity_mask && b < static_cast<int>(band_has_nodata.size()) && band_has_nodata[b]) {
+                    size_t valid_count;
+                    mask = raquet::build_validity_mask(plane, packed_bits > 0 ? "uint8" : dtype_str, width, height,
+                                                       band_nodatas[b], valid_count);
+                    if (valid_count == 0) {
+                        // All nodata but not bitwise uniform (NaN payloads): the
+                        // mask says so and one pixel stands in for the band.
+                        result.compressed.push_back(raquet::wrap_validity_mask(
+                            raquet::compress_band_bytes(mask.data(), mask.size(), compression, auto_objective, 1, 1,
+                                                        false, static_cast<int>(raquet::packed_row_bytes(width, 1)),
+                                                        1),
+                            band_nodatas[b], raquet::encode_constant_tile(plane, dt_size, dt_size)));
+                        continue;
+                    }
+                    if (valid_count == static_cast<size_t>(width) * height) {
+                        mask.clear();
+                    }
+                }
+                size_t plane_bytes = band_bytes;
+                size_t elem_size = dt_size;
+                int row_width = width;
+                bool is_float = GDALDataTypeIsFloating(dt);
+                if (packed_bits > 0) {
+                    // nbits: the predictor and codec run on the packed rows as bytes
+                    try {
+                        plane_bytes = raquet::pack_bits(plane, width, height, packed_bits);
+                    } catch (std::out_of_range &e) {
+                        throw InvalidInputException("read_raster: band %d: %s (use nbits=8 to keep bytes)",
+                                                    b + 1, e.what());
+                    }
+                    row_width = static_cast<int>(raquet::packed_row_bytes(width, packed_bits));
+                } else if (b < static_cast<int>(band_quant.size()) && !band_quant[b].stored_type.empty()) {
+                    // max_error: floats become narrower integer codes in place,
+                    // then the predictor and codec run on the codes
+                    const auto &q = band_quant[b];
+                    size_t count = static_cast<size_t>(width) * height;
+                    raquet::quantize_band(plane, count, dt_size, q.stored_type, q.scale, q.offset,
+                                          q.nodata_code, band_has_nodata[b], band_nodatas[b]);
+                    elem_size = raquet::dtype_size(raquet::parse_dtype(q.stored_type));
+                    plane_bytes = count * elem_size;
+                    is_float = false;
+                }
+                const std::vector<uint8_t> *dictionary =
+                    b < static_cast<int>(band_dictionaries.size()) ? band_dictionaries[b].get() : nullptr;
+                auto blob = raquet::compress_band_bytes(plane, plane_bytes, compression, auto_objective,
+                                                        predictor, elem_size, is_float, row_width, 1, dictionary);
+                if (!mask.empty()) {
+                    blob = raquet::wrap_validity_mask(
+                        raquet::compress_band_bytes(mask.data(), mask.size(), compression, auto_objective, 1, 1,
+                                                    false, static_cast<int>(raquet::packed_row_bytes(width, 1)), 1),
+                        band_nodatas[b], blob);
+                }
+                result.compressed.push_back(std::move(blob));
             } else {
                 throw InvalidInputException("Compression '%s' requires interleaved band layout",
                                              compression);
             }
         }
     }
+    result.compress_ns = ElapsedNs(compress_start);
 
     return result;
 }
 
+// ─────────────────────────────────────────────
+// Helper: Replace band blobs of this tile that an earlier tile already
+// produced with tile references (see TileDedup)
+// ─────────────────────────────────────────────
+static void DeduplicateTile(TileDedup &dedup, TileData &tile_data) {
+    const size_t band_count = tile_data.compressed.size();
+    std::vector<hash_t> hashes(band_count, 0);
+    for (size_t b = 0; b < band_count; b++) {
+        const auto &blob = tile_data.compressed[b];
+        if (blob.size() >= DEDUP_MIN_BLOB) {
+            hashes[b] = CombineHash(Hash(reinterpret_cast<const char *>(blob.data()), blob.size()),
+                                    Hash<uint64_t>(b));
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(dedup.lock);
+    if (dedup.band_blobs.size() < band_count) {
+        dedup.band_blobs.resize(band_count);
+    }
+    for (size_t b = 0; b < band_count; b++) {
+        auto &blob = tile_data.compressed[b];
+        if (blob.size() < DEDUP_MIN_BLOB) {
+            continue;
+        }
+        auto inserted = dedup.seen.emplace(hashes[b], TileDedup::Entry {static_cast<int>(b), -1});
+        if (inserted.second) {
+            continue;  // first tile with this content keeps its blob
+        }
+        auto &entry = inserted.first->second;
+        auto &slots = dedup.band_blobs[b];
+        if (entry.band != static_cast<int>(b)) {
+            continue;
+        }
+        if (entry.slot < 0) {
+            if (dedup.dictionary_bytes + blob.size() > DEDUP_MAX_DICTIONARY) {
+                continue;
+            }
+            entry.slot = static_cast<int64_t>(slots.size());
+            slots.push_back(blob);
+            dedup.dictionary_bytes += blob.size();
+        } else if (slots[entry.slot] != blob) {
+            continue;  // hash collision
+        }
+        blob = raquet::encode_tile_ref(static_cast<uint32_t>(entry.slot));
+    }
+}
+
 // ─────────────────────────────────────────────
 // Pure-math WGS84 ↔ Web Mercator conversions (no PROJ needed)
 // ─────────────────────────────────────────────
@@ -1054,6 +1421,113 @@ static int CalculateMinZoom(double minlon, double minlat, double maxlon, double
     return std::max(0, std::min(max_zoom, min_zoom));
 }
 
+// ─────────────────────────────────────────────
+// Helper: Open GDAL dataset (with ASSUME_LONGLAT fallback)
+// ─────────────────────────────────────────────
+static GDALDatasetH OpenGDALDataset(const std::string &filename) {
+    EnsureGDALRegistered();
+    GDALDatasetH ds = GDALOpen(filename.c_str(), GA_ReadOnly);
+    if (!ds) {
+        // Try with ASSUME_LONGLAT=YES for files without CRS (e.g., some NetCDFs)
+        char **open_options = CSLSetNameValue(nullptr, "ASSUME_LONGLAT", "YES");
+        ds = GDALOpenEx(filename.c_str(), GDAL_OF_RASTER | GDAL_OF_READONLY,
+                        nullptr, const_cast<const char *const *>(open_options), nullptr);
+        CSLDestroy(open_options);
+    }
+    return ds;
+}
+
+// ─────────────────────────────────────────────
+// Helper: Train one preset deflate dictionary per output band from a 4x4
+// grid of block-sized source windows. Each window goes through the same
+// quantization and predictor as a tile would, so the dictionary holds the
+// byte sequences gzip will actually see. Constant windows (nodata fill,
+// flat water) are skipped: they compress to almost nothing on their own.
+// ─────────────────────────────────────────────
+static void TrainBandDictionaries(GDALDatasetH ds, ReadRasterBindData &bind_data) {
+    constexpr int GRID = 4;
+    const int win = std::min(bind_data.block_size, std::min(bind_data.raster_width, bind_data.raster_height));
+    const size_t src_elem = bind_data.dtype_bytes;
+    const size_t count = static_cast<size_t>(win) * win;
+
+    std::set<std::pair<int, int>> origins;
+    for (int gy = 0; gy < GRID; gy++) {
+        for (int gx = 0; gx < GRID; gx++) {
+            origins.insert({(bind_data.raster_width - win) * gx / (GRID - 1),
+                            (bind_data.raster_height - win) * gy / (GRID - 1)});
+        }
+    }
+
+    for (size_t idx = 0; idx < bind_data.selected_bands.size(); idx++) {
+        GDALRasterBandH band = GDALGetRasterBand(ds, bind_data.selected_bands[idx]);
+        std::vector<std::vector<uint8_t>> samples;
+        for (auto &origin : origins) {
+            std::vector<uint8_t> buf(count * src_elem);
+            if (GDALRasterIO(band, GF_Read, origin.first, origin.second, win, win,
+                             buf.data(), win, win, bind_data.gdal_dtype, 0, 0) != CE_None) {
+                continue;
+            }
+            bool constant = true;
+            for (size_t i = src_elem; i < buf.size() && constant; i += src_elem) {
+                constant = memcmp(buf.data(), buf.data() + i, src_elem) == 0;
+            }
+            if (constant) {
+                continue;
+            }
+
+            size_t elem_size = src_elem;
+            int row_width = win;
+            if (bind_data.packed_bits > 0) {
+                try {
+                    buf.resize(raquet::pack_bits(buf.data(), win, win, bind_data.packed_bits));
+                } catch (std::out_of_range &) {
+                    continue;  // the tile pass reports the offending value
+                }
+                row_width = static_cast<int>(raquet::packed_row_bytes(win, bind_data.packed_bits));
+            } else if (idx < bind_data.band_quant.size()) {
+                const auto &q = bind_data.band_quant[idx];
+                raquet::quantize_band(buf.data(), count, src_elem, q.stored_type, q.scale, q.offset,
+                                      q.nodata_code, bind_data.band_has_nodata[idx],
+                                      bind_data.band_nodatas[idx]);
+                elem_size = raquet::dtype_size(raquet::parse_dtype(q.stored_type));
+                buf.resize(count * elem_size);
+            }
+            if (bind_data.predictor == 2) {
+                raquet::apply_horizontal_predictor(buf.data(), buf.size(), elem_size, row_width, 1);
+            } else if (bind_data.predictor == 3) {
+                raquet::apply_float_predictor(buf.data(), buf.size(), elem_size, win, 1);
+            }
+            samples.push_back(std::move(buf));
+        }
+
+        auto dictionary = raquet::train_deflate_dictionary(samples, bind_data.dictionary_size);
+        bind_data.band_dictionaries.push_back(
+            dictionary.empty() ? nullptr
+                               : std::make_shared<const std::vector<uint8_t>>(std::move(dictionary)));
+    }
+}
+
+// ─────────────────────────────────────────────
+// Helper: one exact-stats worker as a DuckDB task. Bind hands the workers
+// to a TaskExecutor so the scan runs on the scheduler's threads (and honours
+// SET threads) rather than on threads of its own; the binding thread works
+// on the tasks too while it waits.
+// ─────────────────────────────────────────────
+class BandStatsWorkerTask : public BaseExecutorTask {
+public:
+    BandStatsWorkerTask(TaskExecutor &executor, const std::function<void(int)> &work, int worker)
+        : BaseExecutorTask(executor), work(work), worker(worker) {
+    }
+
+    void ExecuteTask() override {
+        work(worker);
+    }
+
+private:
+    const std::function<void(int)> &work;
+    int worker;
+};
+
 // ─────────────────────────────────────────────
 // BIND
 // ─────────────────────────────────────────────
@@ -1068,6 +1542,12 @@ static unique_ptr<FunctionData> ReadRasterBind(ClientContext &context,
     for (auto &kv : input.named_parameters) {
         if (kv.first == "compression") {
             bind_data->compression = StringUtil::Lower(kv.second.GetValue<string>());
+        } else if (kv.first == "auto_objective") {
+            bind_data->auto_objective = StringUtil::Lower(kv.second.GetValue<string>());
+            if (bind_data->auto_objective != "size" && bind_data->auto_objective != "balanced" &&
+                bind_data->auto_objective != "speed") {
+                throw InvalidInputException("auto_objective must be 'size', 'balanced', or 'speed'");
+            }
         } else if (kv.first == "resampling") {
             auto resample_str = StringUtil::Lower(kv.second.GetValue<string>());
             bind_data->resampling = ParseResampling(resample_str);
@@ -1088,6 +1568,35 @@ static unique_ptr<FunctionData> ReadRasterBind(ClientContext &context,
             bind_data->band_layout = StringUtil::Lower(kv.second.GetValue<string>());
         } else if (kv.first == "quality") {
             bind_data->compression_quality = kv.second.GetValue<int32_t>();
+        } else if (kv.first == "predictor") {
+            bind_data->predictor = kv.second.GetValue<int32_t>();
+            if (bind_data->predictor < 1 || bind_data->predictor > 3) {
+                throw InvalidInputException(
+                    "predictor must be 1 (none), 2 (horizontal differencing) or 3 (floating point)");
+            }
+        } else if (kv.first == "max_error") {
+            bind_data->max_error = kv.second.GetValue<double>();
+            if (!(bind_data->max_error > 0)) {
+                throw InvalidInputException("max_error must be a positive number");
+            }
+        } else if (kv.first == "dictionary_size") {
+            bind_data->dictionary_size = kv.second.GetValue<int32_t>();
+            if (bind_data->dictionary_size != 0 &&
+                (bind_data->dictionary_size < 256 || bind_data->dictionary_size > 32768)) {
+                throw InvalidInputException("dictionary_size must be 0 (off) or between 256 and 32768 bytes");
+            }
+        } else if (kv.first == "constant_tiles") {
+            bind_data->constant_tiles = kv.second.GetValue<bool>();
+        } else if (kv.first == "dedup") {
+            bind_data->dedup = kv.second.GetValue<bool>();
+        } else if (kv.first == "validity_mask") {
+            bind_data->validity_mask = kv.second.GetValue<bool>();
+        } else if (kv.first == "nbits") {
+            bind_data->nbits = kv.second.GetValue<int32_t>();
+            if (bind_data->nbits != 0 && bind_data->nbits != 1 && bind_data->nbits != 2 &&
+                bind_data->nbits != 4 && bind_data->nbits != 8) {
+                throw InvalidInputException("nbits must be 1, 2, 4 or 8");
+            }
         } else if (kv.first == "statistics") {
             bind_data->statistics = kv.second.GetValue<bool>();
         } else if (kv.first == "zoom_strategy") {
@@ -1159,19 +1668,93 @@ static unique_ptr<FunctionData> ReadRasterBind(ClientContext &context,
         }
     }
 
-    // Initialize embedded PROJ database and GDAL
+    if (bind_data->compression == "auto" && bind_data->predictor != 1) {
+        throw InvalidInputException("compression 'auto' picks the predictor per tile; drop predictor=%d",
+                                    bind_data->predictor);
+    }
+    if (bind_data->predictor != 1 && bind_data->compression != "gzip" &&
+        bind_data->compression != "zstd" && bind_data->compression != "lz4") {
+        throw InvalidInputException("predictor=%d requires compression 'gzip', 'zstd' or 'lz4' (got '%s')",
+                                    bind_data->predictor, bind_data->compression);
+    }
+    if (bind_data->max_error > 0) {
+        if (bind_data->band_layout != "sequential") {
+            throw InvalidInputException("max_error requires band_layout 'sequential'");
+        }
+        if (bind_data->compression == "jpeg" || bind_data->compression == "webp") {
+            throw InvalidInputException("max_error requires compression 'gzip', 'zstd', 'lz4' or 'none' (got '%s')",
+                                        bind_data->compression);
+        }
+        if (bind_data->predictor == 3) {
+            throw InvalidInputException(
+                "predictor=3 cannot be combined with max_error: quantized bands are integers (use predictor=2)");
+        }
+        // The codes span the source band's exact range, so the warp must not
+        // leave it: interpolating kernels overshoot (and sum/rms are not
+        // bounded by it), and the clamp would then break the bound.
+        switch (bind_data->resampling) {
+            case GRA_NearestNeighbour:
+            case GRA_Average:
+            case GRA_Mode:
+            case GRA_Max:
+            case GRA_Min:
+            case GRA_Med:
+            case GRA_Q1:
+            case GRA_Q3:
+                break;
+            default:
+                throw InvalidInputException(
+                    "max_error requires a resampling that stays within the source range "
+                    "(nearest, average, mode, min, max, med, q1, q3)");
+        }
+    }
+    if (bind_data->dictionary_size > 0) {
+        if (bind_data->compression != "gzip") {
+            throw InvalidInputException("dictionary_size requires compression 'gzip' (got '%s')",
+                                        bind_data->compression);
+        }
+        if (bind_data->band_layout != "sequential") {
+            throw InvalidInputException("dictionary_size requires band_layout 'sequential'");
+        }
+    }
+    if (bind_data->dedup && bind_data->band_layout != "sequential") {
+        throw InvalidInputException("dedup requires band_layout 'sequential'");
+    }
+    if (bind_data->validity_mask) {
+        if (bind_data->band_layout != "sequential") {
+            throw InvalidInputException("validity_mask requires band_layout 'sequential'");
+        }
+        if (bind_data->compression == "jpeg" || bind_data->compression == "webp") {
+            throw InvalidInputException("validity_mask requires a lossless compression (got '%s')",
+                                        bind_data->compression);
+        }
+    }
+    bool pack_requested = bind_data->nbits > 0 && bind_data->nbits < 8;
+    if (pack_requested) {
+        if (bind_data->band_layout != "sequential") {
+            throw InvalidInputException("nbits=%d requires band_layout 'sequential'", bind_data->nbits);
+        }
+        if (bind_data->compression == "jpeg" || bind_data->compression == "webp") {
+            throw InvalidInputException("nbits=%d requires compression 'gzip', 'zstd', 'lz4', 'auto' or 'none' (got '%s')",
+                                        bind_data->nbits, bind_data->compression);
+        }
+    }
+#ifndef RAQUET_HAS_ZSTD
+    if (bind_data->compression == "zstd") {
+        throw InvalidInputException("compression='zstd' is not available: extension built without zstd");
+    }
+#endif
+#ifndef RAQUET_HAS_LZ4
+    if (bind_data->compression == "lz4") {
+        throw InvalidInputException("compression='lz4' is not available: extension built without lz4");
+    }
+#endif
+
+    // Initialize embedded PROJ database and GDAL (both on first use only)
     raquet::InitEmbeddedProj();
-    EnsureGDALRegistered();
 
     // Open the raster
-    GDALDatasetH ds = GDALOpen(bind_data->filename.c_str(), GA_ReadOnly);
-    if (!ds) {
-        // Try with ASSUME_LONGLAT=YES for files without CRS (e.g., some NetCDFs)
-        char **open_options = CSLSetNameValue(nullptr, "ASSUME_LONGLAT", "YES");
-        ds = GDALOpenEx(bind_data->filename.c_str(), GDAL_OF_RASTER | GDAL_OF_READONLY,
-                         nullptr, const_cast<const char *const *>(open_options), nullptr);
-        CSLDestroy(open_options);
-    }
+    GDALDatasetH ds = OpenGDALDataset(bind_data->filename);
     if (!ds) {
         throw IOException("Failed to open raster file: %s", bind_data->filename);
     }
@@ -1224,6 +1807,66 @@ static unique_ptr<FunctionData> ReadRasterBind(ClientContext &context,
     bind_data->raquet_dtype = GDALTypeToRaquetType(bind_data->gdal_dtype);
     bind_data->dtype_bytes = GDALTypeSize(bind_data->gdal_dtype);
 
+    // As in TIFF: horizontal differencing is for integer bands (on float bit
+    // patterns it only scrambles the exponent bytes), the byte-plane
+    // predictor for float bands.
+    bool float_dtype = bind_data->raquet_dtype.rfind("float", 0) == 0;
+    if (bind_data->max_error > 0) {
+        if (!float_dtype) {
+            GDALClose(ds);
+            throw InvalidInputException("max_error applies to floating-point bands, got '%s'",
+                                        bind_data->raquet_dtype);
+        }
+        // The quantization range comes from the band min/max, so it must
+        // cover every pixel rather than an overview or a sample.
+        bind_data->approx_stats = false;
+    }
+    if (bind_data->predictor == 2 && float_dtype && bind_data->max_error <= 0) {
+        GDALClose(ds);
+        throw InvalidInputException("predictor=2 requires an integer band type, got '%s'",
+                                    bind_data->raquet_dtype);
+    }
+    if (bind_data->predictor == 3 && !float_dtype) {
+        GDALClose(ds);
+        throw InvalidInputException("predictor=3 requires a floating-point band type, got '%s'",
+                                    bind_data->raquet_dtype);
+    }
+
+    // Exact stats (approx=false) for every selected band in one parallel,
+    // block-striped pass over the source, instead of a GDAL full scan plus
+    // a histogram pass per band on the binding thread.
+    std::vector<raquet::BandStatsResult> exact_stats;
+    if (!bind_data->approx_stats) {
+        std::vector<double> nodatas;
+        std::vector<bool> has_nodatas;
+        for (int b : bind_data->selected_bands) {
+            int has_nd = 0;
+            double nd = GDALGetRasterNoDataValue(GDALGetRasterBand(ds, b), &has_nd);
+            nodatas.push_back(has_nd ? nd : 0.0);
+            has_nodatas.push_back(has_nd != 0);
+        }
+        const std::string filename = bind_data->filename;
+        int threads = static_cast<int>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+        auto run_workers = [&context](int workers, const std::function<void(int)> &work) {
+            TaskExecutor executor(context);
+            for (int w = 0; w < workers; w++) {
+                executor.ScheduleTask(make_uniq<BandStatsWorkerTask>(executor, work, w));
+            }
+            executor.WorkOnTasks();
+        };
+        try {
+            exact_stats = raquet::compute_band_stats_exact_parallel(
+                [filename]() { return OpenGDALDataset(filename); },
+                bind_data->selected_bands,
+                bind_data->raster_width, bind_data->raster_height,
+                nodatas, has_nodatas, bind_data->gdal_dtype, threads, run_workers);
+        } catch (std::exception &e) {
+            GDALClose(ds);
+            throw IOException("read_raster: exact band statistics failed for %s: %s",
+                              bind_data->filename, e.what());
+        }
+    }
+
     // Per-band metadata, indexed by output position (0-based dense). Each
     // entry pulls from the source band at selected_bands[idx]. After this
     // loop, all the band_* vectors have selected_bands.size() entries and
@@ -1276,16 +1919,18 @@ static unique_ptr<FunctionData> ReadRasterBind(ClientContext &context,
         // output: GDAL's approxOK toggle controls the basic 7 fields
         // (count/min/max/mean/stddev/sum/sum_squares) for both formats,
         // and quantiles/top_values come from a 1000-pixel sample (approx)
-        // or a streaming full-band histogram (exact). Empty extension
+        // or the parallel full-band histogram above (exact). Empty extension
         // dicts when the band is too sparse — emitted as `{}` by the
         // serializer.
         raquet::BandInfo::Stats st;
-        auto stats = raquet::compute_band_stats(
-            band,
-            bind_data->raster_width, bind_data->raster_height,
-            has_nd ? nd : 0.0, has_nd != 0,
-            bind_data->gdal_dtype,
-            bind_data->approx_stats);
+        auto stats = bind_data->approx_stats
+            ? raquet::compute_band_stats(
+                  band,
+                  bind_data->raster_width, bind_data->raster_height,
+                  has_nd ? nd : 0.0, has_nd != 0,
+                  bind_data->gdal_dtype,
+                  /*approx=*/true)
+            : std::move(exact_stats[idx]);
         if (stats.has_stats) {
             st.count         = stats.count;
             st.min           = stats.min;
@@ -1304,6 +1949,60 @@ static unique_ptr<FunctionData> ReadRasterBind(ClientContext &context,
         bind_data->band_stats.push_back(st);
     }
 
+    // max_error: size each band's integer codes from its exact range.
+    if (bind_data->max_error > 0) {
+        for (size_t idx = 0; idx < bind_data->selected_bands.size(); idx++) {
+            const auto &st = bind_data->band_stats[idx];
+            raquet::BandInfo::Quantization q;
+            q.max_error = bind_data->max_error;
+            double lo = st.has_stats ? st.min : 0.0;
+            double hi = st.has_stats ? st.max : 0.0;
+            if (!raquet::plan_quantization(lo, hi, bind_data->max_error, bind_data->dtype_bytes,
+                                           q.stored_type, q.scale, q.offset, q.nodata_code)) {
+                GDALClose(ds);
+                throw InvalidInputException(
+                    "max_error=%g cannot be met for band %d (range %g..%g): bound is below %s "
+                    "precision or needs more than 32-bit codes",
+                    bind_data->max_error, bind_data->selected_bands[idx], lo, hi, bind_data->raquet_dtype);
+            }
+            bind_data->band_quant.push_back(q);
+        }
+    }
+
+    // nbits: byte bands whose values fit in 1, 2 or 4 bits (masks, small
+    // class rasters) are stored bit-packed. Without nbits the source's own
+    // NBITS decides, silently falling back to bytes where packing can't apply.
+    int nbits = bind_data->nbits;
+    if (nbits == 0 && bind_data->gdal_dtype == GDT_Byte && bind_data->band_layout == "sequential" &&
+        bind_data->compression != "jpeg" && bind_data->compression != "webp") {
+        GDALRasterBandH nbits_band = GDALGetRasterBand(ds, bind_data->selected_bands[0]);
+        const char *source_nbits = GDALGetMetadataItem(nbits_band, "NBITS", "IMAGE_STRUCTURE");
+        nbits = source_nbits ? std::atoi(source_nbits) : 8;
+    }
+    if (nbits == 1 || nbits == 2 || nbits == 4) {
+        std::string reason;
+        if (bind_data->gdal_dtype != GDT_Byte) {
+            reason = StringUtil::Format("needs uint8 source bands, got '%s'", bind_data->raquet_dtype);
+        }
+        for (size_t idx = 0; idx < bind_data->selected_bands.size() && reason.empty(); idx++) {
+            if (bind_data->band_has_nodata[idx] && bind_data->band_nodatas[idx] >= (1 << nbits)) {
+                reason = StringUtil::Format("cannot hold band %d's nodata value %g",
+                                            bind_data->selected_bands[idx], bind_data->band_nodatas[idx]);
+            }
+        }
+        if (reason.empty()) {
+            bind_data->packed_bits = nbits;
+            bind_data->raquet_dtype = "uint" + std::to_string(nbits);
+        } else if (pack_requested) {
+            GDALClose(ds);
+            throw InvalidInputException("nbits=%d %s", nbits, reason);
+        }
+    }
+
+    if (bind_data->dictionary_size > 0) {
+        TrainBandDictionaries(ds, *bind_data);
+    }
+
     // Resolve the sparsity-probe gate. Auto enables the IO probe when at
     // least one band has bind-time stats and max(valid_percent) is below
     // the cutoff; otherwise the probe is off. On/Off honor the user's
@@ -1567,21 +2266,6 @@ static unique_ptr<FunctionData> ReadRasterBind(ClientContext &context,
     return std::move(bind_data);
 }
 
-// ─────────────────────────────────────────────
-// Helper: Open GDAL dataset (with ASSUME_LONGLAT fallback)
-// ─────────────────────────────────────────────
-static GDALDatasetH OpenGDALDataset(const std::string &filename) {
-    EnsureGDALRegistered();
-    GDALDatasetH ds = GDALOpen(filename.c_str(), GA_ReadOnly);
-    if (!ds) {
-        char **open_options = CSLSetNameValue(nullptr, "ASSUME_LONGLAT", "YES");
-        ds = GDALOpenEx(filename.c_str(), GDAL_OF_RASTER | GDAL_OF_READONLY,
-                        nullptr, const_cast<const char *const *>(open_options), nullptr);
-        CSLDestroy(open_options);
-    }
-    return ds;
-}
-
 // ─────────────────────────────────────────────
 // INIT GLOBAL
 // ─────────────────────────────────────────────
@@ -1590,6 +2274,13 @@ static unique_ptr<GlobalTableFunctionState> ReadRasterInitGlobal(ClientContext &
     auto &bind_data = input.bind_data->Cast<ReadRasterBindData>();
     auto state = make_uniq<ReadRasterGlobalState>();
     state->init_start = std::chrono::steady_clock::now();
+    state->metrics_at_init = raquet::metrics_snapshot();
+    state->profile_block_size = bind_data.block_size;
+    state->buffer_manager = &BufferManager::GetBufferManager(context);
+    // Staged overview payload may take a quarter of memory_limit before
+    // producers push back; the rest is left to the operators downstream.
+    state->overview_staging.budget =
+        MaxValue<idx_t>(state->buffer_manager->GetMaxMemory() / 4, 2 * OVERVIEW_STAGING_BLOCK_SIZE);
 
     state->source_resampling = bind_data.resampling;
     state->has_overviews = (bind_data.min_zoom < bind_data.max_zoom);
@@ -1640,15 +2331,21 @@ static unique_ptr<GlobalTableFunctionState> ReadRasterInitGlobal(ClientContext &
 static unique_ptr<LocalTableFunctionState> ReadRasterInitLocal(ExecutionContext &context,
                                                                 TableFunctionInitInput &input,
                                                                 GlobalTableFunctionState *global_state) {
-    return make_uniq<ReadRasterLocalState>();
+    auto local = make_uniq<ReadRasterLocalState>();
+    auto &state = global_state->Cast<ReadRasterGlobalState>();
+    std::lock_guard<std::mutex> lock(state.profile_mutex);
+    state.thread_profiles.push_back(make_uniq<ReadRasterThreadProfile>());
+    local->profile = state.thread_profiles.back().get();
+    return std::move(local);
 }
 
 // ─────────────────────────────────────────────
 // Helper: Emit a tile row into the output DataChunk
 // ─────────────────────────────────────────────
 static void EmitTileRow(DataChunk &output, idx_t row_count,
-                         const ReadRasterBindData &bind_data,
-                         uint64_t block, const TileData &tile_data) {
+                         const ReadRasterBindData &bind_data, uint64_t block,
+                         const std::vector<string_t> &blobs,
+                         const std::vector<raquet::BandStats> &band_stats) {
     idx_t col = 0;
 
     // block column
@@ -1660,18 +2357,16 @@ static void EmitTileRow(DataChunk &output, idx_t row_count,
     col++;
 
     // band data columns
-    for (size_t b = 0; b < tile_data.compressed.size(); b++) {
-        auto &blob = tile_data.compressed[b];
-        auto str = StringVector::AddStringOrBlob(output.data[col],
-            string_t(reinterpret_cast<const char *>(blob.data()), blob.size()));
+    for (auto &blob : blobs) {
+        auto str = StringVector::AddStringOrBlob(output.data[col], blob);
         FlatVector::GetData<string_t>(output.data[col])[row_count] = str;
         col++;
     }
 
     // Statistics columns
     if (bind_data.statistics) {
-        for (size_t b = 0; b < tile_data.stats.size(); b++) {
-            auto &s = tile_data.stats[b];
+        for (size_t b = 0; b < band_stats.size(); b++) {
+            auto &s = band_stats[b];
             FlatVector::GetData<int64_t>(output.data[col])[row_count] = s.count;  col++;
             FlatVector::GetData<double>(output.data[col])[row_count] = s.min;     col++;
             FlatVector::GetData<double>(output.data[col])[row_count] = s.max;     col++;
@@ -1682,6 +2377,145 @@ static void EmitTileRow(DataChunk &output, idx_t row_count,
     }
 }
 
+static void EmitTileRow(DataChunk &output, idx_t row_count,
+                         const ReadRasterBindData &bind_data,
+                         uint64_t block, const TileData &tile_data) {
+    std::vector<string_t> blobs;
+    blobs.reserve(tile_data.compressed.size());
+    for (auto &blob : tile_data.compressed) {
+        blobs.emplace_back(reinterpret_cast<const char *>(blob.data()), static_cast<uint32_t>(blob.size()));
+    }
+    EmitTileRow(output, row_count, bind_data, block, blobs, tile_data.stats);
+}
+
+// ─────────────────────────────────────────────
+// Helper: Append a finished overview tile to the staging pool and queue.
+// Tiles share the open pooled block until it is full; the full block is
+// unpinned (spillable) and a new one allocated, sized up for tiles larger
+// than OVERVIEW_STAGING_BLOCK_SIZE.
+// ─────────────────────────────────────────────
+static void StageOverviewResult(BufferManager &buffer_manager, OverviewStaging &staging,
+                                uint64_t block, TileData &tile_data) {
+    OverviewResult staged;
+    staged.block = block;
+    staged.stats = std::move(tile_data.stats);
+    idx_t total = 0;
+    for (auto &blob : tile_data.compressed) {
+        staged.blob_sizes.push_back(blob.size());
+        total += blob.size();
+    }
+
+    std::lock_guard<std::mutex> lock(staging.mutex);
+    if (!staging.has_open || staging.blocks.back().used + total > staging.blocks.back().size) {
+        if (staging.has_open) {
+            staging.open_pin = BufferHandle();
+            staging.has_open = false;
+            if (staging.blocks.back().live == 0) {
+                staging.blocks.back().handle.reset();
+            }
+        }
+        OverviewStagingBlock pooled;
+        pooled.size = MaxValue<idx_t>(total, OVERVIEW_STAGING_BLOCK_SIZE);
+        staging.open_pin = buffer_manager.Allocate(MemoryTag::EXTENSION, pooled.size, /*can_destroy=*/false);
+        pooled.handle = staging.open_pin.GetBlockHandle();
+        staging.blocks.push_back(std::move(pooled));
+        staging.has_open = true;
+    }
+    auto &pooled = staging.blocks.back();
+    data_ptr_t dst = staging.open_pin.Ptr() + pooled.used;
+    for (auto &blob : tile_data.compressed) {
+        if (!blob.empty()) {
+            std::memcpy(dst, blob.data(), blob.size());
+            dst += blob.size();
+        }
+    }
+    staged.staging_block = staging.blocks.size() - 1;
+    staged.offset = pooled.used;
+    pooled.used += total;
+    pooled.live++;
+    staging.staged_bytes += total;
+    staging.queue.push_back(std::move(staged));
+}
+
+// Unpins the last open staging block once every producer is done; frees it
+// right away if it has already been drained.
+static void CloseOverviewStaging(OverviewStaging &staging) {
+    std::lock_guard<std::mutex> lock(staging.mutex);
+    if (!staging.has_open) {
+        return;
+    }
+    staging.open_pin = BufferHandle();
+    staging.has_open = false;
+    if (staging.blocks.back().live == 0) {
+        staging.blocks.back().handle.reset();
+    }
+}
+
+// True when staged-but-undrained payload has reached the staging budget or
+// the buffer manager is within one staging block of memory_limit. Producers
+// then drain instead of warping, which pushes rows downstream before the
+// limit is hit rather than failing allocation at it. Never true with an
+// empty queue, so a saturated pool always has something to drain.
+static bool OverviewStagingSaturated(BufferManager &buffer_manager, OverviewStaging &staging) {
+    {
+        std::lock_guard<std::mutex> lock(staging.mutex);
+        if (staging.queue.empty()) {
+            return false;
+        }
+        if (staging.staged_bytes >= staging.budget) {
+            return true;
+        }
+    }
+    return buffer_manager.GetUsedMemory() + OVERVIEW_STAGING_BLOCK_SIZE >= buffer_manager.GetMaxMemory();
+}
+
+// Pops staged tiles into `output` until the queue is empty or the chunk has
+// room only for the metadata row. Returns the new row count.
+static idx_t DrainOverviewStaging(DataChunk &output, idx_t row_count, idx_t max_rows,
+                                  const ReadRasterBindData &bind_data,
+                                  BufferManager &buffer_manager, OverviewStaging &staging) {
+    while (row_count + 1 < max_rows) {
+        OverviewResult staged;
+        shared_ptr<BlockHandle> handle;
+        {
+            std::lock_guard<std::mutex> lock(staging.mutex);
+            if (staging.queue.empty()) {
+                break;
+            }
+            staged = std::move(staging.queue.front());
+            staging.queue.pop_front();
+            handle = staging.blocks[staged.staging_block].handle;
+        }
+
+        idx_t total = 0;
+        {
+            auto pin = buffer_manager.Pin(handle);
+            const char *src = reinterpret_cast<const char *>(pin.Ptr()) + staged.offset;
+            std::vector<string_t> blobs;
+            blobs.reserve(staged.blob_sizes.size());
+            for (auto size : staged.blob_sizes) {
+                blobs.emplace_back(src, static_cast<uint32_t>(size));
+                src += size;
+                total += size;
+            }
+            // Emitted rows own a copy in the output vector.
+            EmitTileRow(output, row_count, bind_data, staged.block, blobs, staged.stats);
+        }
+        row_count++;
+
+        // Free the pooled block once its last tile is out, unless producers
+        // are still filling it.
+        std::lock_guard<std::mutex> lock(staging.mutex);
+        staging.staged_bytes -= total;
+        auto &pooled = staging.blocks[staged.staging_block];
+        if (--pooled.live == 0 &&
+            !(staging.has_open && staged.staging_block + 1 == staging.blocks.size())) {
+            pooled.handle.reset();
+        }
+    }
+    return row_count;
+}
+
 // ─────────────────────────────────────────────
 // EXECUTE — two-phase: parallel native zoom, then single-thread overviews
 // ─────────────────────────────────────────────
@@ -1707,6 +2541,10 @@ static void ReadRasterExecute(ClientContext &context, TableFunctionInput &data,
         OSRImportFromEPSG(srs, 3857);
         OSRExportToWkt(srs, &local.web_mercator_wkt);
         OSRDestroySpatialReference(srs);
+        local.band_scratch_size = bind_data.selected_bands.size() *
+                                  static_cast<idx_t>(bind_data.block_size) * bind_data.block_size *
+                                  GDALGetDataTypeSizeBytes(bind_data.gdal_dtype);
+        local.band_scratch = state.buffer_manager->Allocate(MemoryTag::EXTENSION, local.band_scratch_size);
         local.initialized = true;
     }
 
@@ -1759,10 +2597,13 @@ static void ReadRasterExecute(ClientContext &context, TableFunctionInput &data,
         // time from sparsity_probe + valid_percent stats).
         bool pre_warp_skip = false;
         if (bind_data.sparsity_probe != SparsityProbe::Off) {
+            auto probe_start = std::chrono::steady_clock::now();
             EnsureWarpTransformer(local, local.src_ds, tile_ds, /*overview_level=*/-1);
             pre_warp_skip = IsTileOutsideSource(local.src_ds, local.warp_transformer,
                                                  bind_data.block_size);
-            if (!pre_warp_skip && bind_data.sparsity_probe_active) {
+            if (pre_warp_skip) {
+                ProfileAdd(local.profile->tiles_skipped_outside, 1);
+            } else if (bind_data.sparsity_probe_active) {
                 pre_warp_skip = IsSourceWindowEmpty(
                     local.src_ds, local.warp_transformer,
                     bind_data.block_size,
@@ -1770,29 +2611,51 @@ static void ReadRasterExecute(ClientContext &context, TableFunctionInput &data,
                     bind_data.band_is_empty,
                     bind_data.selected_bands,
                     bind_data.sparsity_probe_size);
+                if (pre_warp_skip) {
+                    ProfileAdd(local.profile->tiles_skipped_probe, 1);
+                }
             }
+            ProfileAdd(local.profile->probe_ns, ElapsedNs(probe_start));
         }
 
         if (!pre_warp_skip) {
+            auto warp_start = std::chrono::steady_clock::now();
             WarpIntoTile(local, local.src_ds, tile_ds, state.source_resampling,
                          state.nodata_value, state.has_nodata,
                          bind_data.selected_bands);
+            ProfileAdd(local.profile->warp_ns, ElapsedNs(warp_start));
 
             bool empty = IsTileEmpty(tile_ds, bind_data.band_nodatas,
                                      bind_data.band_has_nodata,
                                      bind_data.band_is_empty);
+            if (empty) {
+                raquet::metric_add(raquet::Metric::TILES_SKIPPED_SPARSE, 1);
+                ProfileAdd(local.profile->tiles_skipped_empty, 1);
+            }
 
             if (!empty) {
                 auto tile_data = ReadAndCompressBands(
-                    tile_ds, bind_data.compression, bind_data.compression_quality,
-                    bind_data.band_layout, bind_data.statistics,
-                    bind_data.raquet_dtype, state.has_nodata, state.nodata_value);
+                    tile_ds, local.band_scratch.Ptr(), local.band_scratch_size,
+                    bind_data.compression, bind_data.auto_objective, bind_data.compression_quality,
+                    bind_data.predictor, bind_data.band_layout, bind_data.constant_tiles, bind_data.statistics,
+                    bind_data.raquet_dtype, state.has_nodata, state.nodata_value,
+                    bind_data.band_quant, bind_data.band_nodatas, bind_data.band_has_nodata,
+                    bind_data.band_dictionaries, bind_data.packed_bits, bind_data.validity_mask);
+                ProfileAdd(local.profile->io_ns, tile_data.io_ns);
+                ProfileAdd(local.profile->compress_ns, tile_data.compress_ns);
+
+                if (bind_data.dedup) {
+                    DeduplicateTile(state.dedup, tile_data);
+                }
 
                 uint64_t block = quadbin::tile_to_cell(tile.x, tile.y, tile.z);
                 EmitTileRow(output, row_count, bind_data, block, tile_data);
                 state.total_blocks++;
+                ProfileAdd(local.profile->tiles_emitted, 1);
                 row_count++;
             }
+        } else {
+            raquet::metric_add(raquet::Metric::TILES_SKIPPED_SPARSE, 1);
         }
 
         GDALClose(tile_ds);
@@ -1817,7 +2680,7 @@ static void ReadRasterExecute(ClientContext &context, TableFunctionInput &data,
     // ── Phase 2 staging (parallel): every thread pulls overview frames from
     //    state.overview_frames via next_overview_idx and warps them with its
     //    own per-thread GDAL handle (local.src_ds). Non-empty results are
-    //    pushed into state.overview_results under a brief mutex; the last
+    //    staged into state.overview_staging; the last
     //    thread to finish (overview_frames_processed == size) publishes
     //    phase2_staged. Threads that arrive after staging is already in
     //    progress simply join the work pull. Threads that arrive after
@@ -1843,8 +2706,6 @@ static void ReadRasterExecute(ClientContext &context, TableFunctionInput &data,
                 if (state.overview_frames.empty()) {
                     // Nothing to stage; skip straight to metadata.
                     state.phase2_staged.store(true, std::memory_order_release);
-                } else {
-                    state.overview_results.reserve(state.overview_frames.size());
                 }
                 {
                     int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
@@ -1884,6 +2745,17 @@ static void ReadRasterExecute(ClientContext &context, TableFunctionInput &data,
         // to the total publishes phase2_staged.
         const idx_t total_frames = state.overview_frames.size();
         while (true) {
+            // Pushback: with the staging pool over budget, emit what is
+            // staged instead of warping more; the next Execute call resumes
+            // the pull once the pipeline has consumed this chunk.
+            if (OverviewStagingSaturated(*state.buffer_manager, state.overview_staging)) {
+                row_count = DrainOverviewStaging(output, row_count, max_rows, bind_data,
+                                                 *state.buffer_manager, state.overview_staging);
+                if (row_count > 0) {
+                    output.SetCardinality(row_count);
+                    return;
+                }
+            }
             idx_t my_idx = state.next_overview_idx.fetch_add(1, std::memory_order_acq_rel);
             if (my_idx >= total_frames) {
                 break;
@@ -1939,10 +2811,13 @@ static void ReadRasterExecute(ClientContext &context, TableFunctionInput &data,
             // back-projected pixel coords match the transformer's source space.
             bool pre_warp_skip = false;
             if (bind_data.sparsity_probe != SparsityProbe::Off) {
+                auto probe_start = std::chrono::steady_clock::now();
                 EnsureWarpTransformer(local, ovr_src, tile_ds, chosen_overview);
                 pre_warp_skip = IsTileOutsideSource(ovr_src, local.warp_transformer,
                                                      bind_data.block_size);
-                if (!pre_warp_skip && bind_data.sparsity_probe_active) {
+                if (pre_warp_skip) {
+                    ProfileAdd(local.profile->tiles_skipped_outside, 1);
+                } else if (bind_data.sparsity_probe_active) {
                     pre_warp_skip = IsSourceWindowEmpty(
                         ovr_src, local.warp_transformer,
                         bind_data.block_size,
@@ -1950,10 +2825,15 @@ static void ReadRasterExecute(ClientContext &context, TableFunctionInput &data,
                         bind_data.band_is_empty,
                         bind_data.selected_bands,
                         bind_data.sparsity_probe_size);
+                    if (pre_warp_skip) {
+                        ProfileAdd(local.profile->tiles_skipped_probe, 1);
+                    }
                 }
+                ProfileAdd(local.profile->probe_ns, ElapsedNs(probe_start));
             }
 
             if (!pre_warp_skip) {
+                auto warp_start = std::chrono::steady_clock::now();
                 if (chosen_overview >= 0) {
                     // COG fast path: read directly from the matching source
                     // overview (ovr_src). Geometrically valid for any source
@@ -1972,24 +2852,38 @@ static void ReadRasterExecute(ClientContext &context, TableFunctionInput &data,
                                  state.nodata_value, state.has_nodata,
                                  bind_data.selected_bands);
                 }
+                ProfileAdd(local.profile->warp_ns, ElapsedNs(warp_start));
 
                 bool empty = IsTileEmpty(tile_ds, bind_data.band_nodatas,
                                          bind_data.band_has_nodata,
                                          bind_data.band_is_empty);
+                if (empty) {
+                    raquet::metric_add(raquet::Metric::TILES_SKIPPED_SPARSE, 1);
+                    ProfileAdd(local.profile->tiles_skipped_empty, 1);
+                }
 
                 if (!empty) {
                     auto tile_data = ReadAndCompressBands(
-                        tile_ds, bind_data.compression, bind_data.compression_quality,
-                        bind_data.band_layout, bind_data.statistics,
-                        bind_data.raquet_dtype, state.has_nodata, state.nodata_value);
+                        tile_ds, local.band_scratch.Ptr(), local.band_scratch_size,
+                        bind_data.compression, bind_data.auto_objective, bind_data.compression_quality,
+                        bind_data.predictor, bind_data.band_layout, bind_data.constant_tiles, bind_data.statistics,
+                        bind_data.raquet_dtype, state.has_nodata, state.nodata_value,
+                        bind_data.band_quant, bind_data.band_nodatas, bind_data.band_has_nodata,
+                        bind_data.band_dictionaries, bind_data.packed_bits, bind_data.validity_mask);
+                    ProfileAdd(local.profile->io_ns, tile_data.io_ns);
+                    ProfileAdd(local.profile->compress_ns, tile_data.compress_ns);
+
+                    if (bind_data.dedup) {
+                        DeduplicateTile(state.dedup, tile_data);
+                    }
 
                     uint64_t block = quadbin::tile_to_cell(frame.tile.x, frame.tile.y, frame.tile.z);
-                    {
-                        std::lock_guard<std::mutex> lock(state.overview_results_mutex);
-                        state.overview_results.push_back({block, std::move(tile_data)});
-                    }
+                    StageOverviewResult(*state.buffer_manager, state.overview_staging, block, tile_data);
                     state.total_blocks++;
+                    ProfileAdd(local.profile->tiles_emitted, 1);
                 }
+            } else {
+                raquet::metric_add(raquet::Metric::TILES_SKIPPED_SPARSE, 1);
             }
 
             GDALClose(tile_ds);
@@ -2007,15 +2901,15 @@ static void ReadRasterExecute(ClientContext &context, TableFunctionInput &data,
                         int64_t p2_init = state.phase2_init_ns.load(std::memory_order_acquire);
                         fprintf(stderr,
                             "[raquet-phase] phase2_staged @ %.3fs (phase2_wall=%.3fs, "
-                            "overview_frames=%zu, staged=%zu, total_blocks=%d)\n",
+                            "overview_frames=%zu, total_blocks=%d)\n",
                             now_ns / 1e9,
                             (now_ns - p2_init) / 1e9,
                             total_frames,
-                            state.overview_results.size(),
                             state.total_blocks.load());
                         fflush(stderr);
                     }
                 }
+                CloseOverviewStaging(state.overview_staging);
                 state.phase2_staged.store(true, std::memory_order_release);
                 { std::lock_guard<std::mutex> lk(state.wait_mutex); }
                 state.wait_cv.notify_all();
@@ -2047,23 +2941,13 @@ static void ReadRasterExecute(ClientContext &context, TableFunctionInput &data,
 
     // ── Phase 2 drain: any thread can pull from the staged queue, capped at
     //    max_rows - 1 so there's still room for the metadata row in this chunk
-    //    if the queue runs out here. Lock-free fetch_add: threads may
-    //    over-increment past .size() (those return without emitting), which is
-    //    fine — we only need >= size() to mean "drained" for the metadata gate.
-    const idx_t overview_total = state.overview_results.size();
-    while (row_count + 1 < max_rows) {
-        idx_t my_idx = state.overview_drain_idx.fetch_add(1, std::memory_order_acq_rel);
-        if (my_idx >= overview_total) {
-            break;
-        }
-        auto &result = state.overview_results[my_idx];
-        EmitTileRow(output, row_count, bind_data, result.block, result.tile_data);
-        row_count++;
-    }
+    //    if the queue runs out here.
+    row_count = DrainOverviewStaging(output, row_count, max_rows, bind_data,
+                                     *state.buffer_manager, state.overview_staging);
 
     // If the overview queue still has tiles to drain, leave metadata for a
     // later Execute call.
-    if (state.overview_drain_idx.load(std::memory_order_acquire) < overview_total) {
+    if (row_count + 1 >= max_rows) {
         output.SetCardinality(row_count);
         return;
     }
@@ -2092,7 +2976,11 @@ static void ReadRasterExecute(ClientContext &context, TableFunctionInput &data,
         meta.crs = "EPSG:3857";
         meta.compression = bind_data.compression;
         meta.compression_quality = bind_data.compression_quality;
+        meta.compression_predictor = bind_data.predictor;
         meta.band_layout = bind_data.band_layout;
+        // All-nodata masked tiles carry a constant tile too
+        meta.constant_tiles = bind_data.band_layout == "sequential" &&
+                              (bind_data.constant_tiles || bind_data.validity_mask);
         meta.scheme = "quadbin";
         meta.block_width = bind_data.block_size;
         meta.block_height = bind_data.block_size;
@@ -2159,6 +3047,17 @@ static void ReadRasterExecute(ClientContext &context, TableFunctionInput &data,
             if (b < static_cast<int>(bind_data.band_stats.size())) {
                 bi.stats = bind_data.band_stats[b];
             }
+            if (b < static_cast<int>(bind_data.band_quant.size())) {
+                bi.quantization = bind_data.band_quant[b];
+            }
+            if (b < static_cast<int>(bind_data.band_dictionaries.size())) {
+                bi.compression_dictionary = bind_data.band_dictionaries[b];
+            }
+            bi.validity_mask = bind_data.validity_mask && bi.has_nodata;
+            if (b < static_cast<int>(state.dedup.band_blobs.size()) && !state.dedup.band_blobs[b].empty()) {
+                bi.tile_dictionary = std::make_shared<const std::vector<std::vector<uint8_t>>>(
+                    std::move(state.dedup.band_blobs[b]));
+            }
             meta.band_info.push_back(bi);
             meta.bands.push_back({bi.name, bi.type});
         }
@@ -2209,6 +3108,107 @@ static unique_ptr<NodeStatistics> ReadRasterCardinality(ClientContext &context,
     return make_uniq<NodeStatistics>(bind_data.estimated_tiles);
 }
 
+// ─────────────────────────────────────────────
+// PROGRESS — fraction of native tiles plus overview frames fully processed.
+// Phase 3 (drain + metadata) is short, so 100% is only reported once the
+// metadata row has been emitted.
+// ─────────────────────────────────────────────
+static double ReadRasterProgress(ClientContext &context, const FunctionData *bind_data_p,
+                                 const GlobalTableFunctionState *global_state) {
+    auto &state = global_state->Cast<ReadRasterGlobalState>();
+    if (state.metadata_emitted.load(std::memory_order_acquire)) {
+        return 100.0;
+    }
+    double total = static_cast<double>(state.native_tiles.size() + state.overview_frames.size());
+    if (total == 0) {
+        return -1;
+    }
+    double done = static_cast<double>(state.phase1_finished.load(std::memory_order_relaxed) +
+                                      state.overview_frames_processed.load(std::memory_order_relaxed));
+    return std::min(99.9, 100.0 * done / total);
+}
+
+// ─────────────────────────────────────────────
+// DYNAMIC TO STRING — per-scan counters shown by EXPLAIN ANALYZE
+//
+// Counters are process-wide, so a concurrent query touching the same kernels
+// inflates these numbers; they are meant for profiling one query at a time.
+// ─────────────────────────────────────────────
+static InsertionOrderPreservingMap<string> ReadRasterDynamicToString(TableFunctionDynamicToStringInput &input) {
+    InsertionOrderPreservingMap<string> result;
+    if (!input.global_state) {
+        return result;
+    }
+    auto &state = input.global_state->Cast<ReadRasterGlobalState>();
+    result["Tiles"] = std::to_string(state.total_blocks.load());
+    auto now = raquet::metrics_snapshot();
+    for (size_t i = 0; i < raquet::METRIC_COUNT; i++) {
+        auto m = static_cast<raquet::Metric>(i);
+        if (m != raquet::Metric::TILES_SKIPPED_SPARSE && m != raquet::Metric::WARP_NS &&
+            m != raquet::Metric::COMPRESS_NS) {
+            continue;
+        }
+        uint64_t before = i < state.metrics_at_init.size() ? state.metrics_at_init[i] : 0;
+        uint64_t delta = now[i] >= before ? now[i] - before : 0;
+        if (std::string(raquet::metric_unit(m)) == "ns") {
+            result[raquet::metric_name(m)] = StringUtil::Format("%.1f ms", delta / 1e6);
+        } else {
+            result[raquet::metric_name(m)] = std::to_string(delta);
+        }
+    }
+    return result;
+}
+
+// ─────────────────────────────────────────────
+// read_raster_profile() -> TABLE(scope, metric, value, unit)
+//
+// Timing and tile accounting for the most recent read_raster scan: phase
+// wall times, tile counts by outcome (emitted / skipped by the geometric
+// pre-check / skipped by the sparsity probe / empty after warp) and time in
+// probe, warp, GDAL IO and compression — summed under scope 'scan' and
+// broken out per worker under 'thread_<n>'. Meant for tuning block_size,
+// sparsity_probe and thread count:
+//
+//   COPY (SELECT * FROM read_raster('in.tif')) TO 'out.parquet';
+//   SELECT * FROM read_raster_profile() WHERE scope = 'scan';
+// ─────────────────────────────────────────────
+struct ReadRasterProfileGlobalState : public GlobalTableFunctionState {
+    std::vector<ReadRasterProfileRow> rows;
+    idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> ReadRasterProfileBind(ClientContext &context, TableFunctionBindInput &input,
+                                                      vector<LogicalType> &return_types, vector<string> &names) {
+    names.push_back("scope");   return_types.push_back(LogicalType::VARCHAR);
+    names.push_back("metric");  return_types.push_back(LogicalType::VARCHAR);
+    names.push_back("value");   return_types.push_back(LogicalType::DOUBLE);
+    names.push_back("unit");    return_types.push_back(LogicalType::VARCHAR);
+    return make_uniq<TableFunctionData>();
+}
+
+static unique_ptr<GlobalTableFunctionState> ReadRasterProfileInitGlobal(ClientContext &context,
+                                                                        TableFunctionInitInput &input) {
+    auto state = make_uniq<ReadRasterProfileGlobalState>();
+    std::lock_guard<std::mutex> lock(LastProfileMutex());
+    state->rows = LastProfile();
+    return std::move(state);
+}
+
+static void ReadRasterProfileExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &state = data.global_state->Cast<ReadRasterProfileGlobalState>();
+    idx_t row = 0;
+    while (state.offset < state.rows.size() && row < STANDARD_VECTOR_SIZE) {
+        auto &r = state.rows[state.offset];
+        output.SetValue(0, row, Value(r.scope));
+        output.SetValue(1, row, Value(r.metric));
+        output.SetValue(2, row, Value::DOUBLE(r.value));
+        output.SetValue(3, row, Value(r.unit));
+        state.offset++;
+        row++;
+    }
+    output.SetCardinality(row);
+}
+
 // ─────────────────────────────────────────────
 // REGISTRATION
 // ─────────────────────────────────────────────
@@ -2217,6 +3217,7 @@ void RegisterReadRaster(ExtensionLoader &loader) {
                        ReadRasterExecute, ReadRasterBind, ReadRasterInitGlobal, ReadRasterInitLocal);
 
     func.named_parameters["compression"] = LogicalType::VARCHAR;
+    func.named_parameters["auto_objective"] = LogicalType::VARCHAR;
     func.named_parameters["resampling"] = LogicalType::VARCHAR;
     func.named_parameters["block_size"] = LogicalType::INTEGER;
     func.named_parameters["max_zoom"] = LogicalType::INTEGER;
@@ -2224,6 +3225,13 @@ void RegisterReadRaster(ExtensionLoader &loader) {
     func.named_parameters["overviews"] = LogicalType::VARCHAR;
     func.named_parameters["band_layout"] = LogicalType::VARCHAR;
     func.named_parameters["quality"] = LogicalType::INTEGER;
+    func.named_parameters["predictor"] = LogicalType::INTEGER;
+    func.named_parameters["max_error"] = LogicalType::DOUBLE;
+    func.named_parameters["dictionary_size"] = LogicalType::INTEGER;
+    func.named_parameters["constant_tiles"] = LogicalType::BOOLEAN;
+    func.named_parameters["dedup"] = LogicalType::BOOLEAN;
+    func.named_parameters["nbits"] = LogicalType::INTEGER;
+    func.named_parameters["validity_mask"] = LogicalType::BOOLEAN;
     func.named_parameters["statistics"] = LogicalType::BOOLEAN;
     func.named_parameters["zoom_strategy"] = LogicalType::VARCHAR;
     func.named_parameters["format"] = LogicalType::VARCHAR;
@@ -2232,8 +3240,14 @@ void RegisterReadRaster(ExtensionLoader &loader) {
     func.named_parameters["sparsity_probe_size"] = LogicalType::INTEGER;
     func.named_parameters["bands"] = LogicalType::VARCHAR;
     func.cardinality = ReadRasterCardinality;
+    func.dynamic_to_string = ReadRasterDynamicToString;
+    func.table_scan_progress = ReadRasterProgress;
 
     loader.RegisterFunction(func);
+
+    TableFunction profile_func("read_raster_profile", {}, ReadRasterProfileExecute,
+                               ReadRasterProfileBind, ReadRasterProfileInitGlobal);
+    loader.RegisterFunction(profile_func);
 }
 
 } // namespace duckdb
@@ -0,0 +1,604 @@
+#include "duckdb.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/function/scalar_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "band_decoder.hpp"
+#include "band_encoder.hpp"
+#include "raquet_metadata.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// ============================================================================
+// ST_AsImage(band, metadata [, style]) -> BLOB
+// ST_AsImage([r, g, b(, a)], metadata, style) -> BLOB
+// Renders a tile as a PNG (or WebP) map image in one call. A single band
+// goes through its colortable or a linear / quantile stretch onto a
+// colormap; 3-4 bands are stretched per channel into RGB(A). Nodata pixels
+// are transparent. Stretches and colormaps are folded into a lookup table
+// indexed by the raw pixel for 8- and 16-bit bands, built once per chunk.
+//
+// style: comma-separated `key=value` pairs, a bare word sets the stretch:
+//   stretch   colortable | linear | quantile (default: colortable if the
+//             band has one, else linear)
+//   colormap  gray | viridis | magma | rdylgn (single band, default gray)
+//   min, max  linear range (default: band stats from the metadata)
+//   classes   quantile classes, a key of the band's stats.quantiles
+//             (default: the largest)
+//   band      band name for a single blob (default: first band)
+//   bands     band names for a list, `|`-separated (default: metadata order)
+//   format    png | webp; quality (webp, default 85)
+// ============================================================================
+
+enum class ImageStretch { AUTO, COLORTABLE, LINEAR, QUANTILE };
+
+struct ImageStyle {
+    ImageStretch stretch = ImageStretch::AUTO;
+    std::string colormap = "gray";
+    bool has_min = false;
+    bool has_max = false;
+    double min = 0.0;
+    double max = 0.0;
+    int classes = 0;
+    std::vector<std::string> bands;
+    std::string format = "png";
+    int quality = 85;
+};
+
+static std::string TrimStyleToken(const std::string &s) {
+    size_t start = s.find_first_not_of(" \t");
+    if (start == std::string::npos) return "";
+    size_t end = s.find_last_not_of(" \t");
+    return s.substr(start, end - start + 1);
+}
+
+static ImageStretch ParseImageStretch(const std::string &name) {
+    if (name == "colortable") return ImageStretch::COLORTABLE;
+    if (name == "linear") return ImageStretch::LINEAR;
+    if (name == "quantile") return ImageStretch::QUANTILE;
+    throw InvalidInputException("ST_AsImage: unknown stretch '%s' (use colortable, linear, quantile)", name);
+}
+
+static double ParseStyleNumber(const std::string &key, const std::string &value) {
+    try {
+        size_t used = 0;
+        double v = std::stod(value, &used);
+        if (used == value.size()) return v;
+    } catch (...) {
+    }
+    throw InvalidInputException("ST_AsImage: style '%s' must be a number, got '%s'", key, value);
+}
+
+static ImageStyle ParseImageStyle(const std::string &style) {
+    ImageStyle result;
+    size_t pos = 0;
+    while (pos <= style.size()) {
+        size_t comma = style.find(',', pos);
+        if (comma == std::string::npos) comma = style.size();
+        std::string token = TrimStyleToken(style.substr(pos, comma - pos));
+        pos = comma + 1;
+        if (token.empty()) continue;
+
+        size_t eq = token.find('=');
+        if (eq == std::string::npos) {
+            result.stretch = ParseImageStretch(token);
+            continue;
+        }
+        std::string key = TrimStyleToken(token.substr(0, eq));
+        std::string value = TrimStyleToken(token.substr(eq + 1));
+        if (key == "stretch") {
+            result.stretch = ParseImageStretch(value);
+        } else if (key == "colormap") {
+            result.colormap = value;
+        } else if (key == "min") {
+            result.min = ParseStyleNumber(key, value);
+            result.has_min = true;
+        } else if (key == "max") {
+            result.max = ParseStyleNumber(key, value);
+            result.has_max = true;
+        } else if (key == "classes") {
+            result.classes = static_cast<int>(ParseStyleNumber(key, value));
+        } else if (key == "band") {
+            result.bands = {value};
+        } else if (key == "bands") {
+            result.bands.clear();
+            size_t start = 0;
+            while (start <= value.size()) {
+                size_t bar = value.find('|', start);
+                if (bar == std::string::npos) bar = value.size();
+                result.bands.push_back(TrimStyleToken(value.substr(start, bar - start)));
+                start = bar + 1;
+            }
+        } else if (key == "format") {
+            if (value != "png" && value != "webp") {
+                throw InvalidInputException("ST_AsImage: unknown format '%s' (use png, webp)", value);
+            }
+            result.format = value;
+        } else if (key == "quality") {
+            result.quality = static_cast<int>(ParseStyleNumber(key, value));
+        } else {
+            throw InvalidInputException("ST_AsImage: unknown style key '%s'", key);
+        }
+    }
+    return result;
+}
+
+// ============================================================================
+// Colormaps: control points interpolated into 256-entry palettes
+// ============================================================================
+
+struct RampStop {
+    double t;
+    uint8_t r, g, b;
+};
+
+static const RampStop RAMP_GRAY[] = {{0.0, 0, 0, 0}, {1.0, 255, 255, 255}};
+static const RampStop RAMP_VIRIDIS[] = {
+    {0.0, 68, 1, 84},       {0.125, 71, 45, 123},  {0.25, 59, 82, 139},
+    {0.375, 44, 114, 142},  {0.5, 33, 145, 140},   {0.625, 40, 174, 128},
+    {0.75, 94, 201, 98},    {0.875, 173, 220, 48}, {1.0, 253, 231, 37}};
+static const RampStop RAMP_MAGMA[] = {
+    {0.0, 0, 0, 4},         {0.125, 28, 16, 68},   {0.25, 79, 18, 123},
+    {0.375, 129, 37, 129},  {0.5, 181, 54, 122},   {0.625, 229, 80, 100},
+    {0.75, 251, 135, 97},   {0.875, 254, 194, 135}, {1.0, 252, 253, 191}};
+static const RampStop RAMP_RDYLGN[] = {
+    {0.0, 165, 0, 38},      {0.111, 215, 48, 39},  {0.222, 244, 109, 67},
+    {0.333, 253, 174, 97},  {0.444, 254, 224, 139}, {0.556, 217, 239, 139},
+    {0.667, 166, 217, 106}, {0.778, 102, 189, 99}, {0.889, 26, 152, 80},
+    {1.0, 0, 104, 55}};
+
+using ImagePalette = std::array<std::array<uint8_t, 4>, 256>;
+
+static ImagePalette BuildPalette(const std::string &name) {
+    const RampStop *stops;
+    size_t count;
+    if (name == "gray" || name == "grey") {
+        stops = RAMP_GRAY;
+        count = sizeof(RAMP_GRAY) / sizeof(RampStop);
+    } else if (name == "viridis") {
+        stops = RAMP_VIRIDIS;
+        count = sizeof(RAMP_VIRIDIS) / sizeof(RampStop);
+    } else if (name == "magma") {
+        stops = RAMP_MAGMA;
+        count = sizeof(RAMP_MAGMA) / sizeof(RampStop);
+    } else if (name == "rdylgn") {
+        stops = RAMP_RDYLGN;
+        count = sizeof(RAMP_RDYLGN) / sizeof(RampStop);
+    } else {
+        throw InvalidInputException("ST_AsImage: unknown colormap '%s' (use gray, viridis, magma, rdylgn)", name);
+    }
+
+    ImagePalette palette;
+    size_t s = 0;
+    for (int i = 0; i < 256; i++) {
+        double t = i / 255.0;
+        while (s + 2 < count && t > stops[s + 1].t) s++;
+        const auto &a = stops[s];
+        const auto &b = stops[s + 1];
+        double f = std::min(1.0, std::max(0.0, (t - a.t) / (b.t - a.t)));
+        palette[i] = {static_cast<uint8_t>(std::lround(a.r + (b.r - a.r) * f)),
+                      static_cast<uint8_t>(std::lround(a.g + (b.g - a.g) * f)),
+                      static_cast<uint8_t>(std::lround(a.b + (b.b - a.b) * f)), 255};
+    }
+    return palette;
+}
+
+// ============================================================================
+// Per-band scale: value -> level 0..255 (-1 for nodata)
+// ============================================================================
+
+struct ImageBandScale {
+    ImageStretch stretch = ImageStretch::LINEAR;
+    double lo = 0.0;
+    double hi = 255.0;
+    std::vector<double> cuts;  // quantile class boundaries (N-1 cut points)
+    bool has_nodata = false;
+    double nodata = 0.0;
+
+    int Level(double v) const {
+        if (std::isnan(v) || (has_nodata && v == nodata)) return -1;
+        double t;
+        if (stretch == ImageStretch::QUANTILE) {
+            // Class index, then the position inside the class
+            size_t i = std::upper_bound(cuts.begin(), cuts.end(), v) - cuts.begin();
+            double a = i == 0 ? lo : cuts[i - 1];
+            double b = i == cuts.size() ? hi : cuts[i];
+            double frac = b > a ? (v - a) / (b - a) : 0.5;
+            frac = std::min(1.0, std::max(0.0, frac));
+            t = (static_cast<double>(i) + frac) / static_cast<double>(cuts.size() + 1);
+        } else {
+            t = hi > lo ? (v - lo) / (hi - lo) : 0.0;
+        }
+        t = std::min(1.0, std::max(0.0, t));
+        return static_cast<int>(std::lround(t * 255.0));
+    }
+};
+
+static ImageBandScale ResolveBandScale(const raquet::RaquetMetadata &meta, int band_index, ImageStretch stretch,
+                                       const ImageStyle &style) {
+    ImageBandScale scale;
+    scale.stretch = stretch;
+    const std::string &name = meta.bands[band_index].first;
+    auto dtype = raquet::parse_dtype(meta.bands[band_index].second);
+    const raquet::BandInfo *info =
+        band_index < static_cast<int>(meta.band_info.size()) ? &meta.band_info[band_index] : nullptr;
+    if (info && info->has_nodata) {
+        scale.has_nodata = true;
+        scale.nodata = info->nodata;
+    }
+    if (stretch == ImageStretch::COLORTABLE) {
+        return scale;  // pixel values index the colortable directly
+    }
+
+    bool has_stats = info && info->stats.has_stats && info->stats.max > info->stats.min;
+    if (has_stats) {
+        scale.lo = info->stats.min;
+        scale.hi = info->stats.max;
+    } else {
+        switch (dtype) {
+            case raquet::BandDataType::UINT8: scale.lo = 0; scale.hi = 255; break;
+            case raquet::BandDataType::INT8: scale.lo = -128; scale.hi = 127; break;
+            case raquet::BandDataType::UINT1: scale.lo = 0; scale.hi = 1; break;
+            case raquet::BandDataType::UINT2: scale.lo = 0; scale.hi = 3; break;
+            case raquet::BandDataType::UINT4: scale.lo = 0; scale.hi = 15; break;
+            default:
+                if (!(style.has_min && style.has_max)) {
+                    throw InvalidInputException(
+                        "ST_AsImage: band '%s' has no statistics in metadata; set min= and max= in the style", name);
+                }
+        }
+    }
+    if (style.has_min) scale.lo = style.min;
+    if (style.has_max) scale.hi = style.max;
+
+    if (stretch == ImageStretch::QUANTILE) {
+        const auto *quantiles = info ? &info->stats.quantiles : nullptr;
+        if (!quantiles || quantiles->empty()) {
+            throw InvalidInputException("ST_AsImage: band '%s' has no quantiles in metadata", name);
+        }
+        if (style.classes > 0) {
+            auto it = quantiles->find(style.classes);
+            if (it == quantiles->end()) {
+                throw InvalidInputException("ST_AsImage: band '%s' has no %d-class quantiles", name, style.classes);
+            }
+            scale.cuts = it->second;
+        } else {
+            scale.cuts = quantiles->rbegin()->second;
+        }
+        std::sort(scale.cuts.begin(), scale.cuts.end());
+    }
+    return scale;
+}
+
+// ============================================================================
+// Renderer: resolved style plus lookup tables, rebuilt when the metadata or
+// style of a row differs from the previous row
+// ============================================================================
+
+// Bands whose raw decoded pixel can index a table (1 or 2 bytes)
+static bool IsLookupType(raquet::BandDataType dtype) {
+    switch (dtype) {
+        case raquet::BandDataType::UINT8:
+        case raquet::BandDataType::INT8:
+        case raquet::BandDataType::UINT16:
+        case raquet::BandDataType::INT16:
+        case raquet::BandDataType::UINT1:
+        case raquet::BandDataType::UINT2:
+        case raquet::BandDataType::UINT4:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// The value a raw 1- or 2-byte pattern stands for
+static double LookupValue(raquet::BandDataType dtype, uint32_t raw) {
+    switch (dtype) {
+        case raquet::BandDataType::INT8: return static_cast<int8_t>(raw);
+        case raquet::BandDataType::INT16: return static_cast<int16_t>(raw);
+        default: return raw;
+    }
+}
+
+struct ImageRenderer {
+    std::string metadata;
+    std::string style_str;
+    raquet::RaquetMetadata meta;  // copied: the parse cache entry only lives for one row
+    ImageStyle style;
+    bool colortable = false;
+    ImagePalette palette;
+    std::vector<int> band_indices;
+    std::vector<raquet::BandDataType> dtypes;
+    std::vector<ImageBandScale> scales;
+    // Single band: RGBA per raw pixel. Multi-band: level per raw pixel (-1 nodata).
+    std::vector<std::vector<std::array<uint8_t, 4>>> color_luts;
+    std::vector<std::vector<int16_t>> level_luts;
+
+    std::array<uint8_t, 4> Color(double v) const {
+        const auto &scale = scales[0];
+        if (colortable) {
+            if (std::isnan(v) || (scale.has_nodata && v == scale.nodata)) return {0, 0, 0, 0};
+            const auto &entries = meta.band_info[band_indices[0]].colortable;
+            if (v < 0 || v >= static_cast<double>(entries.size())) return {0, 0, 0, 0};
+            const auto &e = entries[static_cast<size_t>(v)];
+            return {static_cast<uint8_t>(e[0]), static_cast<uint8_t>(e[1]), static_cast<uint8_t>(e[2]),
+                    static_cast<uint8_t>(e[3])};
+        }
+        int level = scale.Level(v);
+        if (level < 0) return {0, 0, 0, 0};
+        return palette[level];
+    }
+
+    void Build(const std::string &metadata_str, const std::string &style_in, size_t band_count) {
+        metadata = metadata_str;
+        style_str = style_in;
+        meta = raquet::parse_metadata_cached(metadata_str);
+        style = ParseImageStyle(style_in);
+        if (meta.bands.empty()) {
+            throw InvalidInputException("ST_AsImage: metadata has no bands");
+        }
+        if (meta.is_interleaved()) {
+            throw InvalidInputException("ST_AsImage: interleaved band_layout is not supported");
+        }
+
+        band_indices.clear();
+        if (!style.bands.empty()) {
+            if (style.bands.size() != band_count) {
+                throw InvalidInputException("ST_AsImage: style names %d bands for %d band blobs",
+                                            static_cast<int>(style.bands.size()), static_cast<int>(band_count));
+            }
+            for (auto &name : style.bands) {
+                int idx = meta.get_band_index(name);
+                if (idx < 0) {
+                    throw InvalidInputException("ST_AsImage: unknown band '%s'", name);
+                }
+                band_indices.push_back(idx);
+            }
+        } else {
+            if (band_count > meta.bands.size()) {
+                throw InvalidInputException("ST_AsImage: %d band blobs for %d bands in metadata",
+                                            static_cast<int>(band_count), static_cast<int>(meta.bands.size()));
+            }
+            for (size_t b = 0; b < band_count; b++) {
+                band_indices.push_back(static_cast<int>(b));
+            }
+        }
+
+        ImageStretch stretch = style.stretch;
+        if (band_count == 1) {
+            const auto *info = band_indices[0] < static_cast<int>(meta.band_info.size())
+                                   ? &meta.band_info[band_indices[0]]
+                                   : nullptr;
+            bool has_colortable = info && info->has_colortable;
+            if (stretch == ImageStretch::AUTO) {
+                stretch = has_colortable ? ImageStretch::COLORTABLE : ImageStretch::LINEAR;
+            }
+            if (stretch == ImageStretch::COLORTABLE && !has_colortable) {
+                throw InvalidInputException("ST_AsImage: band '%s' has no colortable",
+                                            meta.bands[band_indices[0]].first);
+            }
+            palette = BuildPalette(style.colormap);
+        } else {
+            if (stretch == ImageStretch::COLORTABLE) {
+                throw InvalidInputException("ST_AsImage: colortable needs a single band");
+            }
+            if (stretch == ImageStretch::AUTO) stretch = ImageStretch::LINEAR;
+        }
+        colortable = stretch == ImageStretch::COLORTABLE;
+
+        dtypes.clear();
+        scales.clear();
+        color_luts.assign(band_count, {});
+        level_luts.assign(band_count, {});
+        for (size_t b = 0; b < band_count; b++) {
+            int idx = band_indices[b];
+            dtypes.push_back(raquet::parse_dtype(meta.bands[idx].second));
+            scales.push_back(ResolveBandScale(meta, idx, stretch, style));
+        }
+        for (size_t b = 0; b < band_count; b++) {
+            if (!IsLookupType(dtypes[b])) continue;
+            uint32_t entries = raquet::dtype_size(dtypes[b]) == 1 ? 256u : 65536u;
+            if (band_count == 1) {
+                color_luts[b].resize(entries);
+                for (uint32_t raw = 0; raw < entries; raw++) {
+                    color_luts[b][raw] = Color(LookupValue(dtypes[b], raw));
+                }
+            } else {
+                level_luts[b].resize(entries);
+                for (uint32_t raw = 0; raw < entries; raw++) {
+                    level_luts[b][raw] = static_cast<int16_t>(scales[b].Level(LookupValue(dtypes[b], raw)));
+                }
+            }
+        }
+    }
+};
+
+// Decode a band tile; constant tiles stay one value with pixel_step 0
+static const uint8_t *DecodeImageBand(const string_t &band, const raquet::BandCodec &codec,
+                                      raquet::BandDataType dtype, int width, int height,
+                                      std::vector<uint8_t> &buffer, size_t &data_size, size_t &pixel_step) {
+    auto data = reinterpret_cast<const uint8_t *>(band.GetData());
+    size_t size = band.GetSize();
+    raquet::resolve_tile_ref(data, size, codec);
+    if (raquet::is_constant_tile(data, size, raquet::dtype_size(dtype), codec)) {
+        data_size = raquet::dtype_size(dtype);
+        pixel_step = 0;
+        return raquet::constant_tile_value(data);
+    }
+    pixel_step = 1;
+    return raquet::decode_band_bytes(data, size, codec, raquet::dtype_size(dtype), width, height, 1, buffer,
+                                     data_size);
+}
+
+static inline uint32_t RawPixel(const uint8_t *data, size_t offset, size_t elem) {
+    if (elem == 1) return data[offset];
+    uint16_t raw;
+    std::memcpy(&raw, data + offset * 2, 2);
+    return raw;
+}
+
+static std::vector<uint8_t> RenderImage(const ImageRenderer &renderer, const std::vector<string_t> &bands) {
+    const auto &meta = renderer.meta;
+    int width = meta.block_width;
+    int height = meta.block_height;
+    size_t num_pixels = static_cast<size_t>(width) * height;
+    std::vector<uint8_t> rgba(num_pixels * 4);
+
+    std::vector<std::vector<uint8_t>> buffers(bands.size());
+    std::vector<const uint8_t *> data(bands.size());
+    std::vector<size_t> sizes(bands.size()), steps(bands.size());
+    for (size_t b = 0; b < bands.size(); b++) {
+        data[b] = DecodeImageBand(bands[b], meta.band_codec(renderer.band_indices[b]), renderer.dtypes[b], width,
+                                  height, buffers[b], sizes[b], steps[b]);
+    }
+
+    if (bands.size() == 1) {
+        const auto &lut = renderer.color_luts[0];
+        size_t elem = raquet::dtype_size(renderer.dtypes[0]);
+        for (size_t p = 0; p < num_pixels; p++) {
+            std::array<uint8_t, 4> color =
+                !lut.empty() ? lut[RawPixel(data[0], p * steps[0], elem)]
+                             : renderer.Color(raquet::get_pixel_value(data[0], sizes[0], p * steps[0],
+                                                                      renderer.dtypes[0]));
+            std::memcpy(rgba.data() + p * 4, color.data(), 4);
+        }
+    } else {
+        for (size_t p = 0; p < num_pixels; p++) {
+            uint8_t *out = rgba.data() + p * 4;
+            out[3] = 255;
+            for (size_t b = 0; b < bands.size(); b++) {
+                const auto &lut = renderer.level_luts[b];
+                int level = !lut.empty()
+                                ? lut[RawPixel(data[b], p * steps[b], raquet::dtype_size(renderer.dtypes[b]))]
+                                : renderer.scales[b].Level(
+                                      raquet::get_pixel_value(data[b], sizes[b], p * steps[b], renderer.dtypes[b]));
+                if (level < 0) {
+                    std::memset(out, 0, 4);
+                    break;
+                }
+                out[b] = static_cast<uint8_t>(level);
+            }
+        }
+    }
+
+    if (renderer.style.format == "webp") {
+        return raquet::encode_webp(rgba.data(), width, height, 4, renderer.style.quality);
+    }
+    return raquet::encode_png(rgba.data(), width, height, 4);
+}
+
+static void STAsImageFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    for (idx_t c = 0; c < args.ColumnCount(); c++) {
+        args.data[c].Flatten(args.size());
+    }
+    bool is_list = args.data[0].GetType().id() == LogicalTypeId::LIST;
+    auto metadata_data = FlatVector::GetData<string_t>(args.data[1]);
+    auto &band_validity = FlatVector::Validity(args.data[0]);
+    auto &metadata_validity = FlatVector::Validity(args.data[1]);
+    string_t *style_data = args.ColumnCount() > 2 ? FlatVector::GetData<string_t>(args.data[2]) : nullptr;
+
+    list_entry_t *list_entries = nullptr;
+    string_t *child_data = nullptr;
+    ValidityMask *child_validity = nullptr;
+    string_t *blob_data = nullptr;
+    if (is_list) {
+        list_entries = ListVector::GetData(args.data[0]);
+        auto &child = ListVector::GetEntry(args.data[0]);
+        child.Flatten(ListVector::GetListSize(args.data[0]));
+        child_data = FlatVector::GetData<string_t>(child);
+        child_validity = &FlatVector::Validity(child);
+    } else {
+        blob_data = FlatVector::GetData<string_t>(args.data[0]);
+    }
+
+    auto result_data = FlatVector::GetData<string_t>(result);
+    auto &result_validity = FlatVector::Validity(result);
+
+    ImageRenderer renderer;
+    bool built = false;
+    std::vector<string_t> bands;
+    for (idx_t i = 0; i < args.size(); i++) {
+        if (!band_validity.RowIsValid(i) || !metadata_validity.RowIsValid(i)) {
+            result_validity.SetInvalid(i);
+            continue;
+        }
+        bands.clear();
+        bool missing = false;
+        if (is_list) {
+            auto entry = list_entries[i];
+            if (entry.length < 3 || entry.length > 4) {
+                throw InvalidInputException("ST_AsImage: a band list needs 3 (RGB) or 4 (RGBA) bands, got %d",
+                                            static_cast<int>(entry.length));
+            }
+            for (idx_t k = 0; k < entry.length; k++) {
+                idx_t child_idx = entry.offset + k;
+                if (!child_validity->RowIsValid(child_idx) || child_data[child_idx].GetSize() == 0) {
+                    missing = true;
+                    break;
+                }
+                bands.push_back(child_data[child_idx]);
+            }
+        } else {
+            if (blob_data[i].GetSize() == 0) {
+                missing = true;
+            } else {
+                bands.push_back(blob_data[i]);
+            }
+        }
+        if (missing) {
+            result_validity.SetInvalid(i);
+            continue;
+        }
+
+        // Compared in place, not copied per row: it can carry a tile dictionary
+        auto metadata_str = metadata_data[i];
+        std::string style_str = style_data ? style_data[i].GetString() : std::string();
+        bool same_metadata = renderer.metadata.size() == metadata_str.GetSize() &&
+                             std::memcmp(renderer.metadata.data(), metadata_str.GetData(), metadata_str.GetSize()) == 0;
+        if (!built || !same_metadata || renderer.style_str != style_str ||
+            renderer.band_indices.size() != bands.size()) {
+            renderer.Build(metadata_str.GetString(), style_str, bands.size());
+            built = true;
+        }
+
+        std::vector<uint8_t> image;
+        try {
+            image = RenderImage(renderer, bands);
+        } catch (std::exception &e) {
+            throw InvalidInputException("ST_AsImage: %s", e.what());
+        }
+        result_data[i] = StringVector::AddStringOrBlob(result, reinterpret_cast<const char *>(image.data()),
+                                                       image.size());
+    }
+}
+
+// ============================================================================
+// Function Registration
+// ============================================================================
+
+void RegisterAsImageFunctions(ExtensionLoader &loader) {
+    ScalarFunctionSet as_image_set("ST_AsImage");
+
+    // ST_AsImage(band BLOB, metadata VARCHAR) -> BLOB (PNG, default style)
+    as_image_set.AddFunction(ScalarFunction({LogicalType::BLOB, LogicalType::VARCHAR}, LogicalType::BLOB,
+                                            STAsImageFunction));
+
+    // ST_AsImage(band BLOB, metadata VARCHAR, style VARCHAR) -> BLOB
+    as_image_set.AddFunction(ScalarFunction({LogicalType::BLOB, LogicalType::VARCHAR, LogicalType::VARCHAR},
+                                            LogicalType::BLOB, STAsImageFunction));
+
+    // ST_AsImage(bands BLOB[], metadata VARCHAR, style VARCHAR) -> BLOB (RGB / RGBA)
+    as_image_set.AddFunction(ScalarFunction(
+        {LogicalType::LIST(LogicalType::BLOB), LogicalType::VARCHAR, LogicalType::VARCHAR}, LogicalType::BLOB,
+        STAsImageFunction));
+
+    loader.RegisterFunction(as_image_set);
+}
+
+} // namespace duckdb
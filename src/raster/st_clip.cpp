@@ -3,9 +3,12 @@
 #include "duckdb/function/scalar_function.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
 #include "band_decoder.hpp"
+#include "raquet_metadata.hpp"
 #include "quadbin.hpp"
+#include "raquet_metrics.hpp"
 #include <cmath>
 #include <limits>
+#include <cstdlib>
 #include <cstring>
 #include <string>
 #include "yyjson.hpp"
@@ -248,6 +251,8 @@ static bool ClipExtractGeometryBBox(const string_t &geom, double &min_x, double
 
 struct ClipMetadata {
     std::string compression;
+    int compression_predictor = 1;
+    raquet::BandCodec first_band;  // per-band codec fields (quantization, dictionary) of band 1
     int block_width;
     int block_height;
     std::vector<std::pair<std::string, std::string>> bands;
@@ -274,6 +279,14 @@ struct ClipMetadata {
             meta.compression = yyjson_get_str(compression_val);
         }
 
+        yyjson_val *predictor_val = yyjson_obj_get(root, "compression_predictor");
+        if (predictor_val && yyjson_is_int(predictor_val)) {
+            meta.compression_predictor = yyjson_get_int(predictor_val);
+        }
+
+        yyjson_val *constant_val = yyjson_obj_get(root, "constant_tiles");
+        meta.first_band.constant_tiles = constant_val && yyjson_is_bool(constant_val) && yyjson_get_bool(constant_val);
+
         // v0.3.0: Parse tiling object
         yyjson_val *tiling_val = yyjson_obj_get(root, "tiling");
         if (tiling_val && yyjson_is_obj(tiling_val)) {
@@ -300,6 +313,29 @@ struct ClipMetadata {
                     if (name_val && dtype_val && yyjson_is_str(name_val) && yyjson_is_str(dtype_val)) {
                         meta.bands.emplace_back(yyjson_get_str(name_val), yyjson_get_str(dtype_val));
                     }
+                    if (idx == 0) {
+                        ParseQuantization(band, meta.first_band);
+                        yyjson_val *mask_val = yyjson_obj_get(band, "validity_mask");
+                        meta.first_band.validity_mask =
+                            mask_val && yyjson_is_bool(mask_val) && yyjson_get_bool(mask_val);
+                        yyjson_val *dict_val = yyjson_obj_get(band, "compression_dictionary");
+                        if (dict_val && yyjson_is_str(dict_val)) {
+                            meta.first_band.dictionary = std::make_shared<const std::vector<uint8_t>>(
+                                raquet::base64_decode(yyjson_get_str(dict_val)));
+                        }
+                        yyjson_val *tiles_val = yyjson_obj_get(band, "tile_dictionary");
+                        if (tiles_val && yyjson_is_arr(tiles_val)) {
+                            auto tile_blobs = std::make_shared<std::vector<std::vector<uint8_t>>>();
+                            size_t tidx, tmax;
+                            yyjson_val *tile_val;
+                            yyjson_arr_foreach(tiles_val, tidx, tmax, tile_val) {
+                                if (yyjson_is_str(tile_val)) {
+                                    tile_blobs->push_back(raquet::base64_decode(yyjson_get_str(tile_val)));
+                                }
+                            }
+                            meta.first_band.tile_dictionary = std::move(tile_blobs);
+                        }
+                    }
                 }
             }
         }
@@ -307,6 +343,45 @@ struct ClipMetadata {
         yyjson_doc_free(doc);
         return meta;
     }
+
+    // read_raster(max_error=...) bands: {"quantization":{...}} plus the
+    // band nodata that the nodata code decodes to (NaN when absent).
+    static void ParseQuantization(yyjson_val *band, raquet::BandCodec &out) {
+        yyjson_val *quant_val = yyjson_obj_get(band, "quantization");
+        if (!quant_val || !yyjson_is_obj(quant_val)) {
+            return;
+        }
+        yyjson_val *type_val = yyjson_obj_get(quant_val, "stored_type");
+        if (!type_val || !yyjson_is_str(type_val)) {
+            return;
+        }
+        out.quant_type = yyjson_get_str(type_val);
+        yyjson_val *v = yyjson_obj_get(quant_val, "scale");
+        if (v && yyjson_is_num(v)) out.quant_scale = yyjson_get_num(v);
+        v = yyjson_obj_get(quant_val, "offset");
+        if (v && yyjson_is_num(v)) out.quant_offset = yyjson_get_num(v);
+        v = yyjson_obj_get(quant_val, "nodata_code");
+        if (v && yyjson_is_num(v)) out.quant_nodata_code = static_cast<uint64_t>(yyjson_get_num(v));
+
+        out.quant_nodata = std::numeric_limits<double>::quiet_NaN();
+        yyjson_val *nodata_val = yyjson_obj_get(band, "nodata");
+        if (nodata_val && yyjson_is_num(nodata_val)) {
+            out.quant_nodata = yyjson_get_num(nodata_val);
+        } else if (nodata_val && yyjson_is_str(nodata_val)) {
+            // v0.1.0 quotes nodata ("-9999", "NaN", "Infinity"); strtod reads all of them
+            out.quant_nodata = std::strtod(yyjson_get_str(nodata_val), nullptr);
+        }
+    }
+
+    raquet::BandCodec band_codec() const {
+        raquet::BandCodec codec = first_band;
+        codec.compression = compression.empty() ? "none" : compression;
+        codec.predictor = compression_predictor;
+        if (!bands.empty()) {
+            codec.packed_bits = raquet::packed_bits_of(bands[0].second);
+        }
+        return codec;
+    }
 };
 
 // ============================================================================
@@ -357,7 +432,7 @@ static void STClipFunction(DataChunk &args, ExpressionState &state, Vector &resu
         try {
             auto meta = ClipMetadata::Parse(metadata_str);
             std::string dtype = meta.bands.empty() ? "float32" : meta.bands[0].second;
-            bool compressed = (meta.compression == "gzip");
+            auto codec = meta.band_codec();
             int width = meta.block_width;
             int height = meta.block_height;
 
@@ -384,24 +459,14 @@ static void STClipFunction(DataChunk &args, ExpressionState &state, Vector &resu
                 continue;
             }
 
+            auto band_dtype = raquet::parse_dtype(dtype);
+
             // Decompress band data if needed
-            const uint8_t *raw_data;
             size_t raw_data_size;
             std::vector<uint8_t> decompressed;
-
-            if (compressed) {
-                decompressed = raquet::decompress_gzip(
-                    reinterpret_cast<const uint8_t*>(band.GetData()),
-                    band.GetSize()
-                );
-                raw_data = decompressed.data();
-                raw_data_size = decompressed.size();
-            } else {
-                raw_data = reinterpret_cast<const uint8_t*>(band.GetData());
-                raw_data_size = band.GetSize();
-            }
-
-            auto band_dtype = raquet::parse_dtype(dtype);
+            const uint8_t *raw_data = raquet::decode_band_bytes(
+                reinterpret_cast<const uint8_t*>(band.GetData()), band.GetSize(), codec,
+                raquet::dtype_size(band_dtype), width, height, 1, decompressed, raw_data_size);
 
             // Calculate pixel dimensions
             double pixel_width = (tile_max_lon - tile_min_lon) / width;
@@ -410,6 +475,7 @@ static void STClipFunction(DataChunk &args, ExpressionState &state, Vector &resu
             // Collect pixels inside the clip geometry
             std::vector<double> clipped_values;
             clipped_values.reserve(static_cast<size_t>(width) * height / 4);  // Rough estimate
+            uint64_t pip_tests = 0;
 
             for (int py = 0; py < height; py++) {
                 for (int px = 0; px < width; px++) {
@@ -424,6 +490,7 @@ static void STClipFunction(DataChunk &args, ExpressionState &state, Vector &resu
                     }
 
                     // Check if pixel center is inside clip geometry
+                    pip_tests++;
                     if (ClipPointInGeometry(pixel_lon, pixel_lat, clip_geom)) {
                         size_t offset = static_cast<size_t>(py) * width + px;
                         double value = raquet::get_pixel_value(raw_data, raw_data_size, offset, band_dtype);
@@ -431,6 +498,7 @@ static void STClipFunction(DataChunk &args, ExpressionState &state, Vector &resu
                     }
                 }
             }
+            raquet::metric_add(raquet::Metric::PIP_TESTS, pip_tests);
 
             // Write to result list
             ListVector::Reserve(result, total_list_size + clipped_values.size());
@@ -503,7 +571,7 @@ static void STClipNodataFunction(DataChunk &args, ExpressionState &state, Vector
         try {
             auto meta = ClipMetadata::Parse(metadata_str);
             std::string dtype = meta.bands.empty() ? "float32" : meta.bands[0].second;
-            bool compressed = (meta.compression == "gzip");
+            auto codec = meta.band_codec();
             int width = meta.block_width;
             int height = meta.block_height;
 
@@ -527,29 +595,29 @@ static void STClipNodataFunction(DataChunk &args, ExpressionState &state, Vector
                 continue;
             }
 
-            const uint8_t *raw_data;
-            size_t raw_data_size;
-            std::vector<uint8_t> decompressed;
-
-            if (compressed) {
-                decompressed = raquet::decompress_gzip(
-                    reinterpret_cast<const uint8_t*>(band.GetData()),
-                    band.GetSize()
-                );
-                raw_data = decompressed.data();
-                raw_data_size = decompressed.size();
-            } else {
-                raw_data = reinterpret_cast<const uint8_t*>(band.GetData());
-                raw_data_size = band.GetSize();
+            // Every pixel would be dropped as nodata (NaN never compares equal
+            // here, so only a non-NaN nodata lets the mask decide)
+            if (raquet::tile_all_nodata(reinterpret_cast<const uint8_t *>(band.GetData()), band.GetSize(), codec,
+                                        width, height, !std::isnan(nodata), nodata)) {
+                list_data[i].offset = total_list_size;
+                list_data[i].length = 0;
+                continue;
             }
 
             auto band_dtype = raquet::parse_dtype(dtype);
 
+            size_t raw_data_size;
+            std::vector<uint8_t> decompressed;
+            const uint8_t *raw_data = raquet::decode_band_bytes(
+                reinterpret_cast<const uint8_t*>(band.GetData()), band.GetSize(), codec,
+                raquet::dtype_size(band_dtype), width, height, 1, decompressed, raw_data_size);
+
             double pixel_width = (tile_max_lon - tile_min_lon) / width;
             double pixel_height = (tile_max_lat - tile_min_lat) / height;
 
             std::vector<double> clipped_values;
             clipped_values.reserve(static_cast<size_t>(width) * height / 4);
+            uint64_t pip_tests = 0;
 
             for (int py = 0; py < height; py++) {
                 for (int px = 0; px < width; px++) {
@@ -561,6 +629,7 @@ static void STClipNodataFunction(DataChunk &args, ExpressionState &state, Vector
                         continue;
                     }
 
+                    pip_tests++;
                     if (ClipPointInGeometry(pixel_lon, pixel_lat, clip_geom)) {
                         size_t offset = static_cast<size_t>(py) * width + px;
                         double value = raquet::get_pixel_value(raw_data, raw_data_size, offset, band_dtype);
@@ -572,6 +641,7 @@ static void STClipNodataFunction(DataChunk &args, ExpressionState &state, Vector
                     }
                 }
             }
+            raquet::metric_add(raquet::Metric::PIP_TESTS, pip_tests);
 
             ListVector::Reserve(result, total_list_size + clipped_values.size());
             auto child_data = FlatVector::GetData<double>(ListVector::GetEntry(result));
@@ -643,7 +713,7 @@ static void STClipMaskFunction(DataChunk &args, ExpressionState &state, Vector &
         try {
             auto meta = ClipMetadata::Parse(metadata_str);
             std::string dtype = meta.bands.empty() ? "float32" : meta.bands[0].second;
-            bool compressed = (meta.compression == "gzip");
+            auto codec = meta.band_codec();
             int width = meta.block_width;
             int height = meta.block_height;
             size_t num_pixels = static_cast<size_t>(width) * height;
@@ -657,23 +727,13 @@ static void STClipMaskFunction(DataChunk &args, ExpressionState &state, Vector &
             double clip_min_lon, clip_min_lat, clip_max_lon, clip_max_lat;
             bool has_clip_bbox = ClipExtractGeometryBBox(clip_geom, clip_min_lon, clip_min_lat, clip_max_lon, clip_max_lat);
 
-            const uint8_t *raw_data;
+            auto band_dtype = raquet::parse_dtype(dtype);
+
             size_t raw_data_size;
             std::vector<uint8_t> decompressed;
-
-            if (compressed) {
-                decompressed = raquet::decompress_gzip(
-                    reinterpret_cast<const uint8_t*>(band.GetData()),
-                    band.GetSize()
-                );
-                raw_data = decompressed.data();
-                raw_data_size = decompressed.size();
-            } else {
-                raw_data = reinterpret_cast<const uint8_t*>(band.GetData());
-                raw_data_size = band.GetSize();
-            }
-
-            auto band_dtype = raquet::parse_dtype(dtype);
+            const uint8_t *raw_data = raquet::decode_band_bytes(
+                reinterpret_cast<const uint8_t*>(band.GetData()), band.GetSize(), codec,
+                raquet::dtype_size(band_dtype), width, height, 1, decompressed, raw_data_size);
 
             double pixel_width = (tile_max_lon - tile_min_lon) / width;
             double pixel_height = (tile_max_lat - tile_min_lat) / height;
@@ -687,6 +747,7 @@ static void STClipMaskFunction(DataChunk &args, ExpressionState &state, Vector &
                 tile_max_lon < clip_min_lon || tile_min_lon > clip_max_lon ||
                 tile_max_lat < clip_min_lat || tile_min_lat > clip_max_lat
             );
+            uint64_t pip_tests = 0;
 
             for (int py = 0; py < height; py++) {
                 for (int px = 0; px < width; px++) {
@@ -706,6 +767,9 @@ static void STClipMaskFunction(DataChunk &args, ExpressionState &state, Vector &
                             pixel_lat >= clip_min_lat && pixel_lat <= clip_max_lat
                         );
 
+                        if (in_bbox) {
+                            pip_tests++;
+                        }
                         if (in_bbox && ClipPointInGeometry(pixel_lon, pixel_lat, clip_geom)) {
                             child_data[total_list_size + pixel_idx] = value;
                         } else {
@@ -714,6 +778,7 @@ static void STClipMaskFunction(DataChunk &args, ExpressionState &state, Vector &
                     }
                 }
             }
+            raquet::metric_add(raquet::Metric::PIP_TESTS, pip_tests);
 
             list_data[i].offset = total_list_size;
             list_data[i].length = num_pixels;
@@ -66,7 +66,7 @@ static void STRasterSummaryStatsFunction(DataChunk &args, ExpressionState &state
         auto compression = compression_data[i].GetString();
         auto nodata = nodata_data[i];
 
-        bool compressed = (compression == "gzip");
+        raquet::BandCodec codec(compression);
         // Support NaN as a valid nodata value (Zarr v3 convention)
         bool has_nodata = nodata_validity.RowIsValid(i);
 
@@ -75,7 +75,7 @@ static void STRasterSummaryStatsFunction(DataChunk &args, ExpressionState &state
             auto stats = raquet::compute_band_stats(
                 reinterpret_cast<const uint8_t*>(band.GetData()),
                 band.GetSize(),
-                dtype, width, height, compressed,
+                dtype, width, height, codec,
                 has_nodata, nodata
             );
 
@@ -145,14 +145,14 @@ static void STRasterSummaryStatsSimpleFunction(DataChunk &args, ExpressionState
         auto height = height_data[i];
         auto compression = compression_data[i].GetString();
 
-        bool compressed = (compression == "gzip");
+        raquet::BandCodec codec(compression);
 
         try {
             // Use streaming stats for better performance (avoids allocating full pixel array)
             auto stats = raquet::compute_band_stats(
                 reinterpret_cast<const uint8_t*>(band.GetData()),
                 band.GetSize(),
-                dtype, width, height, compressed,
+                dtype, width, height, codec,
                 false, 0.0  // no nodata filtering
             );
 
@@ -209,9 +209,9 @@ static void STRasterSummaryStatsMetadataFunction(DataChunk &args, ExpressionStat
         }
 
         try {
-            auto meta = raquet::parse_metadata(metadata_data[i].GetString());
+            const auto &meta = raquet::parse_metadata_cached(metadata_data[i].GetData(), metadata_data[i].GetSize());
             std::string dtype = meta.bands.empty() ? "uint8" : meta.bands[0].second;
-            bool compressed = (meta.compression == "gzip");
+            auto codec = meta.band_codec();
 
             // Check for nodata from band_info
             bool has_nodata = !meta.band_info.empty() && meta.band_info[0].has_nodata;
@@ -220,7 +220,7 @@ static void STRasterSummaryStatsMetadataFunction(DataChunk &args, ExpressionStat
             auto stats = raquet::compute_band_stats(
                 reinterpret_cast<const uint8_t*>(band.GetData()),
                 band.GetSize(),
-                dtype, meta.block_width, meta.block_height, compressed,
+                dtype, meta.block_width, meta.block_height, codec,
                 has_nodata, nodata
             );
 
@@ -275,9 +275,9 @@ static void STRasterSummaryStatsMetadataNodataFunction(DataChunk &args, Expressi
         }
 
         try {
-            auto meta = raquet::parse_metadata(metadata_data[i].GetString());
+            const auto &meta = raquet::parse_metadata_cached(metadata_data[i].GetData(), metadata_data[i].GetSize());
             std::string dtype = meta.bands.empty() ? "uint8" : meta.bands[0].second;
-            bool compressed = (meta.compression == "gzip");
+            auto codec = meta.band_codec();
 
             // Use explicit nodata parameter (NULL-aware via validity)
             bool has_nodata = nodata_validity.RowIsValid(i);
@@ -286,7 +286,7 @@ static void STRasterSummaryStatsMetadataNodataFunction(DataChunk &args, Expressi
             auto stats = raquet::compute_band_stats(
                 reinterpret_cast<const uint8_t*>(band.GetData()),
                 band.GetSize(),
-                dtype, meta.block_width, meta.block_height, compressed,
+                dtype, meta.block_width, meta.block_height, codec,
                 has_nodata, nodata
             );
 
@@ -111,7 +111,7 @@ static void RaquetPixelFunction(DataChunk &args, ExpressionState &state, Vector
         auto width = width_data[i];
         auto compression = compression_data[i].GetString();
 
-        bool compressed = (compression == "gzip");
+        raquet::BandCodec codec(compression);
 
         const char* band_ptr = band.GetData();
         idx_t band_size = band.GetSize();
@@ -130,7 +130,7 @@ static void RaquetPixelFunction(DataChunk &args, ExpressionState &state, Vector
             result_data[i] = raquet::decode_pixel(
                 reinterpret_cast<const uint8_t*>(band_ptr),
                 static_cast<size_t>(band_size),
-                dtype, x, y, width, compressed
+                dtype, x, y, width, codec
             );
         } catch (const std::out_of_range &) {
             result_mask.SetInvalid(i);
@@ -169,7 +169,7 @@ static void RaquetDecodeBandFunction(DataChunk &args, ExpressionState &state, Ve
         auto height = height_data[i];
         auto compression = compression_data[i].GetString();
 
-        bool compressed = (compression == "gzip");
+        raquet::BandCodec codec(compression);
 
         // Check for empty band data
         if (band.GetSize() == 0) {
@@ -183,7 +183,7 @@ static void RaquetDecodeBandFunction(DataChunk &args, ExpressionState &state, Ve
             auto values = raquet::decode_band(
                 reinterpret_cast<const uint8_t*>(band.GetData()),
                 band.GetSize(),
-                dtype, width, height, compressed
+                dtype, width, height, codec
             );
 
             // Set list entry
@@ -230,7 +230,7 @@ static void RaquetPixelWithMetadataFunction(DataChunk &args, ExpressionState &st
 
     for (idx_t i = 0; i < args.size(); i++) {
         auto band = band_data[i];
-        auto metadata_str = metadata_data[i].GetString();
+        auto metadata_str = metadata_data[i];
         auto x = x_data[i];
         auto y = y_data[i];
 
@@ -247,7 +247,7 @@ static void RaquetPixelWithMetadataFunction(DataChunk &args, ExpressionState &st
         }
 
         try {
-            auto meta = raquet::parse_metadata(metadata_str);
+            const auto &meta = raquet::parse_metadata_cached(metadata_str.GetData(), metadata_str.GetSize());
 
             // Upper-bound check against tile dimensions
             if (x >= meta.block_width || y >= meta.block_height) {
@@ -256,12 +256,12 @@ static void RaquetPixelWithMetadataFunction(DataChunk &args, ExpressionState &st
             }
 
             std::string dtype = meta.bands.empty() ? "uint8" : meta.bands[0].second;
-            bool compressed = (meta.compression == "gzip");
+            auto codec = meta.band_codec();
 
             result_data[i] = raquet::decode_pixel(
                 reinterpret_cast<const uint8_t*>(band_ptr),
                 static_cast<size_t>(band_size),
-                dtype, x, y, meta.block_width, compressed
+                dtype, x, y, meta.block_width, codec
             );
         } catch (const std::out_of_range &) {
             result_mask.SetInvalid(i);
@@ -289,7 +289,7 @@ static void RaquetPixelWithMetadataAndBandFunction(DataChunk &args, ExpressionSt
 
     for (idx_t i = 0; i < args.size(); i++) {
         auto band = band_data[i];
-        auto metadata_str = metadata_data[i].GetString();
+        auto metadata_str = metadata_data[i];
         auto band_idx = band_idx_data[i];
         auto x = x_data[i];
         auto y = y_data[i];
@@ -307,7 +307,7 @@ static void RaquetPixelWithMetadataAndBandFunction(DataChunk &args, ExpressionSt
         }
 
         try {
-            auto meta = raquet::parse_metadata(metadata_str);
+            const auto &meta = raquet::parse_metadata_cached(metadata_str.GetData(), metadata_str.GetSize());
 
             // Upper-bound check against tile dimensions
             if (x >= meta.block_width || y >= meta.block_height) {
@@ -316,12 +316,12 @@ static void RaquetPixelWithMetadataAndBandFunction(DataChunk &args, ExpressionSt
             }
 
             std::string dtype = meta.get_band_type(band_idx);
-            bool compressed = (meta.compression == "gzip");
+            auto codec = meta.band_codec(band_idx);
 
             result_data[i] = raquet::decode_pixel(
                 reinterpret_cast<const uint8_t*>(band_ptr),
                 static_cast<size_t>(band_size),
-                dtype, x, y, meta.block_width, compressed
+                dtype, x, y, meta.block_width, codec
             );
         } catch (const std::out_of_range &) {
             result_mask.SetInvalid(i);
@@ -377,7 +377,7 @@ static void STRasterValueWithGeometryFunction(DataChunk &args, ExpressionState &
         auto block = block_data[i];
         auto band = band_data[i];
         auto geom = geom_data[i];
-        auto metadata_str = metadata_data[i].GetString();
+        auto metadata_str = metadata_data[i];
 
         if (band.GetSize() == 0) {
             result_mask.SetInvalid(i);
@@ -391,7 +391,7 @@ static void STRasterValueWithGeometryFunction(DataChunk &args, ExpressionState &
         }
 
         try {
-            auto meta = raquet::parse_metadata(metadata_str);
+            const auto &meta = raquet::parse_metadata_cached(metadata_str.GetData(), metadata_str.GetSize());
             std::string dtype = meta.bands.empty() ? "uint8" : meta.bands[0].second;
             int tile_size = meta.block_width;
 
@@ -416,15 +416,15 @@ static void STRasterValueWithGeometryFunction(DataChunk &args, ExpressionState &
                     band.GetSize(),
                     dtype, pixel_x, pixel_y, tile_size,
                     0, meta.num_bands(),
-                    meta.compression
+                    meta.band_codec()
                 );
             } else {
                 // Standard sequential layout
-                bool compressed = (meta.compression == "gzip");
+                auto codec = meta.band_codec();
                 value = raquet::decode_pixel(
                     reinterpret_cast<const uint8_t*>(band.GetData()),
                     band.GetSize(),
-                    dtype, pixel_x, pixel_y, tile_size, compressed
+                    dtype, pixel_x, pixel_y, tile_size, codec
                 );
             }
 
@@ -463,7 +463,7 @@ static void STRasterValueWithGeometryAndBandNameFunction(DataChunk &args, Expres
         auto block = block_data[i];
         auto band = band_data[i];
         auto geom = geom_data[i];
-        auto metadata_str = metadata_data[i].GetString();
+        auto metadata_str = metadata_data[i];
         auto band_name = band_name_data[i].GetString();
 
         if (band.GetSize() == 0) {
@@ -478,7 +478,7 @@ static void STRasterValueWithGeometryAndBandNameFunction(DataChunk &args, Expres
         }
 
         try {
-            auto meta = raquet::parse_metadata(metadata_str);
+            const auto &meta = raquet::parse_metadata_cached(metadata_str.GetData(), metadata_str.GetSize());
 
             // Resolve band name to index
             int band_idx = meta.get_band_index(band_name);
@@ -511,15 +511,15 @@ static void STRasterValueWithGeometryAndBandNameFunction(DataChunk &args, Expres
                     band.GetSize(),
                     dtype, pixel_x, pixel_y, tile_size,
                     band_idx, meta.num_bands(),
-                    meta.compression
+                    meta.band_codec()
                 );
             } else {
                 // Standard sequential layout
-                bool compressed = (meta.compression == "gzip");
+                auto codec = meta.band_codec(band_idx);
                 value = raquet::decode_pixel(
                     reinterpret_cast<const uint8_t*>(band.GetData()),
                     band.GetSize(),
-                    dtype, pixel_x, pixel_y, tile_size, compressed
+                    dtype, pixel_x, pixel_y, tile_size, codec
                 );
             }
 
@@ -559,7 +559,7 @@ static void RaquetPixelInterleavedFunction(DataChunk &args, ExpressionState &sta
 
     for (idx_t i = 0; i < args.size(); i++) {
         auto pixels = pixels_data[i];
-        auto metadata_str = metadata_data[i].GetString();
+        auto metadata_str = metadata_data[i];
         auto band_idx = band_idx_data[i];
         auto x = x_data[i];
         auto y = y_data[i];
@@ -577,7 +577,7 @@ static void RaquetPixelInterleavedFunction(DataChunk &args, ExpressionState &sta
         }
 
         try {
-            auto meta = raquet::parse_metadata(metadata_str);
+            const auto &meta = raquet::parse_metadata_cached(metadata_str.GetData(), metadata_str.GetSize());
             std::string dtype = meta.get_band_type(band_idx);
             int num_bands = meta.num_bands();
 
@@ -586,7 +586,7 @@ static void RaquetPixelInterleavedFunction(DataChunk &args, ExpressionState &sta
                 static_cast<size_t>(pixels_size),
                 dtype, x, y, meta.block_width,
                 band_idx, num_bands,
-                meta.compression
+                meta.band_codec()
             );
 
             if (meta.is_nodata(band_idx, value)) {
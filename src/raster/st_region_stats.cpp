@@ -1,14 +1,19 @@
 #include "duckdb.hpp"
 #include "duckdb/common/exception.hpp"
 #include "duckdb/function/aggregate_function.hpp"
+#include "duckdb/function/scalar_function.hpp"
 #include "duckdb/main/extension/extension_loader.hpp"
 #include "band_decoder.hpp"
 #include "raquet_metadata.hpp"
 #include "quadbin.hpp"
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <cstring>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 namespace duckdb {
 
 // ============================================================================
@@ -323,6 +328,21 @@ static int EstimateAutoResolution(double min_lon, double min_lat, double max_lon
     return min_resolution;  // Fallback to coarsest
 }
 
+// Pick the coarsest level whose pixels are no larger than target_pixel_size
+// (EPSG:3857 metres). At zoom Z a pixel spans 2*pi*R / (2^Z * block_width).
+// Falls back to max_resolution when even the finest level is too coarse.
+static int EstimatePixelSizeResolution(double target_pixel_size, int block_width,
+                                       int min_resolution, int max_resolution) {
+    const double world = 2.0 * quadbin::PI * quadbin::EARTH_RADIUS;
+    for (int z = min_resolution; z <= max_resolution; z++) {
+        double pixel_size = world / (static_cast<double>(1ULL << z) * block_width);
+        if (pixel_size <= target_pixel_size) {
+            return z;
+        }
+    }
+    return max_resolution;
+}
+
 // ============================================================================
 // ST_RegionStats Aggregate State
 // ============================================================================
@@ -369,44 +389,50 @@ static idx_t RegionStatsStateSize(const AggregateFunction &) {
     return sizeof(RegionStatsState);
 }
 
-static void RegionStatsStateInitialize(const AggregateFunction &, data_ptr_t state) {
-    auto &s = *reinterpret_cast<RegionStatsState *>(state);
+static RegionStatsState EmptyRegionStats() {
+    RegionStatsState s;
     s.count = 0;
     s.sum = 0.0;
     s.mean = 0.0;
     s.m2 = 0.0;
     s.min_val = std::numeric_limits<double>::max();
     s.max_val = std::numeric_limits<double>::lowest();
+    return s;
 }
 
-static void RegionStatsCombine(Vector &source, Vector &target, AggregateInputData &aggr_input_data, idx_t count) {
-    auto source_data = FlatVector::GetData<RegionStatsState *>(source);
-    auto target_data = FlatVector::GetData<RegionStatsState *>(target);
+static void RegionStatsStateInitialize(const AggregateFunction &, data_ptr_t state) {
+    *reinterpret_cast<RegionStatsState *>(state) = EmptyRegionStats();
+}
 
-    for (idx_t i = 0; i < count; i++) {
-        auto &src = *source_data[i];
-        auto &tgt = *target_data[i];
+// Parallel Welford's merge of src into tgt
+static void MergeRegionStats(RegionStatsState &tgt, const RegionStatsState &src) {
+    if (src.count == 0) return;
 
-        if (src.count == 0) continue;
+    if (tgt.count == 0) {
+        tgt = src;
+        return;
+    }
 
-        if (tgt.count == 0) {
-            tgt = src;
-            continue;
-        }
+    int64_t combined_count = tgt.count + src.count;
+    double delta = src.mean - tgt.mean;
+    double combined_mean = tgt.mean + delta * src.count / combined_count;
+    double combined_m2 = tgt.m2 + src.m2 + delta * delta * tgt.count * src.count / combined_count;
 
-        // Parallel Welford's merge
-        int64_t combined_count = tgt.count + src.count;
-        double delta = src.mean - tgt.mean;
-        double combined_mean = tgt.mean + delta * src.count / combined_count;
-        double combined_m2 = tgt.m2 + src.m2 + delta * delta * tgt.count * src.count / combined_count;
+    tgt.count = combined_count;
+    tgt.sum += src.sum;
+    tgt.mean = combined_mean;
+    tgt.m2 = combined_m2;
 
-        tgt.count = combined_count;
-        tgt.sum += src.sum;
-        tgt.mean = combined_mean;
-        tgt.m2 = combined_m2;
+    if (src.min_val < tgt.min_val) tgt.min_val = src.min_val;
+    if (src.max_val > tgt.max_val) tgt.max_val = src.max_val;
+}
 
-        if (src.min_val < tgt.min_val) tgt.min_val = src.min_val;
-        if (src.max_val > tgt.max_val) tgt.max_val = src.max_val;
+static void RegionStatsCombine(Vector &source, Vector &target, AggregateInputData &aggr_input_data, idx_t count) {
+    auto source_data = FlatVector::GetData<RegionStatsState *>(source);
+    auto target_data = FlatVector::GetData<RegionStatsState *>(target);
+
+    for (idx_t i = 0; i < count; i++) {
+        MergeRegionStats(*target_data[i], *source_data[i]);
     }
 }
 
@@ -464,7 +490,7 @@ static void ProcessTileForRegionStats(RegionStatsState &state, const string_t &b
     }
 
     std::string dtype = meta.bands[0].second;
-    bool compressed = (meta.compression == "gzip");
+    auto codec = meta.band_codec();
     int width = meta.block_width;
     int height = meta.block_height;
 
@@ -483,27 +509,49 @@ static void ProcessTileForRegionStats(RegionStatsState &state, const string_t &b
         return;
     }
 
-    // Decompress band data if needed
-    const uint8_t *raw_data;
-    size_t raw_data_size;
-    std::vector<uint8_t> decompressed;
+    auto band_dtype = raquet::parse_dtype(dtype);
+    auto band_ptr = reinterpret_cast<const uint8_t*>(band.GetData());
+    size_t band_size = band.GetSize();
+    raquet::resolve_tile_ref(band_ptr, band_size, codec);
 
-    if (compressed) {
-        decompressed = raquet::decompress_gzip(
-            reinterpret_cast<const uint8_t*>(band.GetData()),
-            band.GetSize()
-        );
-        raw_data = decompressed.data();
-        raw_data_size = decompressed.size();
-    } else {
-        raw_data = reinterpret_cast<const uint8_t*>(band.GetData());
-        raw_data_size = band.GetSize();
+    // A validity mask with no valid pixel: nothing to add, nothing to decode
+    if (raquet::tile_all_nodata(band_ptr, band_size, codec, width, height, has_nodata, nodata)) {
+        return;
     }
 
-    auto band_dtype = raquet::parse_dtype(dtype);
-
     // Optimization: Check if region fully contains tile
     bool full_tile = RegionContainsTile(region, tile_min_lon, tile_min_lat, tile_max_lon, tile_max_lat);
+    // RegionContainsTile tests the four tile corners; per-pixel tests are
+    // counted locally and published once per tile.
+    uint64_t pip_tests = 4;
+
+    // A constant tile inside the region folds in as one Welford merge of
+    // width * height copies of its value: no decode, no pixel loop.
+    if (full_tile && raquet::is_constant_tile(band_ptr, band_size, raquet::dtype_size(band_dtype), codec)) {
+        raquet::metric_add(raquet::Metric::PIP_TESTS, pip_tests);
+        double value = raquet::get_pixel_value(raquet::constant_tile_value(band_ptr),
+                                               raquet::dtype_size(band_dtype), 0, band_dtype);
+        if (has_nodata && (value == nodata || (std::isnan(value) && std::isnan(nodata)))) {
+            return;
+        }
+        int64_t n = static_cast<int64_t>(width) * height;
+        int64_t combined_count = state.count + n;
+        double delta = value - state.mean;
+        state.m2 += delta * delta * static_cast<double>(state.count) * n / combined_count;
+        state.mean += delta * n / combined_count;
+        state.count = combined_count;
+        state.sum += value * n;
+        if (value < state.min_val) state.min_val = value;
+        if (value > state.max_val) state.max_val = value;
+        return;
+    }
+
+    // Decompress band data if needed
+    size_t raw_data_size;
+    std::vector<uint8_t> decompressed;
+    const uint8_t *raw_data = raquet::decode_band_bytes(
+        band_ptr, band_size, codec,
+        raquet::dtype_size(band_dtype), width, height, 1, decompressed, raw_data_size);
 
     // Calculate pixel dimensions
     double pixel_width = (tile_max_lon - tile_min_lon) / width;
@@ -518,6 +566,9 @@ static void ProcessTileForRegionStats(RegionStatsState &state, const string_t &b
 
             // Check if pixel is in region
             bool in_region = full_tile || PointInGeometry(pixel_lon, pixel_lat, region);
+            if (!full_tile) {
+                pip_tests++;
+            }
 
             if (in_region) {
                 size_t offset = static_cast<size_t>(py) * width + px;
@@ -542,6 +593,7 @@ static void ProcessTileForRegionStats(RegionStatsState &state, const string_t &b
             }
         }
     }
+    raquet::metric_add(raquet::Metric::PIP_TESTS, pip_tests);
 }
 
 // Update function for 4-argument version
@@ -570,7 +622,7 @@ static void RegionStatsUpdate(Vector inputs[], AggregateInputData &aggr_input_da
         auto &state = *states[i];
 
         try {
-            auto meta = raquet::parse_metadata(metadata_data[i].GetString());
+            const auto &meta = raquet::parse_metadata_cached(metadata_data[i].GetData(), metadata_data[i].GetSize());
             // Default: use max resolution
             int target_res = meta.max_zoom;
             // Auto-detect nodata from metadata band_info
@@ -615,7 +667,7 @@ static void RegionStatsUpdateNodata(Vector inputs[], AggregateInputData &aggr_in
         bool has_nodata = nodata_validity.RowIsValid(i);
 
         try {
-            auto meta = raquet::parse_metadata(metadata_data[i].GetString());
+            const auto &meta = raquet::parse_metadata_cached(metadata_data[i].GetData(), metadata_data[i].GetSize());
             int target_res = meta.max_zoom;
             ProcessTileForRegionStats(state, band_data[i], block_data[i], region_data[i], meta, has_nodata, nodata, target_res);
         } catch (...) {
@@ -671,7 +723,7 @@ static void RegionStatsUpdateResolution(Vector inputs[], AggregateInputData &agg
         auto &state = *states[i];
 
         try {
-            auto meta = raquet::parse_metadata(metadata_data[i].GetString());
+            const auto &meta = raquet::parse_metadata_cached(metadata_data[i].GetData(), metadata_data[i].GetSize());
             std::string res_str = resolution_data[i].GetString();
             int target_res = ComputeTargetResolution(res_str, region_data[i], meta);
             ProcessTileForRegionStats(state, band_data[i], block_data[i], region_data[i], meta, false, 0.0, target_res);
@@ -714,7 +766,7 @@ static void RegionStatsUpdateNodataResolution(Vector inputs[], AggregateInputDat
         bool has_nodata = nodata_validity.RowIsValid(i);
 
         try {
-            auto meta = raquet::parse_metadata(metadata_data[i].GetString());
+            const auto &meta = raquet::parse_metadata_cached(metadata_data[i].GetData(), metadata_data[i].GetSize());
             std::string res_str = resolution_data[i].GetString();
             int target_res = ComputeTargetResolution(res_str, region_data[i], meta);
             ProcessTileForRegionStats(state, band_data[i], block_data[i], region_data[i], meta, has_nodata, nodata, target_res);
@@ -729,6 +781,435 @@ static unique_ptr<FunctionData> RegionStatsBind(ClientContext &context, Aggregat
     return make_uniq<RegionStatsBindData>();
 }
 
+// ============================================================================
+// ST_RegionStatsApprox Aggregate
+// ============================================================================
+//
+// Region stats from the overview pyramid: the interior of the region is
+// answered by coarse tiles, only the boundary band is read at max_zoom.
+// Input is every pyramid level (e.g. read_raquet(file)). Per tile:
+//   - max_zoom, crossing the region edge: exact per-pixel path
+//   - max_zoom, inside the region with its parent inside too: skipped
+//     without decoding once this state has recorded the parent within
+//     tolerance (it, or a coarser tile, answers); otherwise its exact stats
+//     are accumulated per parent cell for Finalize to fall back on
+//   - max_zoom, inside but parent not: exact (full-tile fast path)
+//   - overview zoom, inside the region: tile stats recorded, each pixel
+//     weighted as the 4^(max_zoom - z) native pixels it stands for
+// Finalize starts at the coarsest recorded tiles: a tile whose spread
+// (max - min) / 2 is within tolerance * |mean| answers for its footprint,
+// otherwise its four children do. Below a max_zoom - 1 tile that is too
+// wide, the exact stats of its native tiles answer. Native tiles that no
+// overview answered for (overview levels missing from the input, all
+// nodata, or seen before their parent) count exactly, so every interior
+// pixel is covered once.
+// `error` sums that spread over the native pixels each used overview
+// covers, relative to |sum| - an estimate, not a hard bound.
+// tolerance = 0 reads everything at max_zoom, matching ST_RegionStats.
+
+struct ApproxTileRecord {
+    uint64_t cell;
+    RegionStatsState stats;  // weighted to native pixels
+};
+
+struct RegionStatsApproxState {
+    RegionStatsState exact;
+    std::vector<ApproxTileRecord> *overviews;
+    // Exact stats of interior native tiles, keyed by their parent cell
+    std::unordered_map<uint64_t, RegionStatsState> *natives;
+    // max_zoom - 1 overview tiles recorded within tolerance: their native
+    // tiles need not be read
+    std::unordered_set<uint64_t> *settled;
+    double tolerance;
+    int max_zoom;
+};
+
+static idx_t RegionStatsApproxStateSize(const AggregateFunction &) {
+    return sizeof(RegionStatsApproxState);
+}
+
+static void RegionStatsApproxStateInitialize(const AggregateFunction &function, data_ptr_t state) {
+    auto &s = *reinterpret_cast<RegionStatsApproxState *>(state);
+    RegionStatsStateInitialize(function, reinterpret_cast<data_ptr_t>(&s.exact));
+    s.overviews = nullptr;
+    s.natives = nullptr;
+    s.settled = nullptr;
+    s.tolerance = 0.0;
+    s.max_zoom = 0;
+}
+
+static void RegionStatsApproxDestroy(Vector &state_vector, AggregateInputData &aggr_input_data, idx_t count) {
+    auto states = FlatVector::GetData<RegionStatsApproxState *>(state_vector);
+    for (idx_t i = 0; i < count; i++) {
+        delete states[i]->overviews;
+        states[i]->overviews = nullptr;
+        delete states[i]->natives;
+        states[i]->natives = nullptr;
+        delete states[i]->settled;
+        states[i]->settled = nullptr;
+    }
+}
+
+// An overview tile answers for its footprint when its spread is within tolerance
+static bool WithinTolerance(const RegionStatsState &stats, double tolerance) {
+    return (stats.max_val - stats.min_val) / 2.0 <= tolerance * std::fabs(stats.mean);
+}
+
+// Record an overview tile inside the region: stats of its pixels, each
+// standing for `scale` native pixels.
+static void RecordOverviewTile(RegionStatsApproxState &state, const string_t &band, uint64_t block,
+                               const raquet::RaquetMetadata &meta, bool has_nodata, double nodata, int64_t scale) {
+    auto stats = raquet::compute_band_stats(reinterpret_cast<const uint8_t *>(band.GetData()), band.GetSize(),
+                                            meta.bands[0].second, meta.block_width, meta.block_height,
+                                            meta.band_codec(), has_nodata, nodata);
+    if (stats.count == 0) return;
+
+    ApproxTileRecord record;
+    record.cell = block;
+    record.stats.count = stats.count * scale;
+    record.stats.sum = stats.sum * scale;
+    record.stats.mean = stats.mean;
+    record.stats.m2 = stats.stddev * stats.stddev * static_cast<double>(stats.count - 1) * scale;
+    record.stats.min_val = stats.min;
+    record.stats.max_val = stats.max;
+    if (!state.overviews) {
+        state.overviews = new std::vector<ApproxTileRecord>();
+    }
+    state.overviews->push_back(record);
+    if (quadbin::cell_to_resolution(block) == meta.max_zoom - 1 && WithinTolerance(record.stats, state.tolerance)) {
+        if (!state.settled) {
+            state.settled = new std::unordered_set<uint64_t>();
+        }
+        state.settled->insert(block);
+    }
+}
+
+static void ProcessTileForRegionStatsApprox(RegionStatsApproxState &state, const string_t &band, uint64_t block,
+                                            const string_t &region, const raquet::RaquetMetadata &meta,
+                                            bool has_nodata, double nodata) {
+    if (band.GetSize() == 0 || meta.bands.empty()) return;
+    state.max_zoom = std::max(state.max_zoom, meta.max_zoom);
+
+    int tile_x, tile_y, tile_z;
+    quadbin::cell_to_tile(block, tile_x, tile_y, tile_z);
+    if (tile_z < meta.min_zoom || tile_z > meta.max_zoom) return;
+
+    bool use_overviews = state.tolerance > 0.0 && meta.max_zoom > meta.min_zoom;
+    if (!use_overviews) {
+        ProcessTileForRegionStats(state.exact, band, block, region, meta, has_nodata, nodata, meta.max_zoom);
+        return;
+    }
+
+    double tile_min_lon, tile_min_lat, tile_max_lon, tile_max_lat;
+    quadbin::tile_to_bbox_wgs84(tile_x, tile_y, tile_z, tile_min_lon, tile_min_lat, tile_max_lon, tile_max_lat);
+
+    double region_min_lon, region_min_lat, region_max_lon, region_max_lat;
+    if (!ExtractGeometryBBox(region, region_min_lon, region_min_lat, region_max_lon, region_max_lat)) {
+        return;
+    }
+    if (tile_max_lon < region_min_lon || tile_min_lon > region_max_lon ||
+        tile_max_lat < region_min_lat || tile_min_lat > region_max_lat) {
+        return;
+    }
+
+    bool inside = RegionContainsTile(region, tile_min_lon, tile_min_lat, tile_max_lon, tile_max_lat);
+    raquet::metric_add(raquet::Metric::PIP_TESTS, 4);
+
+    if (tile_z < meta.max_zoom) {
+        if (inside) {
+            RecordOverviewTile(state, band, block, meta, has_nodata, nodata,
+                               int64_t(1) << (2 * (meta.max_zoom - tile_z)));
+        }
+        return;
+    }
+
+    if (inside) {
+        double parent_min_lon, parent_min_lat, parent_max_lon, parent_max_lat;
+        quadbin::tile_to_bbox_wgs84(tile_x >> 1, tile_y >> 1, tile_z - 1,
+                                    parent_min_lon, parent_min_lat, parent_max_lon, parent_max_lat);
+        raquet::metric_add(raquet::Metric::PIP_TESTS, 4);
+        if (RegionContainsTile(region, parent_min_lon, parent_min_lat, parent_max_lon, parent_max_lat)) {
+            uint64_t parent = quadbin::cell_to_parent(block);
+            if (state.settled && state.settled->count(parent)) {
+                return;
+            }
+            if (!state.natives) {
+                state.natives = new std::unordered_map<uint64_t, RegionStatsState>();
+            }
+            auto &group = state.natives->emplace(parent, EmptyRegionStats()).first->second;
+            ProcessTileForRegionStats(group, band, block, region, meta, has_nodata, nodata, meta.max_zoom);
+            return;
+        }
+    }
+    ProcessTileForRegionStats(state.exact, band, block, region, meta, has_nodata, nodata, meta.max_zoom);
+}
+
+// ST_RegionStatsApprox(band, block, region, metadata, tolerance)
+static void RegionStatsApproxUpdate(Vector inputs[], AggregateInputData &aggr_input_data, idx_t input_count,
+                                    Vector &state_vector, idx_t count) {
+    inputs[0].Flatten(count);
+    inputs[1].Flatten(count);
+    inputs[2].Flatten(count);
+    inputs[3].Flatten(count);
+    inputs[4].Flatten(count);
+
+    auto band_data = FlatVector::GetData<string_t>(inputs[0]);
+    auto block_data = FlatVector::GetData<uint64_t>(inputs[1]);
+    auto region_data = FlatVector::GetData<string_t>(inputs[2]);
+    auto metadata_data = FlatVector::GetData<string_t>(inputs[3]);
+    auto tolerance_data = FlatVector::GetData<double>(inputs[4]);
+
+    auto &band_validity = FlatVector::Validity(inputs[0]);
+    auto &region_validity = FlatVector::Validity(inputs[2]);
+    auto &tolerance_validity = FlatVector::Validity(inputs[4]);
+
+    auto states = FlatVector::GetData<RegionStatsApproxState *>(state_vector);
+
+    for (idx_t i = 0; i < count; i++) {
+        if (!band_validity.RowIsValid(i) || !region_validity.RowIsValid(i)) {
+            continue;
+        }
+
+        auto &state = *states[i];
+        double tolerance = tolerance_validity.RowIsValid(i) ? tolerance_data[i] : 0.0;
+        if (!(tolerance >= 0.0)) {
+            throw InvalidInputException("ST_RegionStatsApprox: tolerance must be >= 0, got %f", tolerance);
+        }
+        state.tolerance = tolerance;
+
+        try {
+            const auto &meta = raquet::parse_metadata_cached(metadata_data[i].GetData(), metadata_data[i].GetSize());
+            bool has_nodata = !meta.band_info.empty() && meta.band_info[0].has_nodata;
+            double nodata = has_nodata ? meta.band_info[0].nodata : 0.0;
+            ProcessTileForRegionStatsApprox(state, band_data[i], block_data[i], region_data[i], meta,
+                                            has_nodata, nodata);
+        } catch (...) {
+            continue;
+        }
+    }
+}
+
+static void RegionStatsApproxCombine(Vector &source, Vector &target, AggregateInputData &aggr_input_data,
+                                     idx_t count) {
+    auto source_data = FlatVector::GetData<RegionStatsApproxState *>(source);
+    auto target_data = FlatVector::GetData<RegionStatsApproxState *>(target);
+
+    for (idx_t i = 0; i < count; i++) {
+        auto &src = *source_data[i];
+        auto &tgt = *target_data[i];
+
+        MergeRegionStats(tgt.exact, src.exact);
+        if (src.tolerance > tgt.tolerance) tgt.tolerance = src.tolerance;
+        if (src.max_zoom > tgt.max_zoom) tgt.max_zoom = src.max_zoom;
+        if (src.overviews) {
+            if (!tgt.overviews) {
+                tgt.overviews = new std::vector<ApproxTileRecord>();
+            }
+            tgt.overviews->insert(tgt.overviews->end(), src.overviews->begin(), src.overviews->end());
+        }
+        if (src.natives) {
+            if (!tgt.natives) {
+                tgt.natives = new std::unordered_map<uint64_t, RegionStatsState>();
+            }
+            for (auto &entry : *src.natives) {
+                MergeRegionStats(tgt.natives->emplace(entry.first, EmptyRegionStats()).first->second, entry.second);
+            }
+        }
+        if (src.settled) {
+            if (!tgt.settled) {
+                tgt.settled = new std::unordered_set<uint64_t>();
+            }
+            tgt.settled->insert(src.settled->begin(), src.settled->end());
+        }
+    }
+}
+
+// Fold the overview tile `cell` (or, if its spread is too wide, its
+// children) into `out`, accumulating the spread estimate in `error_sum`.
+// Cells that answered go into `answered`; a max_zoom - 1 tile that is too
+// wide leaves its footprint to the exact stats of its native tiles.
+static void UseOverviewTile(uint64_t cell, const std::unordered_map<uint64_t, RegionStatsState> &tiles,
+                            const std::unordered_map<uint64_t, RegionStatsState> *natives, int max_zoom,
+                            double tolerance, RegionStatsState &out, double &error_sum,
+                            std::unordered_set<uint64_t> &answered) {
+    const auto &stats = tiles.at(cell);
+    if (!WithinTolerance(stats, tolerance)) {
+        if (quadbin::cell_to_resolution(cell) < max_zoom - 1) {
+            uint64_t children[4];
+            quadbin::cell_to_children(cell, children);
+            bool all_present = true;
+            for (auto child : children) {
+                all_present = all_present && tiles.count(child) > 0;
+            }
+            if (all_present) {
+                for (auto child : children) {
+                    UseOverviewTile(child, tiles, natives, max_zoom, tolerance, out, error_sum, answered);
+                }
+                return;
+            }
+        } else if (natives && natives->count(cell)) {
+            return;
+        }
+    }
+    MergeRegionStats(out, stats);
+    error_sum += (stats.max_val - stats.min_val) / 2.0 * static_cast<double>(stats.count);
+    answered.insert(cell);
+}
+
+// True when `cell` or one of its ancestors answered from an overview
+static bool AnsweredByOverview(uint64_t cell, const std::unordered_set<uint64_t> &answered) {
+    while (true) {
+        if (answered.count(cell)) {
+            return true;
+        }
+        if (quadbin::cell_to_resolution(cell) == 0) {
+            return false;
+        }
+        cell = quadbin::cell_to_parent(cell);
+    }
+}
+
+// True when an ancestor of `cell` was recorded; levels in between may be
+// missing (e.g. an empty overview tile), so every level is checked
+static bool HasRecordedAncestor(uint64_t cell, const std::unordered_map<uint64_t, RegionStatsState> &tiles) {
+    while (quadbin::cell_to_resolution(cell) > 0) {
+        cell = quadbin::cell_to_parent(cell);
+        if (tiles.count(cell)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void RegionStatsApproxFinalize(Vector &states, AggregateInputData &aggr_input_data, Vector &result,
+                                      idx_t count, idx_t offset) {
+    auto state_data = FlatVector::GetData<RegionStatsApproxState *>(states);
+    auto &struct_entries = StructVector::GetEntries(result);
+
+    auto count_data = FlatVector::GetData<int64_t>(*struct_entries[0]);
+    auto sum_data = FlatVector::GetData<double>(*struct_entries[1]);
+    auto mean_data = FlatVector::GetData<double>(*struct_entries[2]);
+    auto min_data = FlatVector::GetData<double>(*struct_entries[3]);
+    auto max_data = FlatVector::GetData<double>(*struct_entries[4]);
+    auto stddev_data = FlatVector::GetData<double>(*struct_entries[5]);
+    auto error_data = FlatVector::GetData<double>(*struct_entries[6]);
+
+    auto &result_validity = FlatVector::Validity(result);
+
+    for (idx_t i = 0; i < count; i++) {
+        auto &state = *state_data[i];
+        idx_t result_idx = offset + i;
+
+        RegionStatsState total = state.exact;
+        double error_sum = 0.0;
+        std::unordered_set<uint64_t> answered;
+        if (state.overviews) {
+            std::unordered_map<uint64_t, RegionStatsState> tiles;
+            for (auto &record : *state.overviews) {
+                tiles[record.cell] = record.stats;
+            }
+            // Roots: recorded tiles with no recorded ancestor (outside the
+            // region, or above min_zoom). A tile under a recorded ancestor is
+            // that ancestor's footprint, reached through it or not at all.
+            for (auto &entry : tiles) {
+                if (HasRecordedAncestor(entry.first, tiles)) {
+                    continue;
+                }
+                UseOverviewTile(entry.first, tiles, state.natives, state.max_zoom, state.tolerance, total,
+                                error_sum, answered);
+            }
+        }
+        // Native tiles no overview answered for count exactly
+        if (state.natives) {
+            for (auto &entry : *state.natives) {
+                if (!AnsweredByOverview(entry.first, answered)) {
+                    MergeRegionStats(total, entry.second);
+                }
+            }
+        }
+
+        if (total.count == 0) {
+            result_validity.SetInvalid(result_idx);
+            continue;
+        }
+
+        count_data[result_idx] = total.count;
+        sum_data[result_idx] = total.sum;
+        mean_data[result_idx] = total.sum / total.count;
+        min_data[result_idx] = total.min_val;
+        max_data[result_idx] = total.max_val;
+        stddev_data[result_idx] = total.count > 1 ? std::sqrt(total.m2 / (total.count - 1)) : 0.0;
+        if (error_sum == 0.0) {
+            error_data[result_idx] = 0.0;
+        } else {
+            error_data[result_idx] = total.sum != 0.0 ? error_sum / std::fabs(total.sum)
+                                                      : std::numeric_limits<double>::infinity();
+        }
+    }
+}
+
+// ============================================================================
+// raquet_pick_resolution(metadata, geometry, max_tiles, target_pixel_size) -> INTEGER
+//
+// Pyramid level for a spatial read. With both limits NULL this is max_zoom;
+// target_pixel_size picks the coarsest level fine enough for the requested
+// pixel size; max_tiles caps the level so the geometry's bbox needs at most
+// that many tiles. When both are given the coarser of the two wins. The
+// result is always clamped to [min_zoom, max_zoom].
+// ============================================================================
+
+static void RaquetPickResolutionFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+    auto count = args.size();
+    args.Flatten();
+
+    auto metadata_data = FlatVector::GetData<string_t>(args.data[0]);
+    auto geom_data = FlatVector::GetData<string_t>(args.data[1]);
+    auto tiles_data = FlatVector::GetData<int32_t>(args.data[2]);
+    auto pixel_data = FlatVector::GetData<double>(args.data[3]);
+
+    auto &metadata_validity = FlatVector::Validity(args.data[0]);
+    auto &geom_validity = FlatVector::Validity(args.data[1]);
+    auto &tiles_validity = FlatVector::Validity(args.data[2]);
+    auto &pixel_validity = FlatVector::Validity(args.data[3]);
+
+    result.SetVectorType(VectorType::FLAT_VECTOR);
+    auto result_data = FlatVector::GetData<int32_t>(result);
+    auto &result_validity = FlatVector::Validity(result);
+
+    for (idx_t i = 0; i < count; i++) {
+        if (!metadata_validity.RowIsValid(i)) {
+            result_validity.SetInvalid(i);
+            continue;
+        }
+        const auto &meta = raquet::parse_metadata_cached(metadata_data[i].GetData(), metadata_data[i].GetSize());
+        int res = meta.max_zoom;
+
+        if (pixel_validity.RowIsValid(i)) {
+            double target_pixel_size = pixel_data[i];
+            if (!(target_pixel_size > 0.0)) {
+                throw InvalidInputException("raquet_pick_resolution: target_pixel_size must be positive, got %f",
+                                            target_pixel_size);
+            }
+            res = EstimatePixelSizeResolution(target_pixel_size, meta.block_width, meta.min_zoom, meta.max_zoom);
+        }
+
+        if (tiles_validity.RowIsValid(i)) {
+            int max_tiles = tiles_data[i];
+            if (max_tiles < 1) {
+                throw InvalidInputException("raquet_pick_resolution: max_tiles must be at least 1, got %d", max_tiles);
+            }
+            double min_lon, min_lat, max_lon, max_lat;
+            if (geom_validity.RowIsValid(i) &&
+                ExtractGeometryBBox(geom_data[i], min_lon, min_lat, max_lon, max_lat)) {
+                res = std::min(res, EstimateAutoResolution(min_lon, min_lat, max_lon, max_lat,
+                                                           meta.min_zoom, meta.max_zoom, max_tiles));
+            }
+        }
+
+        result_data[i] = std::max(meta.min_zoom, std::min(res, meta.max_zoom));
+    }
+}
+
 void RegisterRegionStatsFunctions(ExtensionLoader &loader) {
     // Define the stats struct type
     child_list_t<LogicalType> stats_struct;
@@ -804,6 +1285,32 @@ void RegisterRegionStatsFunctions(ExtensionLoader &loader) {
     region_stats_set.AddFunction(region_stats_nodata_resolution);
 
     loader.RegisterFunction(region_stats_set);
+
+    // ST_RegionStatsApprox(band BLOB, block UBIGINT, region GEOMETRY, metadata VARCHAR, tolerance DOUBLE)
+    child_list_t<LogicalType> approx_struct = stats_struct;
+    approx_struct.push_back(make_pair("error", LogicalType::DOUBLE));
+    AggregateFunction region_stats_approx(
+        "ST_RegionStatsApprox",
+        {LogicalType::BLOB, LogicalType::UBIGINT, LogicalType::GEOMETRY(), LogicalType::VARCHAR, LogicalType::DOUBLE},
+        LogicalType::STRUCT(approx_struct),
+        RegionStatsApproxStateSize,
+        RegionStatsApproxStateInitialize,
+        RegionStatsApproxUpdate,
+        RegionStatsApproxCombine,
+        RegionStatsApproxFinalize,
+        FunctionNullHandling::DEFAULT_NULL_HANDLING,
+        nullptr,  // simple_update
+        nullptr,  // bind
+        RegionStatsApproxDestroy
+    );
+    loader.RegisterFunction(region_stats_approx);
+
+    // raquet_pick_resolution(metadata VARCHAR, geometry GEOMETRY, max_tiles INTEGER, target_pixel_size DOUBLE)
+    ScalarFunction pick_resolution_fn("raquet_pick_resolution",
+        {LogicalType::VARCHAR, LogicalType::GEOMETRY(), LogicalType::INTEGER, LogicalType::DOUBLE},
+        LogicalType::INTEGER, RaquetPickResolutionFunction);
+    pick_resolution_fn.null_handling = FunctionNullHandling::SPECIAL_HANDLING;
+    loader.RegisterFunction(pick_resolution_fn);
 }
 
 } // namespace duckdb
@@ -0,0 +1,175 @@
+#include "tiff_writer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace duckdb {
+namespace raquet {
+
+namespace {
+
+enum TiffType : uint16_t { ASCII = 2, SHORT = 3, LONG = 4, DOUBLE = 12, LONG8 = 16 };
+
+struct TiffEntry {
+    uint16_t tag;
+    uint16_t type;
+    uint64_t count;
+    std::vector<uint8_t> data;  // little-endian values
+};
+
+template <typename T>
+void AppendLE(std::vector<uint8_t> &out, T value) {
+    uint8_t bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));  // the exporter only targets little-endian hosts
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+void WriteLE(std::vector<uint8_t> &out, size_t pos, T value) {
+    std::memcpy(out.data() + pos, &value, sizeof(T));
+}
+
+void AddShorts(std::vector<TiffEntry> &entries, uint16_t tag, const std::vector<uint16_t> &values) {
+    TiffEntry e{tag, SHORT, values.size(), {}};
+    for (auto v : values) AppendLE(e.data, v);
+    entries.push_back(std::move(e));
+}
+
+void AddLong(std::vector<TiffEntry> &entries, uint16_t tag, uint32_t value) {
+    TiffEntry e{tag, LONG, 1, {}};
+    AppendLE(e.data, value);
+    entries.push_back(std::move(e));
+}
+
+void AddOffsets(std::vector<TiffEntry> &entries, uint16_t tag, const std::vector<uint64_t> &values, bool bigtiff) {
+    TiffEntry e{tag, static_cast<uint16_t>(bigtiff ? LONG8 : LONG), values.size(), {}};
+    for (auto v : values) {
+        if (bigtiff) {
+            AppendLE(e.data, v);
+        } else {
+            if (v > UINT32_MAX) throw std::out_of_range("TIFF offset exceeds 4 GiB; use BigTIFF");
+            AppendLE(e.data, static_cast<uint32_t>(v));
+        }
+    }
+    entries.push_back(std::move(e));
+}
+
+void AddDoubles(std::vector<TiffEntry> &entries, uint16_t tag, const std::vector<double> &values) {
+    TiffEntry e{tag, DOUBLE, values.size(), {}};
+    for (auto v : values) AppendLE(e.data, v);
+    entries.push_back(std::move(e));
+}
+
+void AddAscii(std::vector<TiffEntry> &entries, uint16_t tag, const std::string &value) {
+    TiffEntry e{tag, ASCII, value.size() + 1, {}};
+    e.data.assign(value.begin(), value.end());
+    e.data.push_back(0);
+    entries.push_back(std::move(e));
+}
+
+std::vector<TiffEntry> BuildEntries(const TiffImage &image, bool bigtiff) {
+    if (image.tile_offsets.size() != image.TileCount() || image.tile_byte_counts.size() != image.TileCount()) {
+        throw std::invalid_argument("TIFF tile offset arrays do not match the tile grid");
+    }
+    std::vector<TiffEntry> entries;
+    AddLong(entries, 254, image.overview ? 1 : 0);  // NewSubfileType
+    AddLong(entries, 256, image.width);              // ImageWidth
+    AddLong(entries, 257, image.height);             // ImageLength
+    AddShorts(entries, 258, std::vector<uint16_t>(image.samples_per_pixel, image.bits_per_sample));
+    AddShorts(entries, 259, {image.compression});
+    AddShorts(entries, 262, {image.photometric});
+    AddShorts(entries, 277, {image.samples_per_pixel});
+    AddShorts(entries, 284, {image.planar_config});
+    if (image.predictor > 1) {
+        AddShorts(entries, 317, {image.predictor});
+    }
+    AddLong(entries, 322, image.tile_width);   // TileWidth
+    AddLong(entries, 323, image.tile_height);  // TileLength
+    AddOffsets(entries, 324, image.tile_offsets, bigtiff);
+    AddOffsets(entries, 325, image.tile_byte_counts, bigtiff);
+    if (!image.extra_samples.empty()) {
+        AddShorts(entries, 338, image.extra_samples);
+    }
+    AddShorts(entries, 339, std::vector<uint16_t>(image.samples_per_pixel, image.sample_format));
+    if (!image.model_pixel_scale.empty()) {
+        AddDoubles(entries, 33550, image.model_pixel_scale);
+    }
+    if (!image.model_tiepoint.empty()) {
+        AddDoubles(entries, 33922, image.model_tiepoint);
+    }
+    if (!image.geo_key_directory.empty()) {
+        AddShorts(entries, 34735, image.geo_key_directory);
+    }
+    if (!image.gdal_nodata.empty()) {
+        AddAscii(entries, 42113, image.gdal_nodata);
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const TiffEntry &a, const TiffEntry &b) { return a.tag < b.tag; });
+    return entries;
+}
+
+} // namespace
+
+std::vector<uint8_t> serialize_tiff_directories(const std::vector<TiffImage> &images, bool bigtiff) {
+    const size_t inline_size = bigtiff ? 8 : 4;
+    const size_t entry_size = bigtiff ? 20 : 12;
+    const size_t count_size = bigtiff ? 8 : 2;
+
+    std::vector<uint8_t> out;
+    out.push_back('I');
+    out.push_back('I');
+    AppendLE<uint16_t>(out, bigtiff ? 43 : 42);
+    size_t first_ifd_slot;
+    if (bigtiff) {
+        AppendLE<uint16_t>(out, 8);  // offset size
+        AppendLE<uint16_t>(out, 0);
+        first_ifd_slot = out.size();
+        AppendLE<uint64_t>(out, 0);
+    } else {
+        first_ifd_slot = out.size();
+        AppendLE<uint32_t>(out, 0);
+    }
+
+    size_t next_slot = first_ifd_slot;
+    for (const auto &image : images) {
+        auto entries = BuildEntries(image, bigtiff);
+        size_t ifd_pos = out.size();
+        if (bigtiff) {
+            WriteLE<uint64_t>(out, next_slot, ifd_pos);
+        } else {
+            WriteLE<uint32_t>(out, next_slot, static_cast<uint32_t>(ifd_pos));
+        }
+
+        // IFD: count, entries, next-IFD slot; out-of-line values follow it
+        size_t ifd_size = count_size + entries.size() * entry_size + inline_size;
+        size_t data_pos = ifd_pos + ifd_size;
+        if (bigtiff) AppendLE<uint64_t>(out, entries.size());
+        else AppendLE<uint16_t>(out, static_cast<uint16_t>(entries.size()));
+        std::vector<uint8_t> overflow;
+        for (const auto &e : entries) {
+            AppendLE<uint16_t>(out, e.tag);
+            AppendLE<uint16_t>(out, e.type);
+            if (bigtiff) AppendLE<uint64_t>(out, e.count);
+            else AppendLE<uint32_t>(out, static_cast<uint32_t>(e.count));
+            if (e.data.size() <= inline_size) {
+                out.insert(out.end(), e.data.begin(), e.data.end());
+                out.insert(out.end(), inline_size - e.data.size(), 0);
+            } else {
+                size_t pos = data_pos + overflow.size();
+                if (bigtiff) AppendLE<uint64_t>(out, pos);
+                else AppendLE<uint32_t>(out, static_cast<uint32_t>(pos));
+                overflow.insert(overflow.end(), e.data.begin(), e.data.end());
+                if (overflow.size() % 2) overflow.push_back(0);  // values start on a word boundary
+            }
+        }
+        next_slot = out.size();
+        if (bigtiff) AppendLE<uint64_t>(out, 0);
+        else AppendLE<uint32_t>(out, 0);
+        out.insert(out.end(), overflow.begin(), overflow.end());
+    }
+    return out;
+}
+
+} // namespace raquet
+} // namespace duckdb
@@ -0,0 +1,192 @@
+#include "raquet_metrics.hpp"
+
+#include "duckdb.hpp"
+#include "duckdb/common/exception.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+
+#include <mutex>
+#include <vector>
+
+namespace duckdb {
+namespace raquet {
+
+// ─────────────────────────────────────────────
+// Registry of live per-thread counter blocks.
+//
+// Leaked on purpose: thread_local ThreadMetrics destructors on the main
+// thread can run during process teardown, and must still find a valid
+// registry to fold their totals into.
+// ─────────────────────────────────────────────
+struct MetricsRegistry {
+    std::mutex lock;
+    std::vector<ThreadMetrics *> live;
+    uint64_t retired[METRIC_COUNT] = {};   // totals from exited threads
+    uint64_t baseline[METRIC_COUNT] = {};  // totals at last metrics_reset()
+};
+
+static MetricsRegistry &GetRegistry() {
+    static MetricsRegistry *registry = new MetricsRegistry();
+    return *registry;
+}
+
+static void SumLocked(MetricsRegistry &reg, uint64_t out[METRIC_COUNT]) {
+    for (size_t i = 0; i < METRIC_COUNT; i++) {
+        out[i] = reg.retired[i];
+    }
+    for (auto *tm : reg.live) {
+        for (size_t i = 0; i < METRIC_COUNT; i++) {
+            out[i] += tm->values[i].load(std::memory_order_relaxed);
+        }
+    }
+}
+
+ThreadMetrics::ThreadMetrics() {
+    for (auto &v : values) {
+        v.store(0, std::memory_order_relaxed);
+    }
+    auto &reg = GetRegistry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    reg.live.push_back(this);
+}
+
+ThreadMetrics::~ThreadMetrics() {
+    auto &reg = GetRegistry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    for (size_t i = 0; i < METRIC_COUNT; i++) {
+        reg.retired[i] += values[i].load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < reg.live.size(); i++) {
+        if (reg.live[i] == this) {
+            reg.live[i] = reg.live.back();
+            reg.live.pop_back();
+            break;
+        }
+    }
+}
+
+ThreadMetrics &thread_metrics() {
+    static thread_local ThreadMetrics metrics;
+    return metrics;
+}
+
+std::vector<uint64_t> metrics_snapshot() {
+    auto &reg = GetRegistry();
+    uint64_t totals[METRIC_COUNT];
+    std::vector<uint64_t> result(METRIC_COUNT);
+    std::lock_guard<std::mutex> guard(reg.lock);
+    SumLocked(reg, totals);
+    for (size_t i = 0; i < METRIC_COUNT; i++) {
+        result[i] = totals[i] >= reg.baseline[i] ? totals[i] - reg.baseline[i] : 0;
+    }
+    return result;
+}
+
+void metrics_reset() {
+    auto &reg = GetRegistry();
+    std::lock_guard<std::mutex> guard(reg.lock);
+    SumLocked(reg, reg.baseline);
+}
+
+const char *metric_name(Metric m) {
+    switch (m) {
+        case Metric::TILES_DECODED:        return "tiles_decoded";
+        case Metric::COMPRESSED_BYTES:     return "compressed_bytes";
+        case Metric::DECOMPRESSED_BYTES:   return "decompressed_bytes";
+        case Metric::DECODE_NS:            return "decode_ns";
+        case Metric::METADATA_PARSES:      return "metadata_parses";
+        case Metric::METADATA_CACHE_HITS:  return "metadata_cache_hits";
+        case Metric::PIP_TESTS:            return "pip_tests";
+        case Metric::TILES_SKIPPED_SPARSE: return "tiles_skipped_sparse";
+        case Metric::WARP_NS:              return "warp_ns";
+        case Metric::COMPRESS_NS:          return "compress_ns";
+        case Metric::INIT_NS:              return "init_ns";
+    }
+    return "unknown";
+}
+
+const char *metric_unit(Metric m) {
+    switch (m) {
+        case Metric::COMPRESSED_BYTES:
+        case Metric::DECOMPRESSED_BYTES:
+            return "bytes";
+        case Metric::DECODE_NS:
+        case Metric::WARP_NS:
+        case Metric::COMPRESS_NS:
+        case Metric::INIT_NS:
+            return "ns";
+        default:
+            return "count";
+    }
+}
+
+} // namespace raquet
+
+// ─────────────────────────────────────────────
+// raquet_metrics([reset := false])
+//   -> TABLE(metric VARCHAR, value BIGINT, unit VARCHAR)
+//
+// One row per counter, summed over every thread since the last reset.
+// With reset := true the baseline moves to the values just returned, so
+// the next call reports only work done in between:
+//
+//   SELECT * FROM raquet_metrics(reset := true);   -- start a window
+//   SELECT ST_RasterSummaryStats(band_1, metadata) FROM read_raquet('f.parquet');
+//   SELECT * FROM raquet_metrics();                -- work done by that query
+// ─────────────────────────────────────────────
+struct RaquetMetricsBindData : public TableFunctionData {
+    bool reset = false;
+};
+
+struct RaquetMetricsGlobalState : public GlobalTableFunctionState {
+    std::vector<uint64_t> values;
+    idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> RaquetMetricsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                  vector<LogicalType> &return_types, vector<string> &names) {
+    auto bind_data = make_uniq<RaquetMetricsBindData>();
+    for (auto &kv : input.named_parameters) {
+        if (kv.first == "reset") {
+            bind_data->reset = !kv.second.IsNull() && kv.second.GetValue<bool>();
+        }
+    }
+    names.push_back("metric");  return_types.push_back(LogicalType::VARCHAR);
+    names.push_back("value");   return_types.push_back(LogicalType::BIGINT);
+    names.push_back("unit");    return_types.push_back(LogicalType::VARCHAR);
+    return std::move(bind_data);
+}
+
+static unique_ptr<GlobalTableFunctionState> RaquetMetricsInitGlobal(ClientContext &context,
+                                                                    TableFunctionInitInput &input) {
+    auto &bind_data = input.bind_data->Cast<RaquetMetricsBindData>();
+    auto state = make_uniq<RaquetMetricsGlobalState>();
+    state->values = raquet::metrics_snapshot();
+    if (bind_data.reset) {
+        raquet::metrics_reset();
+    }
+    return std::move(state);
+}
+
+static void RaquetMetricsExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &state = data.global_state->Cast<RaquetMetricsGlobalState>();
+    idx_t row = 0;
+    while (state.offset < state.values.size() && row < STANDARD_VECTOR_SIZE) {
+        auto m = static_cast<raquet::Metric>(state.offset);
+        output.SetValue(0, row, Value(raquet::metric_name(m)));
+        output.SetValue(1, row, Value::BIGINT(static_cast<int64_t>(state.values[state.offset])));
+        output.SetValue(2, row, Value(raquet::metric_unit(m)));
+        state.offset++;
+        row++;
+    }
+    output.SetCardinality(row);
+}
+
+void RegisterMetricsFunctions(ExtensionLoader &loader) {
+    TableFunction metrics_fn("raquet_metrics", {}, RaquetMetricsExecute,
+                             RaquetMetricsBind, RaquetMetricsInitGlobal);
+    metrics_fn.named_parameters["reset"] = LogicalType::BOOLEAN;
+    loader.RegisterFunction(metrics_fn);
+}
+
+} // namespace duckdb
@@ -0,0 +1,556 @@
+#include "raquet_relayout.hpp"
+#include "band_decoder.hpp"
+#include "band_encoder.hpp"
+#include "band_interleave.hpp"
+#include "raquet_metadata.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/connection.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/main/query_result.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace duckdb {
+
+// SQL single-quote escape — apostrophes inside the path are doubled.
+static std::string RelayoutSingleQuote(const std::string &s) {
+    std::string out = "'";
+    for (char c : s) {
+        if (c == '\'') out += "''";
+        else out += c;
+    }
+    return out + "'";
+}
+
+// SQL identifier quote — embedded double quotes are doubled.
+static std::string RelayoutDoubleQuote(const std::string &s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"') out += "\"\"";
+        else out += c;
+    }
+    return out + "\"";
+}
+
+// ─────────────────────────────────────────────
+// Bind / global state
+// ─────────────────────────────────────────────
+struct RaquetRelayoutBindData : public TableFunctionData {
+    std::string raster_path;
+    raquet::RaquetMetadata meta;       // input
+    std::string output_metadata;       // rewritten JSON for the block=0 row
+    bool interleaved_out = false;
+    std::string compression;
+    int quality = 85;
+    int predictor = 1;
+    std::vector<raquet::BandDataType> dtypes;
+    std::vector<int> packed_bits;
+    std::string scan_sql;
+};
+
+// One re-encoded data row
+struct RelayoutRow {
+    uint64_t block = 0;
+    std::vector<std::vector<uint8_t>> columns;
+    std::vector<bool> valid;
+};
+
+// The scan is shared: every thread takes the next chunk of rows under
+// `lock` and re-encodes it on its own (see RaquetRelayoutLocalState).
+// Chunks are numbered in scan order as batch indices, so order-preserving
+// sinks (COPY, LIMIT) keep the metadata row first and the scan order.
+struct RaquetRelayoutGlobalState : public GlobalTableFunctionState {
+    // Connection must outlive `result`; the scan streams from it.
+    std::unique_ptr<Connection> connection;
+    duckdb::unique_ptr<QueryResult> result;
+    std::mutex lock;  // guards fetches from `result` and the fields below
+    idx_t next_batch = 0;
+    bool metadata_emitted = false;
+    bool finished = false;
+
+    idx_t MaxThreads() const override { return GlobalTableFunctionState::MAX_THREADS; }
+};
+
+static bool RelayoutIsFloat(raquet::BandDataType dtype) {
+    return dtype == raquet::BandDataType::FLOAT16 || dtype == raquet::BandDataType::FLOAT32 ||
+           dtype == raquet::BandDataType::FLOAT64;
+}
+
+static unique_ptr<FunctionData> RaquetRelayoutBind(ClientContext &context, TableFunctionBindInput &input,
+                                                   vector<LogicalType> &return_types, vector<string> &names) {
+    if (input.inputs[0].IsNull()) {
+        throw InvalidInputException("raquet_relayout: raster path cannot be NULL");
+    }
+    auto bind_data = make_uniq<RaquetRelayoutBindData>();
+    bind_data->raster_path = input.inputs[0].GetValue<std::string>();
+
+    Connection con(*context.db);
+    auto meta_result = con.Query("SELECT metadata FROM read_parquet(" + RelayoutSingleQuote(bind_data->raster_path) +
+                                 ") WHERE block = 0 LIMIT 1");
+    if (meta_result->HasError()) {
+        throw InvalidInputException("raquet_relayout: failed to read metadata from '%s': %s",
+                                    bind_data->raster_path, meta_result->GetError());
+    }
+    auto meta_chunk = meta_result->Fetch();
+    if (!meta_chunk || meta_chunk->size() == 0 || meta_chunk->GetValue(0, 0).IsNull()) {
+        throw InvalidInputException("raquet_relayout: '%s' has no metadata row (block=0)", bind_data->raster_path);
+    }
+    auto json = meta_chunk->GetValue(0, 0).GetValue<std::string>();
+    bind_data->meta = raquet::parse_metadata(json);
+    const auto &meta = bind_data->meta;
+    if (meta.block_width <= 0 || meta.block_height <= 0 || meta.bands.empty()) {
+        throw InvalidInputException("raquet_relayout: '%s' has no block size or bands in its metadata",
+                                    bind_data->raster_path);
+    }
+
+    // Defaults: keep whatever is not asked to change
+    bind_data->interleaved_out = meta.is_interleaved();
+    bind_data->compression = meta.compression.empty() ? "none" : meta.compression;
+    bind_data->quality = meta.compression_quality > 0 ? meta.compression_quality : 85;
+    bool predictor_given = false;
+    for (auto &kv : input.named_parameters) {
+        if (kv.second.IsNull()) continue;
+        if (kv.first == "band_layout") {
+            auto layout = StringUtil::Lower(kv.second.GetValue<std::string>());
+            if (layout != "sequential" && layout != "interleaved") {
+                throw InvalidInputException("raquet_relayout: band_layout must be 'sequential' or 'interleaved'");
+            }
+            bind_data->interleaved_out = layout == "interleaved";
+        } else if (kv.first == "compression") {
+            bind_data->compression = StringUtil::Lower(kv.second.GetValue<std::string>());
+            if (bind_data->compression != "none" && bind_data->compression != "gzip" &&
+                bind_data->compression != "zstd" && bind_data->compression != "lz4" &&
+                bind_data->compression != "auto" && bind_data->compression != "jpeg" &&
+                bind_data->compression != "webp") {
+                throw InvalidInputException("raquet_relayout: unknown compression '%s' "
+                                            "(use none, gzip, zstd, lz4, auto, jpeg, webp)",
+                                            bind_data->compression);
+            }
+        } else if (kv.first == "quality") {
+            bind_data->quality = kv.second.GetValue<int32_t>();
+            if (bind_data->quality < 1 || bind_data->quality > 100) {
+                throw InvalidInputException("raquet_relayout: quality must be between 1 and 100");
+            }
+        } else if (kv.first == "predictor") {
+            bind_data->predictor = kv.second.GetValue<int32_t>();
+            if (bind_data->predictor < 1 || bind_data->predictor > 3) {
+                throw InvalidInputException(
+                    "raquet_relayout: predictor must be 1 (none), 2 (horizontal differencing) or 3 (floating point)");
+            }
+            predictor_given = true;
+        }
+    }
+    const auto &compression = bind_data->compression;
+    bool byte_codec = compression == "gzip" || compression == "zstd" || compression == "lz4";
+    if (!predictor_given) {
+        // The file's predictor carries over when the codec still takes one
+        bind_data->predictor = byte_codec && !meta.is_lossy_compression() ? meta.compression_predictor : 1;
+    } else if (bind_data->predictor != 1 && !byte_codec) {
+        throw InvalidInputException("raquet_relayout: predictor=%d requires compression 'gzip', 'zstd' or 'lz4' "
+                                    "(got '%s')",
+                                    bind_data->predictor, compression);
+    }
+#ifndef RAQUET_HAS_ZSTD
+    if (compression == "zstd") {
+        throw InvalidInputException("raquet_relayout: compression='zstd' is not available: extension built without zstd");
+    }
+#endif
+#ifndef RAQUET_HAS_LZ4
+    if (compression == "lz4") {
+        throw InvalidInputException("raquet_relayout: compression='lz4' is not available: extension built without lz4");
+    }
+#endif
+
+    for (const auto &band : meta.bands) {
+        bind_data->dtypes.push_back(raquet::parse_dtype(band.second));
+        bind_data->packed_bits.push_back(raquet::packed_bits_of(band.second));
+    }
+    const size_t band_count = meta.bands.size();
+    if (bind_data->interleaved_out) {
+        for (size_t b = 0; b < band_count; b++) {
+            if (meta.bands[b].second != meta.bands[0].second) {
+                throw InvalidInputException("raquet_relayout: band_layout 'interleaved' needs bands of one type "
+                                            "('%s' is %s, '%s' is %s)",
+                                            meta.bands[0].first, meta.bands[0].second, meta.bands[b].first,
+                                            meta.bands[b].second);
+            }
+            if (bind_data->packed_bits[b] > 0) {
+                throw InvalidInputException("raquet_relayout: %s bands cannot be interleaved", meta.bands[b].second);
+            }
+        }
+    }
+    if (compression == "jpeg" || compression == "webp") {
+        if (!bind_data->interleaved_out) {
+            throw InvalidInputException("raquet_relayout: compression '%s' requires band_layout 'interleaved'",
+                                        compression);
+        }
+        if (meta.bands[0].second != "uint8") {
+            throw InvalidInputException("raquet_relayout: compression '%s' requires uint8 bands (got %s)",
+                                        compression, meta.bands[0].second);
+        }
+        bool channels_ok = compression == "jpeg" ? (band_count == 1 || band_count == 3)
+                                                 : (band_count == 3 || band_count == 4);
+        if (!channels_ok) {
+            throw InvalidInputException("raquet_relayout: compression '%s' takes %s bands, the raster has %d",
+                                        compression, compression == "jpeg" ? "1 or 3" : "3 or 4",
+                                        static_cast<int>(band_count));
+        }
+    }
+
+    // Rewrite the metadata: new layout and codec; quantization, dictionaries
+    // and validity masks belong to the old encoding and are dropped, as are
+    // tile statistics columns (the scan does not carry them)
+    raquet::RaquetMetadata out = meta;
+    out.compression = compression;
+    out.compression_quality = (compression == "jpeg" || compression == "webp") ? bind_data->quality : 0;
+    out.compression_predictor = bind_data->predictor;
+    out.band_layout = bind_data->interleaved_out ? "interleaved" : "sequential";
+    out.constant_tiles = !bind_data->interleaved_out;  // uniform sequential bands are written as constant tiles
+    out.tile_statistics = false;
+    out.tile_statistics_columns.clear();
+    for (auto &bi : out.band_info) {
+        bi.quantization = raquet::BandInfo::Quantization();
+        bi.compression_dictionary.reset();
+        bi.tile_dictionary.reset();
+        bi.validity_mask = false;
+    }
+    // Same serializer as the input (v0.5.0 nests tile geometry under "tiling")
+    bind_data->output_metadata = json.find("\"tiling\"") != std::string::npos ? out.to_json() : out.to_json_v0();
+
+    std::string columns;
+    if (meta.is_interleaved()) {
+        columns = ", pixels";
+    } else {
+        for (const auto &band : meta.bands) {
+            columns += ", " + RelayoutDoubleQuote(band.first);
+        }
+    }
+    bind_data->scan_sql = "SELECT block" + columns + " FROM read_parquet(" +
+                          RelayoutSingleQuote(bind_data->raster_path) + ") WHERE block != 0";
+
+    names.push_back("block");    return_types.push_back(LogicalType::UBIGINT);
+    names.push_back("metadata"); return_types.push_back(LogicalType::VARCHAR);
+    if (bind_data->interleaved_out) {
+        names.push_back("pixels");
+        return_types.push_back(LogicalType::BLOB);
+    } else {
+        for (const auto &band : meta.bands) {
+            names.push_back(band.first);
+            return_types.push_back(LogicalType::BLOB);
+        }
+    }
+    return std::move(bind_data);
+}
+
+// ─────────────────────────────────────────────
+// Per-tile work: decode the input row once into pixel planes (or one
+// interleaved buffer), convert between layouts, re-encode
+// ─────────────────────────────────────────────
+struct RelayoutScratch {
+    std::vector<std::vector<uint8_t>> decode;  // per band decode scratch
+    std::vector<std::vector<uint8_t>> planes;  // per band pixel planes
+    std::vector<uint8_t> pixels;               // interleaved pixels
+};
+
+static void RelayoutTile(const RaquetRelayoutBindData &bind, const std::vector<const std::string *> &blobs,
+                         RelayoutScratch &scratch, RelayoutRow &row) {
+    const auto &meta = bind.meta;
+    const int width = meta.block_width;
+    const int height = meta.block_height;
+    const size_t band_count = meta.bands.size();
+    const size_t num_pixels = static_cast<size_t>(width) * height;
+    scratch.decode.resize(band_count);
+    scratch.planes.resize(band_count);
+
+    // Decode: `have[b]` marks bands present in this row
+    std::vector<bool> have(band_count, false);
+    bool have_pixels = false;
+    if (meta.is_interleaved()) {
+        const std::string *blob = blobs[0];
+        if (blob && !blob->empty()) {
+            auto ptr = reinterpret_cast<const uint8_t *>(blob->data());
+            size_t elem = raquet::dtype_size(bind.dtypes[0]);
+            if (meta.is_lossy_compression()) {
+                int w, h, channels;
+                scratch.pixels = meta.compression == "jpeg"
+                                     ? raquet::decompress_jpeg(ptr, blob->size(), w, h, channels)
+                                     : raquet::decompress_webp(ptr, blob->size(), w, h, channels);
+                if (w != width || h != height || channels < static_cast<int>(band_count)) {
+                    throw std::runtime_error("image tile is " + std::to_string(w) + "x" + std::to_string(h) + "x" +
+                                             std::to_string(channels) + ", expected " + std::to_string(width) +
+                                             "x" + std::to_string(height) + "x" + std::to_string(band_count));
+                }
+                // JPEG decodes to RGB and WebP to RGBA; band b is channel b,
+                // as in decode_band_interleaved, so drop the extra channels
+                if (channels > static_cast<int>(band_count)) {
+                    auto &pixels = scratch.pixels;
+                    for (size_t i = 0; i < num_pixels; i++) {
+                        for (size_t b = 0; b < band_count; b++) {
+                            pixels[i * band_count + b] = pixels[i * channels + b];
+                        }
+                    }
+                    pixels.resize(num_pixels * band_count);
+                }
+            } else {
+                size_t size;
+                const uint8_t *data = raquet::decode_band_bytes(ptr, blob->size(), meta.band_codec(-1), elem, width,
+                                                                height, static_cast<int>(band_count),
+                                                                scratch.decode[0], size);
+                if (size != num_pixels * band_count * elem) {
+                    throw std::runtime_error("pixels tile decodes to " + std::to_string(size) + " bytes, expected " +
+                                             std::to_string(num_pixels * band_count * elem));
+                }
+                scratch.pixels.assign(data, data + size);
+            }
+            have_pixels = true;
+            have.assign(band_count, true);
+        }
+    } else {
+        for (size_t b = 0; b < band_count; b++) {
+            const std::string *blob = blobs[b];
+            if (!blob || blob->empty()) continue;
+            size_t elem = raquet::dtype_size(bind.dtypes[b]);
+            size_t size;
+            const uint8_t *data =
+                raquet::decode_band_bytes(reinterpret_cast<const uint8_t *>(blob->data()), blob->size(),
+                                          meta.band_codec(static_cast<int>(b)), elem, width, height, 1,
+                                          scratch.decode[b], size);
+            if (size != num_pixels * elem) {
+                throw std::runtime_error("band '" + meta.bands[b].first + "' decodes to " + std::to_string(size) +
+                                         " bytes, expected " + std::to_string(num_pixels * elem));
+            }
+            scratch.planes[b].assign(data, data + size);
+            have[b] = true;
+        }
+    }
+    row.columns.clear();
+    row.valid.clear();
+
+    if (bind.interleaved_out) {
+        if (std::none_of(have.begin(), have.end(), [](bool h) { return h; })) {
+            row.columns.emplace_back();
+            row.valid.push_back(false);
+            return;
+        }
+        const size_t elem = raquet::dtype_size(bind.dtypes[0]);
+        if (!have_pixels) {
+            // Bands missing from this row are filled with their nodata (or 0)
+            std::vector<const uint8_t *> planes(band_count);
+            for (size_t b = 0; b < band_count; b++) {
+                if (!have[b]) {
+                    auto &plane = scratch.planes[b];
+                    plane.assign(num_pixels * elem, 0);
+                    if (b < meta.band_info.size() && meta.band_info[b].has_nodata) {
+                        raquet::store_pixel_value(plane.data(), bind.dtypes[b], meta.band_info[b].nodata);
+                        for (size_t i = 1; i < num_pixels; i++) {
+                            std::memcpy(plane.data() + i * elem, plane.data(), elem);
+                        }
+                    }
+                }
+                planes[b] = scratch.planes[b].data();
+            }
+            scratch.pixels.resize(num_pixels * band_count * elem);
+            raquet::interleave_planes(planes.data(), band_count, num_pixels, elem, scratch.pixels.data());
+        }
+        auto &pixels = scratch.pixels;
+        if (bind.compression == "jpeg") {
+            row.columns.push_back(raquet::encode_jpeg(pixels.data(), width, height, static_cast<int>(band_count),
+                                                      bind.quality));
+        } else if (bind.compression == "webp") {
+            row.columns.push_back(raquet::encode_webp(pixels.data(), width, height, static_cast<int>(band_count),
+                                                      bind.quality));
+        } else {
+            row.columns.push_back(raquet::compress_band_bytes(pixels.data(), pixels.size(), bind.compression,
+                                                              "balanced", bind.predictor, elem,
+                                                              RelayoutIsFloat(bind.dtypes[0]), width,
+                                                              static_cast<int>(band_count)));
+        }
+        row.valid.push_back(true);
+        return;
+    }
+
+    if (have_pixels) {
+        const size_t elem = raquet::dtype_size(bind.dtypes[0]);
+        std::vector<uint8_t *> planes(band_count);
+        for (size_t b = 0; b < band_count; b++) {
+            scratch.planes[b].resize(num_pixels * elem);
+            planes[b] = scratch.planes[b].data();
+        }
+        raquet::deinterleave_planes(scratch.pixels.data(), band_count, num_pixels, elem, planes.data());
+    }
+    for (size_t b = 0; b < band_count; b++) {
+        if (!have[b]) {
+            row.columns.emplace_back();
+            row.valid.push_back(false);
+            continue;
+        }
+        auto &plane = scratch.planes[b];
+        size_t elem = raquet::dtype_size(bind.dtypes[b]);
+        auto constant = raquet::encode_constant_tile(plane.data(), plane.size(), elem);
+        if (!constant.empty()) {
+            row.columns.push_back(std::move(constant));
+            row.valid.push_back(true);
+            continue;
+        }
+        size_t plane_bytes = plane.size();
+        int row_width = width;
+        if (bind.packed_bits[b] > 0) {
+            plane_bytes = raquet::pack_bits(plane.data(), width, height, bind.packed_bits[b]);
+            row_width = static_cast<int>(raquet::packed_row_bytes(width, bind.packed_bits[b]));
+        }
+        row.columns.push_back(raquet::compress_band_bytes(plane.data(), plane_bytes, bind.compression, "balanced",
+                                                          bind.predictor, elem, RelayoutIsFloat(bind.dtypes[b]),
+                                                          row_width, 1));
+        row.valid.push_back(true);
+    }
+}
+
+struct RaquetRelayoutLocalState : public LocalTableFunctionState {
+    RelayoutScratch scratch;
+    std::vector<std::string> blob_store;  // one row's input columns
+    std::vector<const std::string *> blobs;
+    RelayoutRow row;
+    idx_t batch_index = 0;  // of the chunk last emitted
+};
+
+// Take the next scan chunk; null once the scan is drained
+static unique_ptr<DataChunk> RelayoutNextChunk(RaquetRelayoutGlobalState &state, RaquetRelayoutLocalState &local) {
+    std::lock_guard<std::mutex> guard(state.lock);
+    if (state.finished) {
+        return nullptr;
+    }
+    auto chunk = state.result->Fetch();
+    if (!chunk || chunk->size() == 0) {
+        state.finished = true;
+        return nullptr;
+    }
+    local.batch_index = state.next_batch++;
+    return chunk;
+}
+
+// ─────────────────────────────────────────────
+// InitGlobal: start a streaming scan of the data rows on an internal
+// Connection; nothing is materialized beyond one chunk at a time.
+// ─────────────────────────────────────────────
+static unique_ptr<GlobalTableFunctionState> RaquetRelayoutInitGlobal(ClientContext &context,
+                                                                     TableFunctionInitInput &input) {
+    auto &bind = input.bind_data->Cast<RaquetRelayoutBindData>();
+    auto state = make_uniq<RaquetRelayoutGlobalState>();
+    state->connection = std::unique_ptr<Connection>(new Connection(*context.db));
+    state->result = state->connection->SendQuery(bind.scan_sql);
+    if (state->result->HasError()) {
+        throw InvalidInputException("raquet_relayout: failed to scan '%s': %s", bind.raster_path,
+                                    state->result->GetError());
+    }
+    return std::move(state);
+}
+
+static unique_ptr<LocalTableFunctionState> RaquetRelayoutInitLocal(ExecutionContext &context,
+                                                                   TableFunctionInitInput &input,
+                                                                   GlobalTableFunctionState *global_state) {
+    return make_uniq<RaquetRelayoutLocalState>();
+}
+
+// ─────────────────────────────────────────────
+// Execute: the first call emits the metadata row (block=0, bands NULL);
+// every other call re-encodes one scan chunk on the calling thread.
+// ─────────────────────────────────────────────
+static void RaquetRelayoutExecute(ClientContext &context, TableFunctionInput &input, DataChunk &output) {
+    auto &bind = input.bind_data->Cast<RaquetRelayoutBindData>();
+    auto &state = input.global_state->Cast<RaquetRelayoutGlobalState>();
+    auto &local = input.local_state->Cast<RaquetRelayoutLocalState>();
+    const idx_t band_columns = output.ColumnCount() - 2;
+
+    {
+        std::lock_guard<std::mutex> guard(state.lock);
+        if (!state.metadata_emitted) {
+            state.metadata_emitted = true;
+            local.batch_index = state.next_batch++;
+            FlatVector::GetData<uint64_t>(output.data[0])[0] = 0;
+            FlatVector::GetData<string_t>(output.data[1])[0] =
+                StringVector::AddString(output.data[1], bind.output_metadata);
+            for (idx_t c = 0; c < band_columns; c++) {
+                FlatVector::SetNull(output.data[2 + c], 0, true);
+            }
+            output.SetCardinality(1);
+            return;
+        }
+    }
+
+    auto chunk = RelayoutNextChunk(state, local);
+    if (!chunk) {
+        output.SetCardinality(0);
+        return;
+    }
+    const size_t input_columns = chunk->ColumnCount() - 1;
+    local.blob_store.resize(input_columns);
+    local.blobs.resize(input_columns);
+    for (idx_t r = 0; r < chunk->size(); r++) {
+        for (size_t c = 0; c < input_columns; c++) {
+            Value v = chunk->GetValue(1 + c, r);
+            local.blobs[c] = nullptr;
+            if (v.IsNull()) continue;
+            local.blob_store[c] = StringValue::Get(v);
+            local.blobs[c] = &local.blob_store[c];
+        }
+        auto &row = local.row;
+        row.block = chunk->GetValue(0, r).GetValue<uint64_t>();
+        try {
+            RelayoutTile(bind, local.blobs, local.scratch, row);
+        } catch (std::exception &e) {
+            throw InvalidInputException("raquet_relayout: %s", e.what());
+        }
+
+        FlatVector::GetData<uint64_t>(output.data[0])[r] = row.block;
+        FlatVector::SetNull(output.data[1], r, true);
+        for (idx_t c = 0; c < band_columns; c++) {
+            if (!row.valid[c]) {
+                FlatVector::SetNull(output.data[2 + c], r, true);
+                continue;
+            }
+            auto &bytes = row.columns[c];
+            FlatVector::GetData<string_t>(output.data[2 + c])[r] = StringVector::AddStringOrBlob(
+                output.data[2 + c], reinterpret_cast<const char *>(bytes.data()), bytes.size());
+        }
+    }
+    output.SetCardinality(chunk->size());
+}
+
+static OperatorPartitionData RaquetRelayoutPartitionData(ClientContext &context,
+                                                         TableFunctionGetPartitionInput &input) {
+    if (input.partition_info.RequiresPartitionColumns()) {
+        throw InternalException("raquet_relayout: partition columns are not supported");
+    }
+    return OperatorPartitionData(input.local_state->Cast<RaquetRelayoutLocalState>().batch_index);
+}
+
+// Planner hint: the data rows plus the metadata row
+static unique_ptr<NodeStatistics> RaquetRelayoutCardinality(ClientContext &context, const FunctionData *bind_data_p) {
+    auto &bind = bind_data_p->Cast<RaquetRelayoutBindData>();
+    if (bind.meta.num_blocks <= 0) {
+        return make_uniq<NodeStatistics>();
+    }
+    return make_uniq<NodeStatistics>(static_cast<idx_t>(bind.meta.num_blocks + 1));
+}
+
+void RegisterRelayoutFunction(ExtensionLoader &loader) {
+    TableFunction relayout_fn("raquet_relayout", {LogicalType::VARCHAR}, RaquetRelayoutExecute, RaquetRelayoutBind,
+                              RaquetRelayoutInitGlobal, RaquetRelayoutInitLocal);
+    relayout_fn.named_parameters["band_layout"] = LogicalType::VARCHAR;
+    relayout_fn.named_parameters["compression"] = LogicalType::VARCHAR;
+    relayout_fn.named_parameters["quality"] = LogicalType::INTEGER;
+    relayout_fn.named_parameters["predictor"] = LogicalType::INTEGER;
+    relayout_fn.cardinality = RaquetRelayoutCardinality;
+    relayout_fn.get_partition_data = RaquetRelayoutPartitionData;
+    loader.RegisterFunction(relayout_fn);
+}
+
+}  // namespace duckdb
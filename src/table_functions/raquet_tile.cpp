@@ -0,0 +1,560 @@
+#include "raquet_tile.hpp"
+#include "band_decoder.hpp"
+#include "band_encoder.hpp"
+#include "quadbin.hpp"
+#include "raquet_metadata.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/connection.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/main/query_result.hpp"
+#include "duckdb/main/materialized_query_result.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace duckdb {
+
+// SQL single-quote escape — apostrophes inside the path are doubled.
+static std::string TileSingleQuote(const std::string &s) {
+    std::string out = "'";
+    for (char c : s) {
+        if (c == '\'') out += "''";
+        else out += c;
+    }
+    return out + "'";
+}
+
+// SQL identifier quote — embedded double quotes are doubled.
+static std::string TileDoubleQuote(const std::string &s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"') out += "\"\"";
+        else out += c;
+    }
+    return out + "\"";
+}
+
+// ─────────────────────────────────────────────
+// Per-file metadata cache. A tile server calls raquet_tile with the same
+// file over and over; keeping the parsed metadata saves the block=0 scan,
+// so a warm request is a single `block = cell` read. Entries are keyed by
+// path and revalidated against the file's modification time; paths without
+// one (globs, some remote filesystems) are never cached.
+// ─────────────────────────────────────────────
+struct CachedTileMetadata {
+    timestamp_t modified;
+    std::string json;
+    std::shared_ptr<const raquet::RaquetMetadata> meta;
+};
+
+static constexpr size_t TILE_METADATA_CACHE_ENTRIES = 64;
+
+static std::mutex tile_metadata_lock;
+static std::unordered_map<std::string, CachedTileMetadata> tile_metadata_cache;
+
+static CachedTileMetadata LoadTileMetadata(ClientContext &context, const std::string &path) {
+    bool cacheable = false;
+    timestamp_t modified;
+    try {
+        auto &fs = FileSystem::GetFileSystem(context);
+        auto handle = fs.OpenFile(path, FileFlags::FILE_FLAGS_READ);
+        modified = fs.GetLastModifiedTime(*handle);
+        cacheable = true;
+    } catch (std::exception &) {
+        // Not a single openable file: read_parquet below reports real errors
+    }
+    if (cacheable) {
+        std::lock_guard<std::mutex> guard(tile_metadata_lock);
+        auto it = tile_metadata_cache.find(path);
+        if (it != tile_metadata_cache.end() && it->second.modified == modified) {
+            return it->second;
+        }
+    }
+
+    Connection con(*context.db);
+    auto meta_result = con.Query("SELECT metadata FROM read_parquet(" + TileSingleQuote(path) +
+                                 ") WHERE block = 0 LIMIT 1");
+    if (meta_result->HasError()) {
+        throw InvalidInputException("raquet_tile: failed to read metadata from '%s': %s", path,
+                                    meta_result->GetError());
+    }
+    auto meta_chunk = meta_result->Fetch();
+    if (!meta_chunk || meta_chunk->size() == 0 || meta_chunk->GetValue(0, 0).IsNull()) {
+        throw InvalidInputException("raquet_tile: '%s' has no metadata row (block=0)", path);
+    }
+    CachedTileMetadata entry;
+    entry.modified = modified;
+    entry.json = meta_chunk->GetValue(0, 0).GetValue<std::string>();
+    entry.meta = std::make_shared<const raquet::RaquetMetadata>(raquet::parse_metadata(entry.json));
+
+    if (cacheable) {
+        std::lock_guard<std::mutex> guard(tile_metadata_lock);
+        if (tile_metadata_cache.size() >= TILE_METADATA_CACHE_ENTRIES) {
+            tile_metadata_cache.clear();
+        }
+        tile_metadata_cache[path] = entry;
+    }
+    return entry;
+}
+
+// ─────────────────────────────────────────────
+// Resampling
+// ─────────────────────────────────────────────
+
+// One decoded source tile of a band. Constant tiles keep a single pixel
+// (step 0); a tile missing from the file has no data.
+struct TileSourcePlane {
+    std::vector<uint8_t> scratch;
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    size_t step = 1;
+};
+
+struct TileBandContext {
+    raquet::BandDataType dtype;
+    size_t elem;
+    bool has_nodata = false;
+    double nodata = 0.0;
+    std::vector<uint8_t> fill;  // nodata (or zero) as one pixel
+
+    bool IsNodata(double v) const {
+        return std::isnan(v) || (has_nodata && v == nodata);
+    }
+};
+
+static void DecodeSourcePlane(const std::string &blob, const raquet::BandCodec &codec, const TileBandContext &band,
+                              int width, int height, TileSourcePlane &plane) {
+    plane.data = nullptr;
+    if (blob.empty()) return;
+    auto ptr = reinterpret_cast<const uint8_t *>(blob.data());
+    size_t size = blob.size();
+    raquet::resolve_tile_ref(ptr, size, codec);
+    if (raquet::is_constant_tile(ptr, size, band.elem, codec)) {
+        plane.data = raquet::constant_tile_value(ptr);
+        plane.size = band.elem;
+        plane.step = 0;
+        return;
+    }
+    plane.step = 1;
+    plane.data = raquet::decode_band_bytes(ptr, size, codec, band.elem, width, height, 1, plane.scratch, plane.size);
+}
+
+// Crop the window of ancestor tile `src` covering the requested tile, `levels`
+// zooms further down, and scale it up to a full tile. Bilinear falls back to
+// the nearest pixel wherever one of its four neighbours is nodata.
+static void UpsampleAncestor(const TileSourcePlane &src, const TileBandContext &band, int width, int height,
+                             int x, int y, int levels, bool bilinear, uint8_t *dst) {
+    double factor = std::ldexp(1.0, levels);
+    uint64_t mask = (uint64_t(1) << levels) - 1;
+    double origin_x = static_cast<double>(static_cast<uint64_t>(x) & mask) * width;
+    double origin_y = static_cast<double>(static_cast<uint64_t>(y) & mask) * height;
+    auto pixel_at = [&](int px, int py) -> size_t {
+        return (static_cast<size_t>(py) * width + px) * src.step;
+    };
+
+    for (int j = 0; j < height; j++) {
+        double sy = (origin_y + j + 0.5) / factor;
+        int ny = std::min(height - 1, static_cast<int>(sy));
+        for (int i = 0; i < width; i++) {
+            double sx = (origin_x + i + 0.5) / factor;
+            int nx = std::min(width - 1, static_cast<int>(sx));
+            uint8_t *out = dst + (static_cast<size_t>(j) * width + i) * band.elem;
+            size_t nearest = pixel_at(nx, ny);
+            if (bilinear) {
+                double fx = sx - 0.5, fy = sy - 0.5;
+                int x0 = static_cast<int>(std::floor(fx)), y0 = static_cast<int>(std::floor(fy));
+                double tx = fx - x0, ty = fy - y0;
+                int xa = std::max(0, x0), xb = std::min(width - 1, x0 + 1);
+                int ya = std::max(0, y0), yb = std::min(height - 1, y0 + 1);
+                double v00 = raquet::get_pixel_value(src.data, src.size, pixel_at(xa, ya), band.dtype);
+                double v10 = raquet::get_pixel_value(src.data, src.size, pixel_at(xb, ya), band.dtype);
+                double v01 = raquet::get_pixel_value(src.data, src.size, pixel_at(xa, yb), band.dtype);
+                double v11 = raquet::get_pixel_value(src.data, src.size, pixel_at(xb, yb), band.dtype);
+                if (!band.IsNodata(v00) && !band.IsNodata(v10) && !band.IsNodata(v01) && !band.IsNodata(v11)) {
+                    double top = v00 + (v10 - v00) * tx;
+                    double bottom = v01 + (v11 - v01) * tx;
+                    raquet::store_pixel_value(out, band.dtype, top + (bottom - top) * ty);
+                    continue;
+                }
+            }
+            std::memcpy(out, src.data + nearest * band.elem, band.elem);
+        }
+    }
+}
+
+// Reduce the 2x2 child tiles (row-major: top-left, top-right, bottom-left,
+// bottom-right; missing ones have no data) to one tile. Nearest keeps the
+// top-left pixel of each 2x2 block; bilinear averages its valid pixels.
+static void ReduceChildren(const TileSourcePlane children[4], const TileBandContext &band, int width, int height,
+                           bool bilinear, uint8_t *dst) {
+    for (int j = 0; j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            uint8_t *out = dst + (static_cast<size_t>(j) * width + i) * band.elem;
+            if (!bilinear) {
+                int gx = 2 * i, gy = 2 * j;
+                const auto &child = children[(gy / height) * 2 + gx / width];
+                if (!child.data) {
+                    std::memcpy(out, band.fill.data(), band.elem);
+                    continue;
+                }
+                size_t offset = (static_cast<size_t>(gy % height) * width + gx % width) * child.step;
+                std::memcpy(out, child.data + offset * band.elem, band.elem);
+                continue;
+            }
+            double sum = 0.0;
+            int valid = 0;
+            for (int k = 0; k < 4; k++) {
+                int gx = 2 * i + (k & 1), gy = 2 * j + (k >> 1);
+                const auto &child = children[(gy / height) * 2 + gx / width];
+                if (!child.data) continue;
+                size_t offset = (static_cast<size_t>(gy % height) * width + gx % width) * child.step;
+                double v = raquet::get_pixel_value(child.data, child.size, offset, band.dtype);
+                if (band.IsNodata(v)) continue;
+                sum += v;
+                valid++;
+            }
+            if (valid == 0) {
+                std::memcpy(out, band.fill.data(), band.elem);
+            } else {
+                raquet::store_pixel_value(out, band.dtype, sum / valid);
+            }
+        }
+    }
+}
+
+// Encode a resampled plane the way the file stores its tiles, so the blob
+// decodes with the file's metadata: constant tile (if the file declares
+// them), bit packing or quantization, predictor, codec and deflate
+// dictionary as configured.
+static std::vector<uint8_t> EncodeTilePlane(std::vector<uint8_t> &plane, const raquet::RaquetMetadata &meta,
+                                            int band_index, const TileBandContext &band) {
+    if (meta.constant_tiles) {
+        auto constant = raquet::encode_constant_tile(plane.data(), plane.size(), band.elem);
+        if (!constant.empty()) {
+            return constant;
+        }
+    }
+    int width = meta.block_width;
+    int height = meta.block_height;
+    size_t size = plane.size();
+    size_t elem = band.elem;
+    int row_width = width;
+    bool is_float = band.dtype == raquet::BandDataType::FLOAT16 || band.dtype == raquet::BandDataType::FLOAT32 ||
+                    band.dtype == raquet::BandDataType::FLOAT64;
+    static const raquet::BandInfo no_info {};
+    const auto &info = band_index < static_cast<int>(meta.band_info.size()) ? meta.band_info[band_index] : no_info;
+    int packed_bits = raquet::packed_bits_of(meta.bands[band_index].second);
+    if (packed_bits > 0) {
+        size = raquet::pack_bits(plane.data(), width, height, packed_bits);
+        row_width = static_cast<int>(raquet::packed_row_bytes(width, packed_bits));
+    } else if (info.is_quantized()) {
+        const auto &q = info.quantization;
+        size_t count = static_cast<size_t>(width) * height;
+        raquet::quantize_band(plane.data(), count, band.elem, q.stored_type, q.scale, q.offset, q.nodata_code,
+                              info.has_nodata, info.nodata);
+        elem = raquet::dtype_size(raquet::parse_dtype(q.stored_type));
+        size = count * elem;
+        is_float = false;
+    }
+
+    const auto &compression = meta.compression;
+    if (compression == "auto") {
+        return raquet::encode_auto_tile(plane.data(), size, elem, row_width, 1, is_float, "balanced");
+    }
+    if (meta.compression_predictor == 2) {
+        raquet::apply_horizontal_predictor(plane.data(), size, elem, row_width, 1);
+    } else if (meta.compression_predictor == 3) {
+        raquet::apply_float_predictor(plane.data(), size, elem, row_width, 1);
+    }
+    if (compression == "gzip") {
+        return raquet::compress_gzip(plane.data(), size, info.compression_dictionary.get());
+    } else if (compression == "zstd") {
+        return raquet::compress_zstd(plane.data(), size);
+    } else if (compression == "lz4") {
+        return raquet::compress_lz4(plane.data(), size);
+    }
+    return std::vector<uint8_t>(plane.begin(), plane.begin() + static_cast<std::ptrdiff_t>(size));
+}
+
+// ─────────────────────────────────────────────
+// Bind / global state
+// ─────────────────────────────────────────────
+struct RaquetTileBindData : public TableFunctionData {
+    std::string raster_path;
+    CachedTileMetadata metadata;
+    int z = 0;
+    int x = 0;
+    int y = 0;
+    std::vector<int> band_indices;
+    bool bilinear = false;
+};
+
+struct RaquetTileGlobalState : public GlobalTableFunctionState {
+    std::vector<Value> row;  // empty when no level covers the tile
+    bool done = false;
+
+    idx_t MaxThreads() const override { return 1; }
+};
+
+static unique_ptr<FunctionData> RaquetTileBind(ClientContext &context, TableFunctionBindInput &input,
+                                               vector<LogicalType> &return_types, vector<string> &names) {
+    for (idx_t i = 0; i < 4; i++) {
+        if (input.inputs[i].IsNull()) {
+            throw InvalidInputException("raquet_tile: arguments cannot be NULL");
+        }
+    }
+    auto bind_data = make_uniq<RaquetTileBindData>();
+    bind_data->raster_path = input.inputs[0].GetValue<std::string>();
+    bind_data->z = input.inputs[1].GetValue<int32_t>();
+    bind_data->x = input.inputs[2].GetValue<int32_t>();
+    bind_data->y = input.inputs[3].GetValue<int32_t>();
+    if (bind_data->z < 0 || bind_data->z > quadbin::MAX_RESOLUTION) {
+        throw InvalidInputException("raquet_tile: z must be between 0 and %d", quadbin::MAX_RESOLUTION);
+    }
+    int64_t tiles = int64_t(1) << bind_data->z;
+    if (bind_data->x < 0 || bind_data->x >= tiles || bind_data->y < 0 || bind_data->y >= tiles) {
+        throw InvalidInputException("raquet_tile: tile %d/%d/%d is outside the grid", bind_data->z, bind_data->x,
+                                    bind_data->y);
+    }
+
+    bind_data->metadata = LoadTileMetadata(context, bind_data->raster_path);
+    const auto &meta = *bind_data->metadata.meta;
+    if (meta.is_interleaved()) {
+        throw InvalidInputException("raquet_tile: interleaved band_layout is not supported");
+    }
+    if (meta.is_lossy_compression()) {
+        throw InvalidInputException("raquet_tile: '%s' compression is not supported", meta.compression);
+    }
+    if (meta.block_width <= 0 || meta.block_height <= 0) {
+        throw InvalidInputException("raquet_tile: '%s' has no block size in its metadata", bind_data->raster_path);
+    }
+
+    for (auto &kv : input.named_parameters) {
+        if (kv.second.IsNull()) continue;
+        if (kv.first == "bands") {
+            for (auto &v : ListValue::GetChildren(kv.second)) {
+                auto name = v.GetValue<std::string>();
+                int idx = meta.get_band_index(name);
+                if (idx < 0) {
+                    throw InvalidInputException("raquet_tile: unknown band '%s'", name);
+                }
+                bind_data->band_indices.push_back(idx);
+            }
+            if (bind_data->band_indices.empty()) {
+                throw InvalidInputException("raquet_tile: bands must name at least one band");
+            }
+        } else if (kv.first == "resampling") {
+            auto method = kv.second.GetValue<std::string>();
+            if (method == "bilinear") {
+                bind_data->bilinear = true;
+            } else if (method != "nearest") {
+                throw InvalidInputException("raquet_tile: unknown resampling '%s' (use nearest, bilinear)", method);
+            }
+        }
+    }
+    if (bind_data->band_indices.empty()) {
+        for (size_t b = 0; b < meta.bands.size(); b++) {
+            bind_data->band_indices.push_back(static_cast<int>(b));
+        }
+    }
+
+    names.push_back("block");       return_types.push_back(LogicalType::UBIGINT);
+    names.push_back("source_zoom"); return_types.push_back(LogicalType::INTEGER);
+    for (int idx : bind_data->band_indices) {
+        names.push_back(meta.bands[idx].first);
+        return_types.push_back(LogicalType::BLOB);
+    }
+    names.push_back("metadata");    return_types.push_back(LogicalType::VARCHAR);
+    return std::move(bind_data);
+}
+
+// Read the requested band columns of `cells`; rows come back keyed by block
+static std::map<uint64_t, std::vector<Value>> FetchTiles(Connection &con, const RaquetTileBindData &bind,
+                                                         const std::vector<uint64_t> &cells) {
+    const auto &meta = *bind.metadata.meta;
+    std::string columns;
+    for (int idx : bind.band_indices) {
+        columns += ", " + TileDoubleQuote(meta.bands[idx].first);
+    }
+    std::string filter;
+    if (cells.size() == 1) {
+        filter = "block = " + std::to_string(cells[0]);
+    } else {
+        for (size_t i = 0; i < cells.size(); i++) {
+            filter += (i == 0 ? "block IN (" : ", ") + std::to_string(cells[i]);
+        }
+        filter += ")";
+    }
+    auto result = con.Query("SELECT block" + columns + " FROM read_parquet(" + TileSingleQuote(bind.raster_path) +
+                            ") WHERE " + filter);
+    if (result->HasError()) {
+        throw InvalidInputException("raquet_tile: failed to read tiles from '%s': %s", bind.raster_path,
+                                    result->GetError());
+    }
+    std::map<uint64_t, std::vector<Value>> rows;
+    while (auto chunk = result->Fetch()) {
+        if (chunk->size() == 0) break;
+        for (idx_t row = 0; row < chunk->size(); row++) {
+            std::vector<Value> values;
+            for (idx_t col = 1; col < chunk->ColumnCount(); col++) {
+                values.push_back(chunk->GetValue(col, row));
+            }
+            rows[chunk->GetValue(0, row).GetValue<uint64_t>()] = std::move(values);
+        }
+    }
+    return rows;
+}
+
+// ─────────────────────────────────────────────
+// InitGlobal: the stored tile if the pyramid has it (one read), else the
+// four children one level down, else the nearest stored ancestor — both
+// fallbacks fetched together in a second read.
+// ─────────────────────────────────────────────
+static unique_ptr<GlobalTableFunctionState> RaquetTileInitGlobal(ClientContext &context,
+                                                                 TableFunctionInitInput &input) {
+    auto &bind = input.bind_data->Cast<RaquetTileBindData>();
+    auto state = make_uniq<RaquetTileGlobalState>();
+    const auto &meta = *bind.metadata.meta;
+    const int z = bind.z;
+    const uint64_t cell = quadbin::tile_to_cell(bind.x, bind.y, z);
+    const size_t num_bands = bind.band_indices.size();
+    auto emit = [&](int source_zoom, std::vector<Value> bands) {
+        state->row.push_back(Value::UBIGINT(cell));
+        state->row.push_back(Value::INTEGER(source_zoom));
+        for (auto &band : bands) {
+            state->row.push_back(std::move(band));
+        }
+        state->row.push_back(Value(bind.metadata.json));
+    };
+
+    Connection con(*context.db);
+    if (z >= meta.min_zoom && z <= meta.max_zoom) {
+        auto exact = FetchTiles(con, bind, {cell});
+        if (!exact.empty()) {
+            emit(z, std::move(exact.begin()->second));
+            return std::move(state);
+        }
+    }
+
+    std::vector<uint64_t> candidates;
+    uint64_t children[4] = {0, 0, 0, 0};
+    bool try_children = z + 1 >= meta.min_zoom && z + 1 <= meta.max_zoom;
+    if (try_children) {
+        for (int k = 0; k < 4; k++) {
+            children[k] = quadbin::tile_to_cell(2 * bind.x + (k & 1), 2 * bind.y + (k >> 1), z + 1);
+            candidates.push_back(children[k]);
+        }
+    }
+    for (int level = std::min(z - 1, meta.max_zoom); level >= meta.min_zoom && level >= 0; level--) {
+        candidates.push_back(quadbin::tile_to_cell(bind.x >> (z - level), bind.y >> (z - level), level));
+    }
+    if (candidates.empty()) {
+        return std::move(state);
+    }
+    auto rows = FetchTiles(con, bind, candidates);
+
+    int source_zoom = -1;
+    if (try_children) {
+        for (int k = 0; k < 4; k++) {
+            if (rows.count(children[k])) source_zoom = z + 1;
+        }
+    }
+    uint64_t ancestor = 0;
+    if (source_zoom < 0) {
+        for (size_t c = try_children ? 4 : 0; c < candidates.size(); c++) {
+            if (rows.count(candidates[c])) {
+                ancestor = candidates[c];
+                source_zoom = quadbin::cell_to_resolution(ancestor);
+                break;
+            }
+        }
+    }
+    if (source_zoom < 0) {
+        return std::move(state);
+    }
+
+    const int width = meta.block_width;
+    const int height = meta.block_height;
+    std::vector<Value> bands;
+    try {
+        for (size_t b = 0; b < num_bands; b++) {
+            int band_index = bind.band_indices[b];
+            TileBandContext band;
+            band.dtype = raquet::parse_dtype(meta.bands[band_index].second);
+            band.elem = raquet::dtype_size(band.dtype);
+            if (band_index < static_cast<int>(meta.band_info.size()) && meta.band_info[band_index].has_nodata) {
+                band.has_nodata = true;
+                band.nodata = meta.band_info[band_index].nodata;
+            }
+            band.fill.assign(band.elem, 0);
+            if (band.has_nodata) {
+                raquet::store_pixel_value(band.fill.data(), band.dtype, band.nodata);
+            }
+            auto codec = meta.band_codec(band_index);
+            auto blob_of = [&](uint64_t source) {
+                auto it = rows.find(source);
+                if (it == rows.end() || it->second[b].IsNull()) return std::string();
+                return StringValue::Get(it->second[b]);
+            };
+
+            std::vector<uint8_t> plane(static_cast<size_t>(width) * height * band.elem);
+            if (source_zoom == z + 1) {
+                TileSourcePlane sources[4];
+                for (int k = 0; k < 4; k++) {
+                    DecodeSourcePlane(blob_of(children[k]), codec, band, width, height, sources[k]);
+                }
+                ReduceChildren(sources, band, width, height, bind.bilinear, plane.data());
+            } else {
+                TileSourcePlane source;
+                DecodeSourcePlane(blob_of(ancestor), codec, band, width, height, source);
+                if (!source.data) {
+                    bands.push_back(Value(LogicalType::BLOB));
+                    continue;
+                }
+                UpsampleAncestor(source, band, width, height, bind.x, bind.y, z - source_zoom, bind.bilinear,
+                                 plane.data());
+            }
+            auto blob = EncodeTilePlane(plane, meta, band_index, band);
+            bands.push_back(Value::BLOB(blob.data(), blob.size()));
+        }
+    } catch (std::exception &e) {
+        throw InvalidInputException("raquet_tile: %s", e.what());
+    }
+    emit(source_zoom, std::move(bands));
+    return std::move(state);
+}
+
+static void RaquetTileExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &state = data.global_state->Cast<RaquetTileGlobalState>();
+    if (state.done || state.row.empty()) {
+        output.SetCardinality(0);
+        return;
+    }
+    for (idx_t col = 0; col < state.row.size(); col++) {
+        output.SetValue(col, 0, state.row[col]);
+    }
+    output.SetCardinality(1);
+    state.done = true;
+}
+
+void RegisterTileFunction(ExtensionLoader &loader) {
+    TableFunction tile_fn("raquet_tile",
+                          {LogicalType::VARCHAR, LogicalType::INTEGER, LogicalType::INTEGER, LogicalType::INTEGER},
+                          RaquetTileExecute, RaquetTileBind, RaquetTileInitGlobal);
+    tile_fn.named_parameters["bands"] = LogicalType::LIST(LogicalType::VARCHAR);
+    tile_fn.named_parameters["resampling"] = LogicalType::VARCHAR;
+    loader.RegisterFunction(tile_fn);
+}
+
+}  // namespace duckdb
@@ -0,0 +1,729 @@
+#include "raquet_to_cog.hpp"
+#include "band_decoder.hpp"
+#include "band_encoder.hpp"
+#include "quadbin.hpp"
+#include "raquet_metadata.hpp"
+#include "tiff_writer.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/common/file_system.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/connection.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/main/query_result.hpp"
+#include "duckdb/main/materialized_query_result.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace duckdb {
+
+// SQL single-quote escape — apostrophes inside the path are doubled.
+static std::string CogSingleQuote(const std::string &s) {
+    std::string out = "'";
+    for (char c : s) {
+        if (c == '\'') out += "''";
+        else out += c;
+    }
+    return out + "'";
+}
+
+// SQL identifier quote — embedded double quotes are doubled.
+static std::string CogDoubleQuote(const std::string &s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"') out += "\"\"";
+        else out += c;
+    }
+    return out + "\"";
+}
+
+// Half the Web Mercator world width in metres
+static constexpr double COG_MERCATOR_HALF_WORLD = 20037508.342789244;
+
+// Overview levels stop once aligning the full-resolution grid to the
+// coarsest level would blow the tile grid up by more than this factor
+static constexpr int64_t COG_MAX_GRID_GROWTH = 4;
+
+// Classic TIFF holds offsets below 4 GiB; larger exports switch to BigTIFF
+static constexpr uint64_t COG_CLASSIC_TIFF_LIMIT = 0xFFFFFFFFull;
+
+// ─────────────────────────────────────────────
+// Bind
+// ─────────────────────────────────────────────
+struct RaquetToCogBindData : public TableFunctionData {
+    std::string raster_path;
+    std::string output_path;
+    raquet::RaquetMetadata meta;
+    std::vector<int> band_indices;
+    bool interleaved = false;
+    bool deflate = true;
+    int predictor = 1;
+    int bigtiff = -1;  // -1 auto, 0 classic, 1 BigTIFF
+};
+
+static void CogSampleFormat(raquet::BandDataType dtype, uint16_t &bits, uint16_t &format) {
+    switch (dtype) {
+        case raquet::BandDataType::UINT1: bits = 1; format = raquet::TIFF_SAMPLE_UINT; return;
+        case raquet::BandDataType::UINT2: bits = 2; format = raquet::TIFF_SAMPLE_UINT; return;
+        case raquet::BandDataType::UINT4: bits = 4; format = raquet::TIFF_SAMPLE_UINT; return;
+        case raquet::BandDataType::FLOAT16:
+        case raquet::BandDataType::FLOAT32:
+        case raquet::BandDataType::FLOAT64: format = raquet::TIFF_SAMPLE_FLOAT; break;
+        case raquet::BandDataType::INT8:
+        case raquet::BandDataType::INT16:
+        case raquet::BandDataType::INT32:
+        case raquet::BandDataType::INT64: format = raquet::TIFF_SAMPLE_INT; break;
+        default: format = raquet::TIFF_SAMPLE_UINT; break;
+    }
+    bits = static_cast<uint16_t>(raquet::dtype_size(dtype) * 8);
+}
+
+static unique_ptr<FunctionData> RaquetToCogBind(ClientContext &context, TableFunctionBindInput &input,
+                                                vector<LogicalType> &return_types, vector<string> &names) {
+    for (idx_t i = 0; i < 2; i++) {
+        if (input.inputs[i].IsNull()) {
+            throw InvalidInputException("raquet_to_cog: arguments cannot be NULL");
+        }
+    }
+    auto bind_data = make_uniq<RaquetToCogBindData>();
+    bind_data->raster_path = input.inputs[0].GetValue<std::string>();
+    bind_data->output_path = input.inputs[1].GetValue<std::string>();
+
+    Connection con(*context.db);
+    auto meta_result = con.Query("SELECT metadata FROM read_parquet(" + CogSingleQuote(bind_data->raster_path) +
+                                 ") WHERE block = 0 LIMIT 1");
+    if (meta_result->HasError()) {
+        throw InvalidInputException("raquet_to_cog: failed to read metadata from '%s': %s",
+                                    bind_data->raster_path, meta_result->GetError());
+    }
+    auto meta_chunk = meta_result->Fetch();
+    if (!meta_chunk || meta_chunk->size() == 0 || meta_chunk->GetValue(0, 0).IsNull()) {
+        throw InvalidInputException("raquet_to_cog: '%s' has no metadata row (block=0)", bind_data->raster_path);
+    }
+    bind_data->meta = raquet::parse_metadata(meta_chunk->GetValue(0, 0).GetValue<std::string>());
+    auto &meta = bind_data->meta;
+    if (meta.is_lossy_compression()) {
+        throw InvalidInputException("raquet_to_cog: '%s' compression is not supported", meta.compression);
+    }
+    if (!meta.scheme.empty() && meta.scheme != "quadbin") {
+        throw InvalidInputException("raquet_to_cog: tiling scheme '%s' is not supported", meta.scheme);
+    }
+    if (!meta.crs.empty() && meta.crs != "EPSG:3857") {
+        throw InvalidInputException("raquet_to_cog: CRS '%s' is not supported (quadbin rasters are EPSG:3857)",
+                                    meta.crs);
+    }
+    if (meta.block_width <= 0 || meta.block_height <= 0 || meta.bands.empty()) {
+        throw InvalidInputException("raquet_to_cog: '%s' has no block size or bands in its metadata",
+                                    bind_data->raster_path);
+    }
+    bind_data->interleaved = meta.is_interleaved();
+    bind_data->predictor = meta.compression_predictor;
+
+    for (auto &kv : input.named_parameters) {
+        if (kv.second.IsNull()) continue;
+        if (kv.first == "bands") {
+            if (bind_data->interleaved) {
+                throw InvalidInputException("raquet_to_cog: bands cannot be selected from an interleaved raster");
+            }
+            for (auto &v : ListValue::GetChildren(kv.second)) {
+                auto name = v.GetValue<std::string>();
+                int idx = meta.get_band_index(name);
+                if (idx < 0) {
+                    throw InvalidInputException("raquet_to_cog: unknown band '%s'", name);
+                }
+                bind_data->band_indices.push_back(idx);
+            }
+            if (bind_data->band_indices.empty()) {
+                throw InvalidInputException("raquet_to_cog: bands must name at least one band");
+            }
+        } else if (kv.first == "compression") {
+            auto compression = kv.second.GetValue<std::string>();
+            if (compression == "none") {
+                bind_data->deflate = false;
+            } else if (compression != "deflate") {
+                throw InvalidInputException("raquet_to_cog: unknown compression '%s' (use deflate, none)",
+                                            compression);
+            }
+        } else if (kv.first == "predictor") {
+            bind_data->predictor = kv.second.GetValue<int32_t>();
+            if (bind_data->predictor < 1 || bind_data->predictor > 3) {
+                throw InvalidInputException("raquet_to_cog: predictor must be 1, 2 or 3");
+            }
+        } else if (kv.first == "bigtiff") {
+            bind_data->bigtiff = kv.second.GetValue<bool>() ? 1 : 0;
+        }
+    }
+    if (bind_data->band_indices.empty()) {
+        for (size_t b = 0; b < meta.bands.size(); b++) {
+            bind_data->band_indices.push_back(static_cast<int>(b));
+        }
+    }
+
+    // TIFF has one sample layout for all bands
+    const auto &first_type = meta.bands[bind_data->band_indices[0]].second;
+    for (int idx : bind_data->band_indices) {
+        if (meta.bands[idx].second != first_type) {
+            throw InvalidInputException("raquet_to_cog: bands must share one data type ('%s' is %s, '%s' is %s); "
+                                        "pick some with bands := [...]",
+                                        meta.bands[bind_data->band_indices[0]].first, first_type,
+                                        meta.bands[idx].first, meta.bands[idx].second);
+        }
+    }
+    auto dtype = raquet::parse_dtype(first_type);
+    bool is_float = dtype == raquet::BandDataType::FLOAT16 || dtype == raquet::BandDataType::FLOAT32 ||
+                    dtype == raquet::BandDataType::FLOAT64;
+    if (!bind_data->deflate || raquet::packed_bits_of(first_type) > 0) {
+        bind_data->predictor = 1;  // sub-byte samples have no TIFF predictor
+    } else if (bind_data->predictor == 3 && !is_float) {
+        throw InvalidInputException("raquet_to_cog: predictor 3 needs a float band");
+    }
+
+    names.push_back("path");         return_types.push_back(LogicalType::VARCHAR);
+    names.push_back("width");        return_types.push_back(LogicalType::BIGINT);
+    names.push_back("height");       return_types.push_back(LogicalType::BIGINT);
+    names.push_back("overviews");    return_types.push_back(LogicalType::INTEGER);
+    names.push_back("tiles_written"); return_types.push_back(LogicalType::BIGINT);
+    names.push_back("tiles_copied"); return_types.push_back(LogicalType::BIGINT);
+    names.push_back("bytes");        return_types.push_back(LogicalType::BIGINT);
+    return std::move(bind_data);
+}
+
+// ─────────────────────────────────────────────
+// Tile encoding
+// ─────────────────────────────────────────────
+
+// One raquet block of a level: its slot in the TIFF tile grid and the blobs
+// of its planes (one per band, or the single interleaved blob)
+struct CogTile {
+    uint64_t index;
+    std::vector<std::string> blobs;
+};
+
+struct CogEncodedTile {
+    std::vector<std::vector<uint8_t>> planes;  // empty plane = sparse
+    int copied = 0;
+};
+
+struct CogPlaneEncoder {
+    const RaquetToCogBindData *bind;
+    raquet::BandDataType dtype;
+    size_t elem;
+    int samples;      // samples per blob: 1, or the band count when interleaved
+    int packed_bits;  // 1/2/4 for packed types, else 0
+    bool raw_copy;    // stored deflate tiles can be copied as is
+
+    // zlib stream header (TIFF deflate is zlib, as compress_gzip writes)
+    static bool IsZlibStream(const uint8_t *data, size_t size) {
+        return size >= 2 && (data[0] & 0x0F) == 8 && ((data[0] << 8) | data[1]) % 31 == 0;
+    }
+
+    std::vector<uint8_t> Encode(const std::string &blob, int band_index, int &copied,
+                                std::vector<uint8_t> &scratch, std::vector<uint8_t> &plane) const {
+        if (blob.empty()) return {};
+        const auto &meta = bind->meta;
+        int width = meta.block_width;
+        int height = meta.block_height;
+        auto codec = meta.band_codec(bind->interleaved ? -1 : band_index);
+        bool has_nodata = false;
+        double nodata = 0.0;
+        if (!bind->interleaved && band_index < static_cast<int>(meta.band_info.size()) &&
+            meta.band_info[band_index].has_nodata) {
+            has_nodata = true;
+            nodata = meta.band_info[band_index].nodata;
+        }
+
+        auto ptr = reinterpret_cast<const uint8_t *>(blob.data());
+        size_t size = blob.size();
+        raquet::resolve_tile_ref(ptr, size, codec);
+        bool constant = samples == 1 && raquet::is_constant_tile(ptr, size, elem, codec);
+        if (raw_copy && !constant && !raquet::has_validity_mask(ptr, size, codec) && IsZlibStream(ptr, size)) {
+            copied++;
+            return std::vector<uint8_t>(ptr, ptr + size);
+        }
+        // All-nodata tiles stay sparse; readers fill them with nodata
+        if (has_nodata) {
+            if (constant) {
+                double v = raquet::get_pixel_value(raquet::constant_tile_value(ptr), elem, 0, dtype);
+                if (v == nodata || (std::isnan(v) && std::isnan(nodata))) return {};
+            } else if (raquet::tile_all_nodata(ptr, size, codec, width, height, true, nodata)) {
+                return {};
+            }
+        }
+
+        size_t data_size;
+        const uint8_t *data =
+            raquet::decode_band_bytes(ptr, size, codec, elem, width, height, samples, scratch, data_size);
+        plane.assign(data, data + data_size);
+        size_t plane_size = plane.size();
+        int row_width = width;
+        if (packed_bits > 0) {
+            plane_size = raquet::pack_bits(plane.data(), width, height, packed_bits);
+            row_width = static_cast<int>(raquet::packed_row_bytes(width, packed_bits));
+        }
+        if (!bind->deflate) {
+            return std::vector<uint8_t>(plane.begin(), plane.begin() + static_cast<std::ptrdiff_t>(plane_size));
+        }
+        if (bind->predictor == 2) {
+            raquet::apply_horizontal_predictor(plane.data(), plane_size, elem, row_width, samples);
+        } else if (bind->predictor == 3) {
+            raquet::apply_float_predictor(plane.data(), plane_size, elem, row_width, samples);
+        }
+        return raquet::compress_gzip(plane.data(), plane_size);
+    }
+};
+
+// A chunk of one level's tiles, encoded by one thread. Batches are numbered
+// in scan order (coarsest level first) and written in that order.
+struct CogBatch {
+    uint64_t sequence = 0;
+    int level = 0;
+    std::vector<CogTile> tiles;
+    std::vector<CogEncodedTile> encoded;
+};
+
+// ─────────────────────────────────────────────
+// Global / local state. InitGlobal lays out the file; the threads then pull
+// batches of tiles level by level (`lock`), encode them on their own and
+// hand them to the in-order writer (`write_lock`). Once no thread holds a
+// batch any more, one of them writes the directories.
+// ─────────────────────────────────────────────
+struct RaquetToCogGlobalState : public GlobalTableFunctionState {
+    int64_t width = 0;
+    int64_t height = 0;
+    int32_t overviews = 0;
+    int64_t tiles_written = 0;
+    int64_t tiles_copied = 0;
+    int64_t bytes = 0;
+    bool done = false;
+
+    // Export layout
+    std::string source;
+    std::string columns;
+    int64_t grid_x0 = 0;
+    int64_t grid_y0 = 0;
+    std::vector<raquet::TiffImage> images;  // full resolution, then overviews
+    bool bigtiff = false;
+    CogPlaneEncoder encoder;
+    unique_ptr<FileHandle> handle;
+
+    // Connection must outlive `level_result`; the level scan streams from it.
+    std::unique_ptr<Connection> connection;
+
+    std::mutex lock;  // guards the scan and the flags below
+    std::condition_variable exported;  // signalled when `active` drops to 0
+    int level = 0;  // level being scanned, counting down to 0
+    duckdb::unique_ptr<QueryResult> level_result;
+    std::unordered_set<uint64_t> seen;  // tile slots of `level` already taken
+    uint64_t next_batch = 0;
+    bool scan_done = false;
+    idx_t active = 0;  // threads that took a batch and have not finished
+    bool failed = false;
+    bool finalizing = false;
+    bool written = false;
+
+    std::mutex write_lock;  // guards the writer below and the tile counters
+    std::map<uint64_t, CogBatch> pending;  // encoded, waiting for earlier batches
+    uint64_t next_write = 0;
+    uint64_t data_pos = 0;
+
+    idx_t MaxThreads() const override { return GlobalTableFunctionState::MAX_THREADS; }
+};
+
+struct RaquetToCogLocalState : public LocalTableFunctionState {
+    std::vector<uint8_t> scratch;
+    std::vector<uint8_t> plane;
+    bool active = false;  // counted in the global `active`
+    bool finished = false;
+};
+
+// ─────────────────────────────────────────────
+// InitGlobal: lays out the export. The tile grid is the max_zoom blocks'
+// extent aligned to the coarsest overview level, so every level's tiles are
+// exactly that level's raquet blocks. Directories are sized up front, tile
+// data is streamed after them (coarsest level first, as COG readers
+// expect), and the directories are written last with the real offsets.
+// ─────────────────────────────────────────────
+static unique_ptr<GlobalTableFunctionState> RaquetToCogInitGlobal(ClientContext &context,
+                                                                  TableFunctionInitInput &input) {
+    auto &bind = input.bind_data->Cast<RaquetToCogBindData>();
+    auto state = make_uniq<RaquetToCogGlobalState>();
+    const auto &meta = bind.meta;
+    const int max_zoom = meta.max_zoom;
+    const std::string source = "read_parquet(" + CogSingleQuote(bind.raster_path) + ")";
+    state->connection = std::unique_ptr<Connection>(new Connection(*context.db));
+
+    // Extent of the full-resolution blocks
+    uint64_t level_lo = quadbin::tile_to_cell(0, 0, max_zoom);
+    uint64_t level_hi = quadbin::tile_to_cell((1 << max_zoom) - 1, (1 << max_zoom) - 1, max_zoom);
+    auto block_result = state->connection->Query("SELECT block FROM " + source + " WHERE block BETWEEN " +
+                                  std::to_string(level_lo) + " AND " + std::to_string(level_hi));
+    if (block_result->HasError()) {
+        throw InvalidInputException("raquet_to_cog: failed to read blocks from '%s': %s", bind.raster_path,
+                                    block_result->GetError());
+    }
+    int64_t x0 = INT64_MAX, y0 = INT64_MAX, x1 = -1, y1 = -1;
+    while (auto chunk = block_result->Fetch()) {
+        if (chunk->size() == 0) break;
+        for (idx_t row = 0; row < chunk->size(); row++) {
+            Value v = chunk->GetValue(0, row);
+            if (v.IsNull()) continue;
+            int x, y, z;
+            quadbin::cell_to_tile(v.GetValue<uint64_t>(), x, y, z);
+            x0 = std::min<int64_t>(x0, x);
+            y0 = std::min<int64_t>(y0, y);
+            x1 = std::max<int64_t>(x1, x);
+            y1 = std::max<int64_t>(y1, y);
+        }
+    }
+    if (x1 < 0) {
+        throw InvalidInputException("raquet_to_cog: '%s' has no tiles at max_zoom %d", bind.raster_path, max_zoom);
+    }
+
+    // Overviews: one per pyramid level while the aligned grid stays small,
+    // and no further than the level where the raster is a single tile
+    int64_t own_tiles = (x1 - x0 + 1) * (y1 - y0 + 1);
+    int levels = 0;
+    for (int d = 1; d <= max_zoom - meta.min_zoom; d++) {
+        int64_t across = ((x1 >> d) - (x0 >> d) + 1) << d;
+        int64_t down = ((y1 >> d) - (y0 >> d) + 1) << d;
+        if (across * down > COG_MAX_GRID_GROWTH * own_tiles) break;
+        levels = d;
+        if ((x0 >> d) == (x1 >> d) && (y0 >> d) == (y1 >> d)) break;
+    }
+    int64_t grid_x0 = (x0 >> levels) << levels;
+    int64_t grid_y0 = (y0 >> levels) << levels;
+    int64_t grid_across = ((x1 >> levels) - (x0 >> levels) + 1) << levels;
+    int64_t grid_down = ((y1 >> levels) - (y0 >> levels) + 1) << levels;
+    state->width = grid_across * meta.block_width;
+    state->height = grid_down * meta.block_height;
+    state->overviews = levels;
+    if (state->width > UINT32_MAX || state->height > UINT32_MAX) {
+        throw InvalidInputException("raquet_to_cog: %lld x %lld pixels exceed the TIFF size limit",
+                                    static_cast<long long>(state->width), static_cast<long long>(state->height));
+    }
+
+    // Image layout shared by all levels
+    auto dtype = raquet::parse_dtype(meta.bands[bind.band_indices[0]].second);
+    const size_t band_count = bind.band_indices.size();
+    raquet::TiffImage base;
+    base.tile_width = meta.block_width;
+    base.tile_height = meta.block_height;
+    base.samples_per_pixel = static_cast<uint16_t>(band_count);
+    CogSampleFormat(dtype, base.bits_per_sample, base.sample_format);
+    base.planar_config = bind.interleaved ? raquet::TIFF_PLANAR_CONTIG : raquet::TIFF_PLANAR_SEPARATE;
+    base.compression = bind.deflate ? raquet::TIFF_COMPRESSION_DEFLATE : raquet::TIFF_COMPRESSION_NONE;
+    base.predictor = static_cast<uint16_t>(bind.predictor);
+    auto colorinterp = [&](size_t b) {
+        int idx = bind.band_indices[b];
+        return idx < static_cast<int>(meta.band_info.size()) ? meta.band_info[idx].colorinterp : std::string();
+    };
+    if (band_count >= 3 && base.bits_per_sample == 8 && colorinterp(0) == "red" && colorinterp(1) == "green" &&
+        colorinterp(2) == "blue") {
+        base.photometric = raquet::TIFF_PHOTOMETRIC_RGB;
+    }
+    size_t color_samples = base.photometric == raquet::TIFF_PHOTOMETRIC_RGB ? 3 : 1;
+    for (size_t b = color_samples; b < band_count; b++) {
+        base.extra_samples.push_back(colorinterp(b) == "alpha" ? 2 : 0);  // unassociated alpha / unspecified
+    }
+
+    std::vector<raquet::TiffImage> images;
+    for (int l = 0; l <= levels; l++) {
+        raquet::TiffImage image = base;
+        image.width = static_cast<uint32_t>((grid_across >> l) * meta.block_width);
+        image.height = static_cast<uint32_t>((grid_down >> l) * meta.block_height);
+        image.overview = l > 0;
+        image.tile_offsets.assign(image.TileCount(), 0);
+        image.tile_byte_counts.assign(image.TileCount(), 0);
+        images.push_back(std::move(image));
+    }
+
+    // GeoTIFF: pixel-is-area EPSG:3857, tied at the grid's top-left corner
+    double tile_span = 2.0 * COG_MERCATOR_HALF_WORLD / std::ldexp(1.0, max_zoom);
+    images[0].model_pixel_scale = {tile_span / meta.block_width, tile_span / meta.block_height, 0.0};
+    images[0].model_tiepoint = {0.0, 0.0, 0.0, -COG_MERCATOR_HALF_WORLD + grid_x0 * tile_span,
+                                COG_MERCATOR_HALF_WORLD - grid_y0 * tile_span, 0.0};
+    images[0].geo_key_directory = {1, 1, 0, 3,         // version 1.1.0, 3 keys
+                                   1024, 0, 1, 1,      // GTModelType: projected
+                                   1025, 0, 1, 1,      // GTRasterType: pixel is area
+                                   3072, 0, 1, 3857};  // ProjectedCSType
+    if (!bind.interleaved) {
+        const raquet::BandInfo *first = meta.band_info.size() > static_cast<size_t>(bind.band_indices[0])
+                                            ? &meta.band_info[bind.band_indices[0]]
+                                            : nullptr;
+        bool same_nodata = first && first->has_nodata;
+        for (int idx : bind.band_indices) {
+            if (!same_nodata || idx >= static_cast<int>(meta.band_info.size())) {
+                same_nodata = false;
+                break;
+            }
+            const auto &bi = meta.band_info[idx];
+            same_nodata = bi.has_nodata && (bi.nodata == first->nodata ||
+                                            (std::isnan(bi.nodata) && std::isnan(first->nodata)));
+        }
+        if (same_nodata) {
+            char buf[64];
+            snprintf(buf, sizeof(buf), "%.17g", first->nodata);
+            images[0].gdal_nodata = std::isnan(first->nodata) ? "nan" : buf;
+        }
+    }
+
+    // Classic TIFF unless the uncompressed pixels alone could pass 4 GiB
+    uint64_t raw_bytes = 0;
+    for (const auto &image : images) {
+        raw_bytes += static_cast<uint64_t>(image.width) * image.height * band_count *
+                     std::max<uint64_t>(1, base.bits_per_sample / 8);
+    }
+    bool bigtiff = bind.bigtiff < 0 ? raw_bytes + raw_bytes / 8 > COG_CLASSIC_TIFF_LIMIT : bind.bigtiff == 1;
+    uint64_t data_pos = raquet::serialize_tiff_directories(images, bigtiff).size();
+
+    auto &fs = FileSystem::GetFileSystem(context);
+    state->handle =
+        fs.OpenFile(bind.output_path, FileFlags::FILE_FLAGS_WRITE | FileFlags::FILE_FLAGS_FILE_CREATE_NEW);
+
+    auto &encoder = state->encoder;
+    encoder.bind = &bind;
+    encoder.dtype = dtype;
+    encoder.elem = raquet::dtype_size(dtype);
+    encoder.samples = bind.interleaved ? static_cast<int>(band_count) : 1;
+    encoder.packed_bits = raquet::packed_bits_of(meta.bands[bind.band_indices[0]].second);
+    encoder.raw_copy = bind.deflate && meta.compression == "gzip" && meta.compression_predictor == bind.predictor;
+    for (int idx : bind.band_indices) {
+        if (idx < static_cast<int>(meta.band_info.size())) {
+            const auto &bi = meta.band_info[idx];
+            if (bi.is_quantized() || (bi.compression_dictionary && !bi.compression_dictionary->empty())) {
+                encoder.raw_copy = false;
+            }
+        }
+    }
+
+    std::string columns;
+    if (bind.interleaved) {
+        columns = ", pixels";
+    } else {
+        for (int idx : bind.band_indices) {
+            columns += ", " + CogDoubleQuote(meta.bands[idx].first);
+        }
+    }
+    state->source = source;
+    state->columns = columns;
+    state->grid_x0 = grid_x0;
+    state->grid_y0 = grid_y0;
+    state->images = std::move(images);
+    state->bigtiff = bigtiff;
+    state->data_pos = data_pos;
+    state->level = levels;  // coarsest overview first, full resolution last
+    return std::move(state);
+}
+
+static unique_ptr<LocalTableFunctionState> RaquetToCogInitLocal(ExecutionContext &context,
+                                                               TableFunctionInitInput &input,
+                                                               GlobalTableFunctionState *global_state) {
+    return make_uniq<RaquetToCogLocalState>();
+}
+
+// Take the next chunk of tiles off the scan, opening the next level when
+// one runs out. Returns false once every level has been handed out.
+static bool NextCogBatch(const RaquetToCogBindData &bind, RaquetToCogGlobalState &state,
+                         RaquetToCogLocalState &local, CogBatch &batch) {
+    const size_t planes = bind.interleaved ? 1 : bind.band_indices.size();
+    std::lock_guard<std::mutex> guard(state.lock);
+    while (!state.scan_done) {
+        int l = state.level;
+        if (!state.level_result) {
+            if (l < 0) {
+                state.scan_done = true;
+                break;
+            }
+            int z = bind.meta.max_zoom - l;
+            uint64_t lo = quadbin::tile_to_cell(0, 0, z);
+            uint64_t hi = quadbin::tile_to_cell((1 << z) - 1, (1 << z) - 1, z);
+            // Streamed, so only the chunk being handed out is in memory
+            state.level_result = state.connection->SendQuery("SELECT block" + state.columns + " FROM " +
+                                                             state.source + " WHERE block BETWEEN " +
+                                                             std::to_string(lo) + " AND " + std::to_string(hi));
+            if (state.level_result->HasError()) {
+                throw InvalidInputException("raquet_to_cog: failed to read tiles from '%s': %s", bind.raster_path,
+                                            state.level_result->GetError());
+            }
+            state.seen.clear();
+        }
+        auto chunk = state.level_result->Fetch();
+        if (!chunk || chunk->size() == 0) {
+            state.level_result.reset();
+            state.level--;
+            continue;
+        }
+
+        const auto &image = state.images[l];
+        int64_t level_x0 = state.grid_x0 >> l;
+        int64_t level_y0 = state.grid_y0 >> l;
+        uint64_t across = image.TilesAcross();
+        uint64_t down = image.TilesDown();
+        batch = CogBatch();
+        batch.level = l;
+        for (idx_t row = 0; row < chunk->size(); row++) {
+            Value block_value = chunk->GetValue(0, row);
+            if (block_value.IsNull()) continue;
+            int x, y, tz;
+            quadbin::cell_to_tile(block_value.GetValue<uint64_t>(), x, y, tz);
+            int64_t col = x - level_x0;
+            int64_t row_index = y - level_y0;
+            if (col < 0 || row_index < 0 || col >= static_cast<int64_t>(across) ||
+                row_index >= static_cast<int64_t>(down)) {
+                continue;  // overview block outside the exported extent
+            }
+            CogTile tile;
+            tile.index = static_cast<uint64_t>(row_index) * across + static_cast<uint64_t>(col);
+            if (!state.seen.insert(tile.index).second) continue;
+            for (size_t p = 0; p < planes; p++) {
+                Value v = chunk->GetValue(1 + p, row);
+                tile.blobs.push_back(v.IsNull() ? std::string() : StringValue::Get(v));
+            }
+            batch.tiles.push_back(std::move(tile));
+        }
+        if (batch.tiles.empty()) continue;
+
+        batch.sequence = state.next_batch++;
+        if (!local.active) {
+            local.active = true;
+            state.active++;
+        }
+        return true;
+    }
+    return false;
+}
+
+// Queue an encoded batch and write out every batch whose turn has come, so
+// tile data lands in scan order whichever thread finishes first
+static void WriteCogBatch(const RaquetToCogBindData &bind, RaquetToCogGlobalState &state, CogBatch &&batch) {
+    const size_t planes = bind.interleaved ? 1 : bind.band_indices.size();
+    std::lock_guard<std::mutex> guard(state.write_lock);
+    state.pending.emplace(batch.sequence, std::move(batch));
+    for (auto it = state.pending.find(state.next_write); it != state.pending.end();
+         it = state.pending.find(state.next_write)) {
+        auto &ready = it->second;
+        auto &image = state.images[ready.level];
+        const uint64_t plane_tiles = image.TilesAcross() * image.TilesDown();
+        for (size_t t = 0; t < ready.tiles.size(); t++) {
+            bool written = false;
+            for (size_t p = 0; p < planes; p++) {
+                auto &bytes = ready.encoded[t].planes[p];
+                if (bytes.empty()) continue;
+                uint64_t slot = p * plane_tiles + ready.tiles[t].index;
+                state.handle->Write(bytes.data(), bytes.size(), state.data_pos);
+                image.tile_offsets[slot] = state.data_pos;
+                image.tile_byte_counts[slot] = bytes.size();
+                state.data_pos += bytes.size();
+                written = true;
+            }
+            if (written) state.tiles_written++;
+            state.tiles_copied += ready.encoded[t].copied;
+        }
+        state.pending.erase(it);
+        state.next_write++;
+    }
+}
+
+// Encode and write batches until the scan is exhausted, then wait for the
+// threads still holding one; the first thread through writes the
+// directories. A thread counts as active from its first batch, and none
+// can start after the scan is exhausted, so `active == 0` means done.
+static void ExportCogTiles(const RaquetToCogBindData &bind, RaquetToCogGlobalState &state,
+                           RaquetToCogLocalState &local) {
+    const size_t planes = bind.interleaved ? 1 : bind.band_indices.size();
+    CogBatch batch;
+    try {
+        while (NextCogBatch(bind, state, local, batch)) {
+            batch.encoded.assign(batch.tiles.size(), CogEncodedTile());
+            try {
+                for (size_t t = 0; t < batch.tiles.size(); t++) {
+                    auto &out = batch.encoded[t];
+                    for (size_t p = 0; p < planes; p++) {
+                        out.planes.push_back(state.encoder.Encode(batch.tiles[t].blobs[p], bind.band_indices[p],
+                                                                  out.copied, local.scratch, local.plane));
+                    }
+                }
+            } catch (std::exception &e) {
+                throw InvalidInputException("raquet_to_cog: %s", e.what());
+            }
+            WriteCogBatch(bind, state, std::move(batch));
+        }
+    } catch (...) {
+        // Stop the scan and release the threads waiting on this one
+        std::lock_guard<std::mutex> guard(state.lock);
+        state.scan_done = true;
+        state.failed = true;
+        if (local.active && --state.active == 0) {
+            state.exported.notify_all();
+        }
+        local.active = false;
+        local.finished = true;
+        throw;
+    }
+
+    std::unique_lock<std::mutex> guard(state.lock);
+    local.finished = true;
+    if (local.active && --state.active == 0) {
+        state.exported.notify_all();
+    }
+    local.active = false;
+    state.exported.wait(guard, [&] { return state.active == 0; });
+    if (state.failed || state.finalizing) return;
+    state.finalizing = true;
+
+    std::vector<uint8_t> directories;
+    try {
+        directories = raquet::serialize_tiff_directories(state.images, state.bigtiff);
+    } catch (std::exception &e) {
+        throw InvalidInputException("raquet_to_cog: %s (set bigtiff := true)", e.what());
+    }
+    state.handle->Write(directories.data(), directories.size(), 0);
+    state.handle->Sync();
+    state.handle->Close();
+    state.bytes = static_cast<int64_t>(state.data_pos);
+    state.written = true;
+}
+
+static void RaquetToCogExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &bind = data.bind_data->Cast<RaquetToCogBindData>();
+    auto &state = data.global_state->Cast<RaquetToCogGlobalState>();
+    auto &local = data.local_state->Cast<RaquetToCogLocalState>();
+    if (!local.finished) {
+        ExportCogTiles(bind, state, local);
+    }
+    std::lock_guard<std::mutex> guard(state.lock);
+    if (state.done || !state.written) {
+        output.SetCardinality(0);
+        return;
+    }
+    output.SetValue(0, 0, Value(bind.output_path));
+    output.SetValue(1, 0, Value::BIGINT(state.width));
+    output.SetValue(2, 0, Value::BIGINT(state.height));
+    output.SetValue(3, 0, Value::INTEGER(state.overviews));
+    output.SetValue(4, 0, Value::BIGINT(state.tiles_written));
+    output.SetValue(5, 0, Value::BIGINT(state.tiles_copied));
+    output.SetValue(6, 0, Value::BIGINT(state.bytes));
+    output.SetCardinality(1);
+    state.done = true;
+}
+
+void RegisterToCogFunction(ExtensionLoader &loader) {
+    TableFunction cog_fn("raquet_to_cog", {LogicalType::VARCHAR, LogicalType::VARCHAR}, RaquetToCogExecute,
+                         RaquetToCogBind, RaquetToCogInitGlobal, RaquetToCogInitLocal);
+    cog_fn.named_parameters["bands"] = LogicalType::LIST(LogicalType::VARCHAR);
+    cog_fn.named_parameters["compression"] = LogicalType::VARCHAR;
+    cog_fn.named_parameters["predictor"] = LogicalType::INTEGER;
+    cog_fn.named_parameters["bigtiff"] = LogicalType::BOOLEAN;
+    loader.RegisterFunction(cog_fn);
+}
+
+}  // namespace duckdb
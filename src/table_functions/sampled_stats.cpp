@@ -0,0 +1,479 @@
+#include "sampled_stats.hpp"
+#include "band_decoder.hpp"
+#include "quadbin.hpp"
+#include "raquet_metadata.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/connection.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/main/query_result.hpp"
+#include "duckdb/main/materialized_query_result.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace duckdb {
+
+// SQL single-quote escape — apostrophes inside the path are doubled.
+static std::string SampledSingleQuote(const std::string &s) {
+    std::string out = "'";
+    for (char c : s) {
+        if (c == '\'') out += "''";
+        else out += c;
+    }
+    return out + "'";
+}
+
+// SQL identifier quote — embedded double quotes are doubled.
+static std::string SampledDoubleQuote(const std::string &s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"') out += "\"\"";
+        else out += c;
+    }
+    return out + "\"";
+}
+
+// Sampled tiles are fetched in batches of this many blocks. A batch
+// filters on its picks only (an IN list, pushed into the parquet scan as
+// per-value zone-map checks), not on the range they span, so row groups
+// between picks are skipped rather than read and filtered.
+static constexpr size_t SAMPLE_FETCH_BATCH = 64;
+
+// Pixel values kept for quantiles across all sampled tiles. Larger samples
+// keep every k-th valid pixel of each tile, weighted back to the tile's count.
+static constexpr size_t SAMPLE_QUANTILE_VALUES = 1 << 20;
+
+// ─────────────────────────────────────────────
+// Per-tile summaries. Tiles are the sampling units (clusters of pixels):
+// all variances below are between-tile, which is what makes the intervals
+// honest for spatially correlated rasters.
+// ─────────────────────────────────────────────
+struct SampledTile {
+    int64_t count = 0;
+    double sum = 0.0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    void Add(double value) {
+        count++;
+        sum += value;
+        double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+    }
+};
+
+struct SampledValue {
+    double value;
+    double weight;
+    uint32_t tile;
+};
+
+struct SampledStatRow {
+    std::string statistic;
+    Value estimate;
+    Value ci_lower;
+    Value ci_upper;
+};
+
+// ─────────────────────────────────────────────
+// Bind / global state
+// ─────────────────────────────────────────────
+struct RaquetSampledStatsBindData : public TableFunctionData {
+    std::string raster_path;
+    raquet::RaquetMetadata meta;
+    int band_index = 0;
+    double fraction = 0.0;
+    int64_t seed = 0;
+    std::vector<double> quantiles = {0.25, 0.5, 0.75};
+    double confidence = 0.95;
+    int resolution = 0;
+};
+
+struct RaquetSampledStatsGlobalState : public GlobalTableFunctionState {
+    std::vector<SampledStatRow> rows;
+    int64_t tiles_sampled = 0;
+    int64_t tiles_total = 0;
+    idx_t next_row = 0;
+
+    idx_t MaxThreads() const override { return 1; }
+};
+
+static unique_ptr<FunctionData> RaquetSampledStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                       vector<LogicalType> &return_types, vector<string> &names) {
+    for (idx_t i = 0; i < 3; i++) {
+        if (input.inputs[i].IsNull()) {
+            throw InvalidInputException("ST_RasterStatsSampled: arguments cannot be NULL");
+        }
+    }
+    auto bind_data = make_uniq<RaquetSampledStatsBindData>();
+    bind_data->raster_path = input.inputs[0].GetValue<std::string>();
+    auto band_name = input.inputs[1].GetValue<std::string>();
+    bind_data->fraction = input.inputs[2].GetValue<double>();
+    if (!(bind_data->fraction > 0.0 && bind_data->fraction <= 1.0)) {
+        throw InvalidInputException("ST_RasterStatsSampled: fraction must be in (0, 1]");
+    }
+
+    Connection con(*context.db);
+    auto meta_result = con.Query("SELECT metadata FROM read_parquet(" + SampledSingleQuote(bind_data->raster_path) +
+                                 ") WHERE block = 0 LIMIT 1");
+    if (meta_result->HasError()) {
+        throw InvalidInputException("ST_RasterStatsSampled: failed to read metadata from '%s': %s",
+                                    bind_data->raster_path, meta_result->GetError());
+    }
+    auto meta_chunk = meta_result->Fetch();
+    if (!meta_chunk || meta_chunk->size() == 0 || meta_chunk->GetValue(0, 0).IsNull()) {
+        throw InvalidInputException("ST_RasterStatsSampled: '%s' has no metadata row (block=0)",
+                                    bind_data->raster_path);
+    }
+    bind_data->meta = raquet::parse_metadata(meta_chunk->GetValue(0, 0).GetValue<std::string>());
+    auto &meta = bind_data->meta;
+    if (meta.is_interleaved()) {
+        throw InvalidInputException("ST_RasterStatsSampled: interleaved band_layout is not supported");
+    }
+    if (meta.is_lossy_compression()) {
+        throw InvalidInputException("ST_RasterStatsSampled: '%s' compression is not supported", meta.compression);
+    }
+    bind_data->band_index = meta.get_band_index(band_name);
+    if (bind_data->band_index < 0) {
+        throw InvalidInputException("ST_RasterStatsSampled: unknown band '%s'", band_name);
+    }
+    bind_data->resolution = meta.max_zoom;
+
+    for (auto &kv : input.named_parameters) {
+        if (kv.second.IsNull()) continue;
+        if (kv.first == "seed") {
+            bind_data->seed = kv.second.GetValue<int64_t>();
+        } else if (kv.first == "quantiles") {
+            bind_data->quantiles.clear();
+            for (auto &v : ListValue::GetChildren(kv.second)) {
+                double q = v.GetValue<double>();
+                if (!(q >= 0.0 && q <= 1.0)) {
+                    throw InvalidInputException("ST_RasterStatsSampled: quantiles must be in [0, 1]");
+                }
+                bind_data->quantiles.push_back(q);
+            }
+        } else if (kv.first == "confidence") {
+            bind_data->confidence = kv.second.GetValue<double>();
+            if (!(bind_data->confidence > 0.0 && bind_data->confidence < 1.0)) {
+                throw InvalidInputException("ST_RasterStatsSampled: confidence must be in (0, 1)");
+            }
+        } else if (kv.first == "resolution") {
+            bind_data->resolution = kv.second.GetValue<int32_t>();
+            if (bind_data->resolution < meta.min_zoom || bind_data->resolution > meta.max_zoom) {
+                throw InvalidInputException("ST_RasterStatsSampled: resolution %d is outside the pyramid [%d, %d]",
+                                            bind_data->resolution, meta.min_zoom, meta.max_zoom);
+            }
+        }
+    }
+
+    names.push_back("statistic");     return_types.push_back(LogicalType::VARCHAR);
+    names.push_back("estimate");      return_types.push_back(LogicalType::DOUBLE);
+    names.push_back("ci_lower");      return_types.push_back(LogicalType::DOUBLE);
+    names.push_back("ci_upper");      return_types.push_back(LogicalType::DOUBLE);
+    names.push_back("tiles_sampled"); return_types.push_back(LogicalType::BIGINT);
+    names.push_back("tiles_total");   return_types.push_back(LogicalType::BIGINT);
+    return std::move(bind_data);
+}
+
+// Fold one sampled tile into its summary and the quantile value pool
+static void ProcessSampledTile(const std::string &blob, const RaquetSampledStatsBindData &bind, uint32_t tile_id,
+                               size_t stride, SampledTile &tile, std::vector<SampledValue> &values,
+                               std::vector<uint8_t> &scratch) {
+    if (blob.empty()) return;
+    const auto &meta = bind.meta;
+    int width = meta.block_width;
+    int height = meta.block_height;
+    auto dtype = raquet::parse_dtype(meta.bands[bind.band_index].second);
+    bool has_nodata = false;
+    double nodata = 0.0;
+    if (bind.band_index < static_cast<int>(meta.band_info.size()) && meta.band_info[bind.band_index].has_nodata) {
+        has_nodata = true;
+        nodata = meta.band_info[bind.band_index].nodata;
+    }
+    auto is_nodata = [has_nodata, nodata](double v) {
+        return has_nodata && (v == nodata || (std::isnan(v) && std::isnan(nodata)));
+    };
+
+    auto codec = meta.band_codec(bind.band_index);
+    auto ptr = reinterpret_cast<const uint8_t *>(blob.data());
+    size_t size = blob.size();
+    raquet::resolve_tile_ref(ptr, size, codec);
+    if (raquet::tile_all_nodata(ptr, size, codec, width, height, has_nodata, nodata)) {
+        return;
+    }
+    size_t elem = raquet::dtype_size(dtype);
+    if (raquet::is_constant_tile(ptr, size, elem, codec)) {
+        double v = raquet::get_pixel_value(raquet::constant_tile_value(ptr), elem, 0, dtype);
+        if (is_nodata(v)) return;
+        int64_t n = static_cast<int64_t>(width) * height;
+        tile.count = n;
+        tile.sum = v * n;
+        tile.mean = v;
+        values.push_back({v, static_cast<double>(n), tile_id});
+        return;
+    }
+
+    size_t data_size;
+    const uint8_t *data = raquet::decode_band_bytes(ptr, size, codec, elem, width, height, 1, scratch, data_size);
+    size_t first = values.size();
+    size_t num_pixels = static_cast<size_t>(width) * height;
+    for (size_t i = 0; i < num_pixels; i++) {
+        double v = raquet::get_pixel_value(data, data_size, i, dtype);
+        if (is_nodata(v)) continue;
+        if (tile.count % stride == 0) {
+            values.push_back({v, 0.0, tile_id});
+        }
+        tile.Add(v);
+    }
+    double weight = static_cast<double>(tile.count) / static_cast<double>(values.size() - first);
+    for (size_t i = first; i < values.size(); i++) {
+        values[i].weight = weight;
+    }
+}
+
+// Standard error of the ratio estimator sum(y) / sum(x) over n sampled
+// tiles out of total, with finite population correction. NaN below 2 tiles.
+static double RatioStandardError(const std::vector<double> &y, const std::vector<SampledTile> &tiles,
+                                 double ratio, int64_t total) {
+    size_t n = tiles.size();
+    if (n < 2) return std::nan("");
+    double x_sum = 0.0;
+    double residuals = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double r = y[i] - ratio * static_cast<double>(tiles[i].count);
+        residuals += r * r;
+        x_sum += static_cast<double>(tiles[i].count);
+    }
+    double x_mean = x_sum / n;
+    double fpc = 1.0 - static_cast<double>(n) / static_cast<double>(total);
+    return std::sqrt(std::max(0.0, fpc) * residuals / (n - 1) / (n * x_mean * x_mean));
+}
+
+// Two-sided normal critical value for `confidence` (bisection on erfc)
+static double NormalCriticalValue(double confidence) {
+    double alpha = 1.0 - confidence;
+    double lo = 0.0, hi = 40.0;
+    for (int i = 0; i < 100; i++) {
+        double mid = 0.5 * (lo + hi);
+        if (std::erfc(mid / std::sqrt(2.0)) > alpha) lo = mid;
+        else hi = mid;
+    }
+    return 0.5 * (lo + hi);
+}
+
+// Smallest pooled value whose cumulative weight reaches p (values sorted)
+static double WeightedQuantile(const std::vector<SampledValue> &values, double total_weight, double p) {
+    double target = std::min(1.0, std::max(0.0, p)) * total_weight;
+    double cumulative = 0.0;
+    for (const auto &v : values) {
+        cumulative += v.weight;
+        if (cumulative >= target) return v.value;
+    }
+    return values.back().value;
+}
+
+static std::string QuantileName(double q) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "p%g", q * 100.0);
+    return buf;
+}
+
+// ─────────────────────────────────────────────
+// InitGlobal: list the level's blocks (block column only, level range
+// pushed into the scan), draw one block per stratum of consecutive
+// blocks, fetch and fold the drawn tiles, then estimate.
+// ─────────────────────────────────────────────
+static unique_ptr<GlobalTableFunctionState> RaquetSampledStatsInitGlobal(ClientContext &context,
+                                                                         TableFunctionInitInput &input) {
+    auto &bind = input.bind_data->Cast<RaquetSampledStatsBindData>();
+    auto state = make_uniq<RaquetSampledStatsGlobalState>();
+    const auto &meta = bind.meta;
+    const int z = bind.resolution;
+    const std::string source = "read_parquet(" + SampledSingleQuote(bind.raster_path) + ")";
+
+    // Cells of one resolution span one contiguous range of block values
+    uint64_t level_lo = quadbin::tile_to_cell(0, 0, z);
+    uint64_t level_hi = quadbin::tile_to_cell((1 << z) - 1, (1 << z) - 1, z);
+
+    Connection con(*context.db);
+    auto block_result = con.Query("SELECT block FROM " + source + " WHERE block BETWEEN " +
+                                  std::to_string(level_lo) + " AND " + std::to_string(level_hi));
+    if (block_result->HasError()) {
+        throw InvalidInputException("ST_RasterStatsSampled: failed to read blocks from '%s': %s",
+                                    bind.raster_path, block_result->GetError());
+    }
+    std::vector<uint64_t> blocks;
+    while (auto chunk = block_result->Fetch()) {
+        if (chunk->size() == 0) break;
+        for (idx_t row = 0; row < chunk->size(); row++) {
+            Value v = chunk->GetValue(0, row);
+            if (!v.IsNull()) blocks.push_back(v.GetValue<uint64_t>());
+        }
+    }
+    std::sort(blocks.begin(), blocks.end());
+    blocks.erase(std::unique(blocks.begin(), blocks.end()), blocks.end());
+    state->tiles_total = static_cast<int64_t>(blocks.size());
+
+    std::vector<uint64_t> picks;
+    if (!blocks.empty()) {
+        size_t total = blocks.size();
+        size_t n = static_cast<size_t>(std::llround(bind.fraction * static_cast<double>(total)));
+        n = std::min(total, std::max<size_t>(1, n));
+        std::mt19937_64 rng(static_cast<uint64_t>(bind.seed));
+        for (size_t k = 0; k < n; k++) {
+            size_t begin = k * total / n;
+            size_t end = (k + 1) * total / n;
+            picks.push_back(blocks[begin + rng() % (end - begin)]);
+        }
+    }
+    state->tiles_sampled = static_cast<int64_t>(picks.size());
+
+    size_t expected_pixels = picks.size() * static_cast<size_t>(meta.block_width) * meta.block_height;
+    size_t stride = std::max<size_t>(1, (expected_pixels + SAMPLE_QUANTILE_VALUES - 1) / SAMPLE_QUANTILE_VALUES);
+
+    std::vector<SampledTile> tiles(picks.size());
+    std::vector<SampledValue> values;
+    std::vector<uint8_t> scratch;
+    const std::string band_column = SampledDoubleQuote(meta.bands[bind.band_index].first);
+    for (size_t start = 0; start < picks.size(); start += SAMPLE_FETCH_BATCH) {
+        size_t end = std::min(picks.size(), start + SAMPLE_FETCH_BATCH);
+        std::string in_list;
+        for (size_t i = start; i < end; i++) {
+            if (i > start) in_list += ", ";
+            in_list += std::to_string(picks[i]);
+        }
+        auto tile_result =
+            con.Query("SELECT block, " + band_column + " FROM " + source + " WHERE block IN (" + in_list + ")");
+        if (tile_result->HasError()) {
+            throw InvalidInputException("ST_RasterStatsSampled: failed to read tiles from '%s': %s",
+                                        bind.raster_path, tile_result->GetError());
+        }
+        while (auto chunk = tile_result->Fetch()) {
+            if (chunk->size() == 0) break;
+            for (idx_t row = 0; row < chunk->size(); row++) {
+                auto block = chunk->GetValue(0, row).GetValue<uint64_t>();
+                auto pick = std::lower_bound(picks.begin() + start, picks.begin() + end, block);
+                auto tile_id = static_cast<uint32_t>(pick - picks.begin());
+                Value band = chunk->GetValue(1, row);
+                try {
+                    ProcessSampledTile(band.IsNull() ? std::string() : StringValue::Get(band), bind, tile_id,
+                                       stride, tiles[tile_id], values, scratch);
+                } catch (std::exception &e) {
+                    throw InvalidInputException("ST_RasterStatsSampled: %s", e.what());
+                }
+            }
+        }
+    }
+
+    // Estimates. Ratio estimators over tiles: mean = sum(sum_i) / sum(n_i),
+    // variance = sum(squared deviations_i) / sum(n_i), quantile CIs by
+    // Woodruff's method (interval for the CDF at the estimate, inverted).
+    double pixels = 0.0, sum = 0.0;
+    for (const auto &t : tiles) {
+        pixels += static_cast<double>(t.count);
+        sum += t.sum;
+    }
+    std::vector<std::string> stat_names = {"mean", "stddev"};
+    for (double q : bind.quantiles) {
+        stat_names.push_back(QuantileName(q));
+    }
+    if (pixels == 0.0) {
+        for (auto &name : stat_names) {
+            state->rows.push_back({name, Value(LogicalType::DOUBLE), Value(LogicalType::DOUBLE),
+                                   Value(LogicalType::DOUBLE)});
+        }
+        return std::move(state);
+    }
+
+    const double z_crit = NormalCriticalValue(bind.confidence);
+    auto interval = [&](const std::string &name, double estimate, double lower, double upper, double se) {
+        if (std::isnan(se)) {
+            state->rows.push_back({name, Value::DOUBLE(estimate), Value(LogicalType::DOUBLE),
+                                   Value(LogicalType::DOUBLE)});
+        } else {
+            state->rows.push_back({name, Value::DOUBLE(estimate), Value::DOUBLE(lower), Value::DOUBLE(upper)});
+        }
+    };
+
+    double mean = sum / pixels;
+    std::vector<double> y(tiles.size());
+    for (size_t i = 0; i < tiles.size(); i++) {
+        y[i] = tiles[i].sum;
+    }
+    double mean_se = RatioStandardError(y, tiles, mean, state->tiles_total);
+    interval("mean", mean, mean - z_crit * mean_se, mean + z_crit * mean_se, mean_se);
+
+    double deviations = 0.0;
+    for (size_t i = 0; i < tiles.size(); i++) {
+        double d = tiles[i].mean - mean;
+        y[i] = tiles[i].count > 0 ? tiles[i].m2 + tiles[i].count * d * d : 0.0;
+        deviations += y[i];
+    }
+    double variance = deviations / pixels;
+    double variance_se = RatioStandardError(y, tiles, variance, state->tiles_total);
+    double bessel = pixels > 1.0 ? pixels / (pixels - 1.0) : 1.0;
+    interval("stddev", std::sqrt(variance * bessel),
+             std::sqrt(std::max(0.0, variance - z_crit * variance_se) * bessel),
+             std::sqrt((variance + z_crit * variance_se) * bessel), variance_se);
+
+    std::sort(values.begin(), values.end(),
+              [](const SampledValue &a, const SampledValue &b) { return a.value < b.value; });
+    double total_weight = 0.0;
+    for (const auto &v : values) {
+        total_weight += v.weight;
+    }
+    for (size_t qi = 0; qi < bind.quantiles.size(); qi++) {
+        double q = bind.quantiles[qi];
+        double estimate = WeightedQuantile(values, total_weight, q);
+        std::fill(y.begin(), y.end(), 0.0);
+        for (const auto &v : values) {
+            if (v.value > estimate) break;
+            y[v.tile] += v.weight;
+        }
+        double at = 0.0;
+        for (double w : y) at += w;
+        double cdf_se = RatioStandardError(y, tiles, at / pixels, state->tiles_total);
+        interval(stat_names[2 + qi], estimate, WeightedQuantile(values, total_weight, q - z_crit * cdf_se),
+                 WeightedQuantile(values, total_weight, q + z_crit * cdf_se), cdf_se);
+    }
+    return std::move(state);
+}
+
+static void RaquetSampledStatsExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &state = data.global_state->Cast<RaquetSampledStatsGlobalState>();
+
+    idx_t row = 0;
+    while (state.next_row < state.rows.size() && row < STANDARD_VECTOR_SIZE) {
+        const auto &stat = state.rows[state.next_row];
+        output.SetValue(0, row, Value(stat.statistic));
+        output.SetValue(1, row, stat.estimate);
+        output.SetValue(2, row, stat.ci_lower);
+        output.SetValue(3, row, stat.ci_upper);
+        output.SetValue(4, row, Value::BIGINT(state.tiles_sampled));
+        output.SetValue(5, row, Value::BIGINT(state.tiles_total));
+        state.next_row++;
+        row++;
+    }
+    output.SetCardinality(row);
+}
+
+void RegisterSampledStatsFunction(ExtensionLoader &loader) {
+    TableFunction sampled_fn("ST_RasterStatsSampled",
+                             {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::DOUBLE},
+                             RaquetSampledStatsExecute, RaquetSampledStatsBind, RaquetSampledStatsInitGlobal);
+    sampled_fn.named_parameters["seed"] = LogicalType::BIGINT;
+    sampled_fn.named_parameters["quantiles"] = LogicalType::LIST(LogicalType::DOUBLE);
+    sampled_fn.named_parameters["confidence"] = LogicalType::DOUBLE;
+    sampled_fn.named_parameters["resolution"] = LogicalType::INTEGER;
+    loader.RegisterFunction(sampled_fn);
+}
+
+}  // namespace duckdb
@@ -0,0 +1,791 @@
+#include "zonal_stats.hpp"
+#include "band_decoder.hpp"
+#include "quadbin.hpp"
+#include "raquet_metadata.hpp"
+
+#include "duckdb/common/exception.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/main/connection.hpp"
+#include "duckdb/main/extension/extension_loader.hpp"
+#include "duckdb/main/query_result.hpp"
+#include "duckdb/main/materialized_query_result.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace duckdb {
+
+// SQL single-quote escape — apostrophes inside the path are doubled.
+static std::string ZonalSingleQuote(const std::string &s) {
+    std::string out = "'";
+    for (char c : s) {
+        if (c == '\'') out += "''";
+        else out += c;
+    }
+    return out + "'";
+}
+
+// SQL identifier quote — embedded double quotes are doubled.
+static std::string ZonalDoubleQuote(const std::string &s) {
+    std::string out = "\"";
+    for (char c : s) {
+        if (c == '"') out += "\"\"";
+        else out += c;
+    }
+    return out + "\"";
+}
+
+// ─────────────────────────────────────────────
+// Polygons, parsed once from WKB: parts → rings → interleaved x/y.
+// Holes are rings of their part, so an even-odd fill over a part's rings
+// matches PointInGeometry (inside the outer ring, outside every hole);
+// parts are OR-ed.
+// ─────────────────────────────────────────────
+struct ZonalPolygon {
+    std::vector<std::vector<std::vector<double>>> parts;
+    double min_lon = std::numeric_limits<double>::max();
+    double min_lat = std::numeric_limits<double>::max();
+    double max_lon = std::numeric_limits<double>::lowest();
+    double max_lat = std::numeric_limits<double>::lowest();
+};
+
+static bool ReadPolygonPart(const uint8_t *data, size_t size, size_t &offset, ZonalPolygon &poly) {
+    if (size < offset + 4) return false;
+    uint32_t num_rings;
+    memcpy(&num_rings, data + offset, 4);
+    offset += 4;
+
+    std::vector<std::vector<double>> rings;
+    for (uint32_t r = 0; r < num_rings; r++) {
+        if (size < offset + 4) return false;
+        uint32_t num_points;
+        memcpy(&num_points, data + offset, 4);
+        offset += 4;
+        if (size < offset + static_cast<size_t>(num_points) * 16) return false;
+
+        std::vector<double> xy(static_cast<size_t>(num_points) * 2);
+        memcpy(xy.data(), data + offset, static_cast<size_t>(num_points) * 16);
+        offset += static_cast<size_t>(num_points) * 16;
+        for (uint32_t p = 0; p < num_points; p++) {
+            poly.min_lon = std::min(poly.min_lon, xy[p * 2]);
+            poly.max_lon = std::max(poly.max_lon, xy[p * 2]);
+            poly.min_lat = std::min(poly.min_lat, xy[p * 2 + 1]);
+            poly.max_lat = std::max(poly.max_lat, xy[p * 2 + 1]);
+        }
+        rings.push_back(std::move(xy));
+    }
+    poly.parts.push_back(std::move(rings));
+    return true;
+}
+
+// POLYGON and MULTIPOLYGON WKB (little-endian, optional SRID); anything
+// else yields false and the row is skipped.
+static bool ParseZonalPolygon(const uint8_t *data, size_t size, ZonalPolygon &poly) {
+    if (size < 5) return false;
+    uint32_t geom_type;
+    memcpy(&geom_type, data + 1, 4);
+    uint32_t base_type = geom_type & 0xFF;
+    size_t offset = 5;
+    if (geom_type & 0x20000000) {
+        offset += 4;
+    }
+
+    if (base_type == 3) {
+        return ReadPolygonPart(data, size, offset, poly);
+    }
+    if (base_type == 6) {
+        if (size < offset + 4) return false;
+        uint32_t num_polygons;
+        memcpy(&num_polygons, data + offset, 4);
+        offset += 4;
+        for (uint32_t p = 0; p < num_polygons; p++) {
+            if (size < offset + 5) return false;
+            uint32_t poly_type;
+            memcpy(&poly_type, data + offset + 1, 4);
+            offset += 5;
+            if (poly_type & 0x20000000) {
+                offset += 4;
+            }
+            if (!ReadPolygonPart(data, size, offset, poly)) return false;
+        }
+        return true;
+    }
+    return false;
+}
+
+// Scanline-rasterize `poly` onto a width x height tile: mask[i] = 1 for
+// pixels whose centre is inside. Pixel centres follow ProcessTileForRegionStats
+// (linear in lon/lat inside the tile). Returns the number of pixels set.
+static size_t RasterizeZonalPolygon(const ZonalPolygon &poly, double tile_min_lon, double tile_max_lat,
+                                    double pixel_width, double pixel_height, int width, int height,
+                                    std::vector<uint8_t> &mask, std::vector<double> &crossings) {
+    mask.assign(static_cast<size_t>(width) * height, 0);
+    size_t set = 0;
+    for (int py = 0; py < height; py++) {
+        double lat = tile_max_lat - (py + 0.5) * pixel_height;
+        if (lat < poly.min_lat || lat > poly.max_lat) continue;
+        uint8_t *row = mask.data() + static_cast<size_t>(py) * width;
+
+        for (const auto &part : poly.parts) {
+            crossings.clear();
+            for (const auto &ring : part) {
+                size_t n = ring.size() / 2;
+                for (size_t i = 0, j = n - 1; i < n; j = i++) {
+                    double x1 = ring[i * 2], y1 = ring[i * 2 + 1];
+                    double x2 = ring[j * 2], y2 = ring[j * 2 + 1];
+                    if ((y1 > lat) != (y2 > lat)) {
+                        crossings.push_back((x2 - x1) * (lat - y1) / (y2 - y1) + x1);
+                    }
+                }
+            }
+            std::sort(crossings.begin(), crossings.end());
+
+            // Inside (odd number of crossings to the right) on [c[2k], c[2k+1])
+            for (size_t k = 0; k + 1 < crossings.size(); k += 2) {
+                double from = std::ceil((crossings[k] - tile_min_lon) / pixel_width - 0.5);
+                double to = std::ceil((crossings[k + 1] - tile_min_lon) / pixel_width - 0.5);
+                int px0 = static_cast<int>(std::max(0.0, std::min(from, static_cast<double>(width))));
+                int px1 = static_cast<int>(std::max(0.0, std::min(to, static_cast<double>(width))));
+                for (int px = px0; px < px1; px++) {
+                    set += row[px] == 0;
+                    row[px] = 1;
+                }
+            }
+        }
+    }
+    return set;
+}
+
+// ─────────────────────────────────────────────
+// Compact cover: the quadbin cells a polygon is filed under. A cell no
+// ring edge touches is either entirely inside (filed as is, at whatever
+// zoom) or entirely outside (dropped); only cells on an edge are split,
+// down to max_zoom. A max_zoom tile finds its polygons under itself and
+// its ancestors.
+// ─────────────────────────────────────────────
+struct ZonalSegment {
+    double x1, y1, x2, y2;
+};
+
+// Closed segment / rectangle intersection (Liang-Barsky clip)
+static bool ZonalSegmentTouchesRect(const ZonalSegment &seg, double min_x, double min_y, double max_x,
+                                    double max_y) {
+    double t0 = 0.0, t1 = 1.0;
+    double dx = seg.x2 - seg.x1, dy = seg.y2 - seg.y1;
+    const double p[4] = {-dx, dx, -dy, dy};
+    const double q[4] = {seg.x1 - min_x, max_x - seg.x1, seg.y1 - min_y, max_y - seg.y1};
+    for (int i = 0; i < 4; i++) {
+        if (p[i] == 0.0) {
+            if (q[i] < 0.0) return false;
+            continue;
+        }
+        double t = q[i] / p[i];
+        if (p[i] < 0.0) {
+            if (t > t1) return false;
+            t0 = std::max(t0, t);
+        } else {
+            if (t < t0) return false;
+            t1 = std::min(t1, t);
+        }
+    }
+    return true;
+}
+
+// Same even-odd rule per part as RasterizeZonalPolygon; parts are OR-ed
+static bool ZonalPointInPolygon(const ZonalPolygon &poly, double lon, double lat) {
+    for (const auto &part : poly.parts) {
+        bool inside = false;
+        for (const auto &ring : part) {
+            size_t n = ring.size() / 2;
+            for (size_t i = 0, j = n - 1; i < n; j = i++) {
+                double x1 = ring[i * 2], y1 = ring[i * 2 + 1];
+                double x2 = ring[j * 2], y2 = ring[j * 2 + 1];
+                if ((y1 > lat) != (y2 > lat) && lon < (x2 - x1) * (lat - y1) / (y2 - y1) + x1) {
+                    inside = !inside;
+                }
+            }
+        }
+        if (inside) return true;
+    }
+    return false;
+}
+
+// `segments` are the polygon edges touching the parent cell
+static void CoverZonalCell(const ZonalPolygon &poly, uint32_t index, int x, int y, int z, int max_zoom,
+                           const std::vector<ZonalSegment> &segments,
+                           std::unordered_map<uint64_t, std::vector<uint32_t>> &cover) {
+    double min_lon, min_lat, max_lon, max_lat;
+    quadbin::tile_to_bbox_wgs84(x, y, z, min_lon, min_lat, max_lon, max_lat);
+    if (poly.max_lon < min_lon || poly.min_lon > max_lon || poly.max_lat < min_lat || poly.min_lat > max_lat) {
+        return;
+    }
+    std::vector<ZonalSegment> touching;
+    for (const auto &seg : segments) {
+        if (ZonalSegmentTouchesRect(seg, min_lon, min_lat, max_lon, max_lat)) {
+            touching.push_back(seg);
+        }
+    }
+    if (touching.empty()) {
+        if (ZonalPointInPolygon(poly, (min_lon + max_lon) / 2, (min_lat + max_lat) / 2)) {
+            cover[quadbin::tile_to_cell(x, y, z)].push_back(index);
+        }
+        return;
+    }
+    if (z == max_zoom) {
+        cover[quadbin::tile_to_cell(x, y, z)].push_back(index);
+        return;
+    }
+    for (int child = 0; child < 4; child++) {
+        CoverZonalCell(poly, index, x * 2 + (child & 1), y * 2 + (child >> 1), z + 1, max_zoom, touching, cover);
+    }
+}
+
+// File `poly` under its compact cover, starting from the finest zoom at
+// which its bbox spans at most 2x2 cells
+static void CoverZonalPolygon(const ZonalPolygon &poly, uint32_t index, int max_zoom,
+                              std::unordered_map<uint64_t, std::vector<uint32_t>> &cover) {
+    std::vector<ZonalSegment> segments;
+    for (const auto &part : poly.parts) {
+        for (const auto &ring : part) {
+            size_t n = ring.size() / 2;
+            for (size_t i = 0, j = n - 1; i < n; j = i++) {
+                segments.push_back({ring[j * 2], ring[j * 2 + 1], ring[i * 2], ring[i * 2 + 1]});
+            }
+        }
+    }
+    int zoom = max_zoom;
+    int x0, y0, x1, y1;
+    while (true) {
+        quadbin::lonlat_to_tile(poly.min_lon, poly.max_lat, zoom, x0, y0);
+        quadbin::lonlat_to_tile(poly.max_lon, poly.min_lat, zoom, x1, y1);
+        if (zoom == 0 || (x1 - x0 < 2 && y1 - y0 < 2)) break;
+        zoom--;
+    }
+    for (int y = y0; y <= y1; y++) {
+        for (int x = x0; x <= x1; x++) {
+            CoverZonalCell(poly, index, x, y, zoom, max_zoom, segments, cover);
+        }
+    }
+}
+
+// Welford accumulator for one (polygon, band)
+struct ZonalAccumulator {
+    int64_t count = 0;
+    double sum = 0.0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    double min_val = std::numeric_limits<double>::max();
+    double max_val = std::numeric_limits<double>::lowest();
+
+    void Add(double value) {
+        count++;
+        sum += value;
+        double delta = value - mean;
+        mean += delta / count;
+        m2 += delta * (value - mean);
+        if (value < min_val) min_val = value;
+        if (value > max_val) max_val = value;
+    }
+
+    // n copies of value (constant tiles): one merge, no pixel loop
+    void AddRepeated(double value, int64_t n) {
+        ZonalAccumulator run;
+        run.count = n;
+        run.sum = value * n;
+        run.mean = value;
+        run.min_val = value;
+        run.max_val = value;
+        Merge(run);
+    }
+
+    void Merge(const ZonalAccumulator &other) {
+        if (other.count == 0) return;
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+        int64_t combined = count + other.count;
+        double delta = other.mean - mean;
+        m2 += other.m2 + delta * delta * static_cast<double>(count) * other.count / combined;
+        mean += delta * other.count / combined;
+        count = combined;
+        sum += other.sum;
+        if (other.min_val < min_val) min_val = other.min_val;
+        if (other.max_val > max_val) max_val = other.max_val;
+    }
+};
+
+enum class ZonalStat { COUNT, SUM, MEAN, MIN, MAX, STDDEV };
+
+static bool ParseZonalStat(const std::string &name, ZonalStat &stat) {
+    if (name == "count") stat = ZonalStat::COUNT;
+    else if (name == "sum") stat = ZonalStat::SUM;
+    else if (name == "mean") stat = ZonalStat::MEAN;
+    else if (name == "min") stat = ZonalStat::MIN;
+    else if (name == "max") stat = ZonalStat::MAX;
+    else if (name == "stddev") stat = ZonalStat::STDDEV;
+    else return false;
+    return true;
+}
+
+// ─────────────────────────────────────────────
+// Bind / global state
+// ─────────────────────────────────────────────
+struct RaquetZonalStatsBindData : public TableFunctionData {
+    std::string raster_path;
+    std::string polygons_sql;
+    raquet::RaquetMetadata meta;
+    std::vector<int> band_indices;
+    std::vector<ZonalStat> stats;
+};
+
+// Polygons and the tile scan are shared; every thread pulls chunks of
+// tiles from `tiles` and folds them into its own accumulators, then merges
+// them into `results`. Once no thread is folding any more the results are
+// complete and the threads drain them as output rows.
+struct RaquetZonalStatsGlobalState : public GlobalTableFunctionState {
+    std::vector<Value> ids;
+    std::vector<ZonalPolygon> polygons;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> tile_polygons;  // compact cover cell -> polygons
+
+    // Connection must outlive `tiles`, which streams from it; `tiles` is
+    // null when no polygon reaches a tile.
+    std::unique_ptr<Connection> connection;
+    duckdb::unique_ptr<QueryResult> tiles;
+
+    std::mutex lock;  // guards everything below and fetches from `tiles`
+    std::condition_variable folded;  // signalled when `active` drops to 0
+    bool tiles_done = false;
+    idx_t active = 0;  // threads that took a chunk and have not merged yet
+    std::vector<ZonalAccumulator> results;  // ids.size() x band_indices.size()
+    idx_t next_row = 0;
+
+    idx_t MaxThreads() const override { return GlobalTableFunctionState::MAX_THREADS; }
+};
+
+struct RaquetZonalStatsLocalState : public LocalTableFunctionState {
+    std::unordered_map<uint32_t, std::vector<ZonalAccumulator>> acc;  // polygon -> band accumulators
+    std::vector<uint8_t> mask;
+    std::vector<double> crossings;
+    std::vector<std::vector<uint8_t>> scratch;
+    bool folding = false;  // counted in `active`
+    bool merged = false;
+};
+
+static unique_ptr<FunctionData> RaquetZonalStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                     vector<LogicalType> &return_types, vector<string> &names) {
+    for (idx_t i = 0; i < 4; i++) {
+        if (input.inputs[i].IsNull()) {
+            throw InvalidInputException("raquet_zonal_stats: arguments cannot be NULL");
+        }
+    }
+    auto bind_data = make_uniq<RaquetZonalStatsBindData>();
+    bind_data->raster_path = input.inputs[0].GetValue<std::string>();
+    auto table = input.inputs[1].GetValue<std::string>();
+    auto id_col = input.inputs[2].GetValue<std::string>();
+    auto geom_col = input.inputs[3].GetValue<std::string>();
+    bind_data->polygons_sql = "SELECT " + ZonalDoubleQuote(id_col) + ", " + ZonalDoubleQuote(geom_col) +
+                              "::GEOMETRY FROM " + table;
+
+    Connection con(*context.db);
+    auto meta_result = con.Query("SELECT metadata FROM read_parquet(" + ZonalSingleQuote(bind_data->raster_path) +
+                                 ") WHERE block = 0 LIMIT 1");
+    if (meta_result->HasError()) {
+        throw InvalidInputException("raquet_zonal_stats: failed to read metadata from '%s': %s",
+                                    bind_data->raster_path, meta_result->GetError());
+    }
+    auto meta_chunk = meta_result->Fetch();
+    if (!meta_chunk || meta_chunk->size() == 0 || meta_chunk->GetValue(0, 0).IsNull()) {
+        throw InvalidInputException("raquet_zonal_stats: '%s' has no metadata row (block=0)",
+                                    bind_data->raster_path);
+    }
+    bind_data->meta = raquet::parse_metadata(meta_chunk->GetValue(0, 0).GetValue<std::string>());
+    auto &meta = bind_data->meta;
+    if (meta.is_interleaved()) {
+        throw InvalidInputException("raquet_zonal_stats: interleaved band_layout is not supported");
+    }
+    if (meta.is_lossy_compression()) {
+        throw InvalidInputException("raquet_zonal_stats: '%s' compression is not supported", meta.compression);
+    }
+
+    for (auto &kv : input.named_parameters) {
+        if (kv.second.IsNull()) continue;
+        if (kv.first == "bands") {
+            for (auto &v : ListValue::GetChildren(kv.second)) {
+                auto name = v.GetValue<std::string>();
+                int idx = meta.get_band_index(name);
+                if (idx < 0) {
+                    throw InvalidInputException("raquet_zonal_stats: unknown band '%s'", name);
+                }
+                bind_data->band_indices.push_back(idx);
+            }
+        } else if (kv.first == "stats") {
+            for (auto &v : ListValue::GetChildren(kv.second)) {
+                auto name = v.GetValue<std::string>();
+                ZonalStat stat;
+                if (!ParseZonalStat(name, stat)) {
+                    throw InvalidInputException(
+                        "raquet_zonal_stats: unknown stat '%s' (use count, sum, mean, min, max, stddev)", name);
+                }
+                bind_data->stats.push_back(stat);
+            }
+        }
+    }
+    if (bind_data->band_indices.empty()) {
+        for (size_t b = 0; b < meta.bands.size(); b++) {
+            bind_data->band_indices.push_back(static_cast<int>(b));
+        }
+    }
+    if (bind_data->stats.empty()) {
+        bind_data->stats = {ZonalStat::COUNT, ZonalStat::SUM, ZonalStat::MEAN,
+                            ZonalStat::MIN, ZonalStat::MAX, ZonalStat::STDDEV};
+    }
+
+    auto probe = con.Query(bind_data->polygons_sql + " LIMIT 0");
+    if (probe->HasError()) {
+        throw InvalidInputException("raquet_zonal_stats: failed to read polygons: %s", probe->GetError());
+    }
+
+    names.push_back(id_col);   return_types.push_back(probe->types[0]);
+    names.push_back("band");   return_types.push_back(LogicalType::VARCHAR);
+    static const char *stat_names[] = {"count", "sum", "mean", "min", "max", "stddev"};
+    for (auto stat : bind_data->stats) {
+        names.push_back(stat_names[static_cast<int>(stat)]);
+        return_types.push_back(stat == ZonalStat::COUNT ? LogicalType::BIGINT : LogicalType::DOUBLE);
+    }
+    return std::move(bind_data);
+}
+
+// A decoded max_zoom tile and the polygons whose bbox reaches it
+struct ZonalTile {
+    uint64_t block;
+    std::vector<std::string> bands;  // one blob per selected band, empty if NULL
+    std::vector<uint32_t> polygons;
+};
+
+// Fold one tile into `acc` (polygon-indexed, band_count accumulators each):
+// decode every band once, then rasterize and accumulate each polygon.
+static void ProcessZonalTile(const ZonalTile &tile, const RaquetZonalStatsBindData &bind,
+                             const std::vector<ZonalPolygon> &polygons,
+                             std::unordered_map<uint32_t, std::vector<ZonalAccumulator>> &acc,
+                             std::vector<uint8_t> &mask, std::vector<double> &crossings,
+                             std::vector<std::vector<uint8_t>> &scratch) {
+    const auto &meta = bind.meta;
+    const size_t band_count = bind.band_indices.size();
+    int width = meta.block_width;
+    int height = meta.block_height;
+
+    int tile_x, tile_y, tile_z;
+    quadbin::cell_to_tile(tile.block, tile_x, tile_y, tile_z);
+    double tile_min_lon, tile_min_lat, tile_max_lon, tile_max_lat;
+    quadbin::tile_to_bbox_wgs84(tile_x, tile_y, tile_z, tile_min_lon, tile_min_lat, tile_max_lon, tile_max_lat);
+    double pixel_width = (tile_max_lon - tile_min_lon) / width;
+    double pixel_height = (tile_max_lat - tile_min_lat) / height;
+
+    // Per band: raw pixels, or a constant value, or nothing to read
+    struct DecodedBand {
+        const uint8_t *data = nullptr;
+        size_t size = 0;
+        bool constant = false;
+        double value = 0.0;
+    };
+    std::vector<DecodedBand> decoded(band_count);
+    std::vector<raquet::BandDataType> dtypes(band_count);
+    std::vector<bool> has_nodata(band_count);
+    std::vector<double> nodata(band_count);
+    bool decoded_ready = false;
+
+    auto decode_all = [&]() {
+        scratch.resize(band_count);
+        for (size_t b = 0; b < band_count; b++) {
+            int band_index = bind.band_indices[b];
+            dtypes[b] = raquet::parse_dtype(meta.bands[band_index].second);
+            if (band_index < static_cast<int>(meta.band_info.size()) && meta.band_info[band_index].has_nodata) {
+                has_nodata[b] = true;
+                nodata[b] = meta.band_info[band_index].nodata;
+            }
+
+            const auto &blob = tile.bands[b];
+            if (blob.empty()) continue;
+            auto codec = meta.band_codec(band_index);
+            auto ptr = reinterpret_cast<const uint8_t *>(blob.data());
+            size_t size = blob.size();
+            raquet::resolve_tile_ref(ptr, size, codec);
+            if (raquet::tile_all_nodata(ptr, size, codec, width, height, has_nodata[b], nodata[b])) {
+                continue;
+            }
+            size_t elem = raquet::dtype_size(dtypes[b]);
+            if (raquet::is_constant_tile(ptr, size, elem, codec)) {
+                decoded[b].constant = true;
+                decoded[b].value = raquet::get_pixel_value(raquet::constant_tile_value(ptr), elem, 0, dtypes[b]);
+                continue;
+            }
+            decoded[b].data = raquet::decode_band_bytes(ptr, size, codec, elem, width, height, 1,
+                                                        scratch[b], decoded[b].size);
+        }
+        decoded_ready = true;
+    };
+
+    for (uint32_t p : tile.polygons) {
+        const auto &poly = polygons[p];
+        if (poly.max_lon < tile_min_lon || poly.min_lon > tile_max_lon ||
+            poly.max_lat < tile_min_lat || poly.min_lat > tile_max_lat) {
+            continue;
+        }
+        size_t inside = RasterizeZonalPolygon(poly, tile_min_lon, tile_max_lat, pixel_width, pixel_height,
+                                              width, height, mask, crossings);
+        if (inside == 0) continue;
+        if (!decoded_ready) decode_all();
+
+        auto &slots = acc[p];
+        if (slots.empty()) slots.resize(band_count);
+        for (size_t b = 0; b < band_count; b++) {
+            const auto &band = decoded[b];
+            bool nd = has_nodata[b];
+            double ndv = nodata[b];
+            auto is_nodata = [nd, ndv](double v) {
+                return nd && (v == ndv || (std::isnan(v) && std::isnan(ndv)));
+            };
+            if (band.constant) {
+                if (!is_nodata(band.value)) {
+                    slots[b].AddRepeated(band.value, static_cast<int64_t>(inside));
+                }
+                continue;
+            }
+            if (!band.data) continue;
+            for (size_t i = 0; i < mask.size(); i++) {
+                if (!mask[i]) continue;
+                double v = raquet::get_pixel_value(band.data, band.size, i, dtypes[b]);
+                if (!is_nodata(v)) {
+                    slots[b].Add(v);
+                }
+            }
+        }
+    }
+}
+
+// ─────────────────────────────────────────────
+// InitGlobal: load and parse the polygons, file them under their compact
+// covers, and open a streaming scan of the tiles (the covers' block range
+// pushed into the parquet scan). The threads fold the tiles in Execute.
+// ─────────────────────────────────────────────
+static unique_ptr<GlobalTableFunctionState> RaquetZonalStatsInitGlobal(ClientContext &context,
+                                                                       TableFunctionInitInput &input) {
+    auto &bind = input.bind_data->Cast<RaquetZonalStatsBindData>();
+    auto state = make_uniq<RaquetZonalStatsGlobalState>();
+    const auto &meta = bind.meta;
+    const size_t band_count = bind.band_indices.size();
+    const int zoom = meta.max_zoom;
+
+    state->connection = std::unique_ptr<Connection>(new Connection(*context.db));
+    auto poly_result = state->connection->Query(bind.polygons_sql);
+    if (poly_result->HasError()) {
+        throw InvalidInputException("raquet_zonal_stats: failed to read polygons: %s", poly_result->GetError());
+    }
+
+    auto &polygons = state->polygons;
+    auto &tile_polygons = state->tile_polygons;
+    uint64_t lo_block = std::numeric_limits<uint64_t>::max();
+    uint64_t hi_block = 0;
+    while (auto chunk = poly_result->Fetch()) {
+        if (chunk->size() == 0) break;
+        chunk->data[1].Flatten(chunk->size());
+        auto geoms = FlatVector::GetData<string_t>(chunk->data[1]);
+        auto &geom_validity = FlatVector::Validity(chunk->data[1]);
+        for (idx_t row = 0; row < chunk->size(); row++) {
+            ZonalPolygon poly;
+            if (!geom_validity.RowIsValid(row) ||
+                !ParseZonalPolygon(reinterpret_cast<const uint8_t *>(geoms[row].GetData()), geoms[row].GetSize(),
+                                   poly) ||
+                poly.parts.empty()) {
+                continue;
+            }
+            CoverZonalPolygon(poly, static_cast<uint32_t>(polygons.size()), zoom, tile_polygons);
+            state->ids.push_back(chunk->GetValue(0, row));
+            polygons.push_back(std::move(poly));
+        }
+    }
+    state->results.resize(polygons.size() * band_count);
+    // A cell's max_zoom descendants are one contiguous (Morton) block range
+    for (const auto &entry : tile_polygons) {
+        int x, y, z;
+        quadbin::cell_to_tile(entry.first, x, y, z);
+        int d = zoom - z;
+        lo_block = std::min(lo_block, quadbin::tile_to_cell(x << d, y << d, zoom));
+        hi_block = std::max(hi_block, quadbin::tile_to_cell(((x + 1) << d) - 1, ((y + 1) << d) - 1, zoom));
+    }
+    if (tile_polygons.empty()) {
+        state->tiles_done = true;
+        return std::move(state);
+    }
+
+    std::string tile_sql = "SELECT block";
+    for (int b : bind.band_indices) {
+        tile_sql += ", " + ZonalDoubleQuote(meta.bands[b].first);
+    }
+    tile_sql += " FROM read_parquet(" + ZonalSingleQuote(bind.raster_path) + ") WHERE block BETWEEN " +
+                std::to_string(lo_block) + " AND " + std::to_string(hi_block);
+    state->tiles = state->connection->SendQuery(tile_sql);
+    if (state->tiles->HasError()) {
+        throw InvalidInputException("raquet_zonal_stats: failed to read tiles from '%s': %s",
+                                    bind.raster_path, state->tiles->GetError());
+    }
+    return std::move(state);
+}
+
+static unique_ptr<LocalTableFunctionState> RaquetZonalStatsInitLocal(ExecutionContext &context,
+                                                                     TableFunctionInitInput &input,
+                                                                     GlobalTableFunctionState *global_state) {
+    return make_uniq<RaquetZonalStatsLocalState>();
+}
+
+// Fold chunks of tiles into the thread's accumulators until the scan is
+// exhausted, merge them into the shared results and wait for the threads
+// still folding. A thread registers as active with its first chunk, and
+// none can after the scan is exhausted, so `active == 0` means done.
+static void FoldZonalTiles(const RaquetZonalStatsBindData &bind, RaquetZonalStatsGlobalState &state,
+                           RaquetZonalStatsLocalState &local) {
+    const size_t band_count = bind.band_indices.size();
+    std::vector<ZonalTile> tiles;
+    try {
+        while (true) {
+            unique_ptr<DataChunk> chunk;
+            {
+                std::lock_guard<std::mutex> guard(state.lock);
+                if (!state.tiles_done) {
+                    chunk = state.tiles->Fetch();
+                    if (!chunk || chunk->size() == 0) {
+                        state.tiles_done = true;
+                        chunk.reset();
+                    } else if (!local.folding) {
+                        local.folding = true;
+                        state.active++;
+                    }
+                }
+            }
+            if (!chunk) break;
+
+            tiles.clear();
+            for (idx_t row = 0; row < chunk->size(); row++) {
+                Value block_value = chunk->GetValue(0, row);
+                if (block_value.IsNull()) continue;
+                auto block = block_value.GetValue<uint64_t>();
+                if (quadbin::cell_to_resolution(block) != bind.meta.max_zoom) continue;
+
+                ZonalTile tile;
+                tile.block = block;
+                for (int z = bind.meta.max_zoom; z >= 0; z--) {
+                    auto it = state.tile_polygons.find(quadbin::cell_to_parent(block, z));
+                    if (it != state.tile_polygons.end()) {
+                        tile.polygons.insert(tile.polygons.end(), it->second.begin(), it->second.end());
+                    }
+                }
+                if (tile.polygons.empty()) continue;
+                for (size_t b = 0; b < band_count; b++) {
+                    Value v = chunk->GetValue(1 + b, row);
+                    tile.bands.push_back(v.IsNull() ? std::string() : StringValue::Get(v));
+                }
+                tiles.push_back(std::move(tile));
+            }
+            for (auto &tile : tiles) {
+                ProcessZonalTile(tile, bind, state.polygons, local.acc, local.mask, local.crossings, local.scratch);
+            }
+        }
+    } catch (std::exception &e) {
+        // Stop the scan and release the threads waiting on this one
+        std::lock_guard<std::mutex> guard(state.lock);
+        state.tiles_done = true;
+        if (local.folding && --state.active == 0) {
+            state.folded.notify_all();
+        }
+        local.folding = false;
+        local.merged = true;
+        throw InvalidInputException("raquet_zonal_stats: %s", e.what());
+    }
+
+    std::unique_lock<std::mutex> guard(state.lock);
+    for (auto &entry : local.acc) {
+        for (size_t b = 0; b < band_count; b++) {
+            state.results[entry.first * band_count + b].Merge(entry.second[b]);
+        }
+    }
+    local.acc.clear();
+    local.merged = true;
+    if (local.folding && --state.active == 0) {
+        state.folded.notify_all();
+    }
+    state.folded.wait(guard, [&] { return state.active == 0; });
+}
+
+// ─────────────────────────────────────────────
+// Execute: fold tiles (every thread), then one row per (polygon, band);
+// stats are NULL (count 0) for polygons without a valid pixel. The rows
+// are shared out between the threads.
+// ─────────────────────────────────────────────
+static void RaquetZonalStatsExecute(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+    auto &bind = data.bind_data->Cast<RaquetZonalStatsBindData>();
+    auto &state = data.global_state->Cast<RaquetZonalStatsGlobalState>();
+    auto &local = data.local_state->Cast<RaquetZonalStatsLocalState>();
+    const size_t band_count = bind.band_indices.size();
+
+    if (!local.merged) {
+        FoldZonalTiles(bind, state, local);
+    }
+    std::lock_guard<std::mutex> guard(state.lock);
+    idx_t row = 0;
+    while (state.next_row < state.results.size() && row < STANDARD_VECTOR_SIZE) {
+        size_t polygon = state.next_row / band_count;
+        size_t b = state.next_row % band_count;
+        const auto &acc = state.results[state.next_row];
+
+        output.SetValue(0, row, state.ids[polygon]);
+        output.SetValue(1, row, Value(bind.meta.bands[bind.band_indices[b]].first));
+        for (size_t s = 0; s < bind.stats.size(); s++) {
+            Value v;
+            switch (bind.stats[s]) {
+                case ZonalStat::COUNT:
+                    v = Value::BIGINT(acc.count);
+                    break;
+                case ZonalStat::SUM:
+                    if (acc.count > 0) v = Value::DOUBLE(acc.sum);
+                    break;
+                case ZonalStat::MEAN:
+                    if (acc.count > 0) v = Value::DOUBLE(acc.sum / acc.count);
+                    break;
+                case ZonalStat::MIN:
+                    if (acc.count > 0) v = Value::DOUBLE(acc.min_val);
+                    break;
+                case ZonalStat::MAX:
+                    if (acc.count > 0) v = Value::DOUBLE(acc.max_val);
+                    break;
+                case ZonalStat::STDDEV:
+                    if (acc.count > 0) v = Value::DOUBLE(acc.count > 1 ? std::sqrt(acc.m2 / (acc.count - 1)) : 0.0);
+                    break;
+            }
+            output.SetValue(2 + s, row, v);
+        }
+        state.next_row++;
+        row++;
+    }
+    output.SetCardinality(row);
+}
+
+void RegisterZonalStatsFunction(ExtensionLoader &loader) {
+    TableFunction zonal_fn("raquet_zonal_stats",
+                           {LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR, LogicalType::VARCHAR},
+                           RaquetZonalStatsExecute, RaquetZonalStatsBind, RaquetZonalStatsInitGlobal,
+                           RaquetZonalStatsInitLocal);
+    zonal_fn.named_parameters["bands"] = LogicalType::LIST(LogicalType::VARCHAR);
+    zonal_fn.named_parameters["stats"] = LogicalType::LIST(LogicalType::VARCHAR);
+    loader.RegisterFunction(zonal_fn);
+}
+
+}  // namespace duckdb